@@ -0,0 +1,91 @@
+#ifndef GATEWAY_H__
+#define GATEWAY_H__
+
+/* MODBUS gateway, split into a bus side and a console side so that tools on the console never stall the RS485 bus, and a slow console never
+	stalls polling.
+	The bus side, gatewayBusService(), owns the bus through modbus.cpp. It polls each slave in the roster in turn for a block of holding
+	registers and keeps the last good image of them in a cache. Requests queued by the console side are sent between polls and their responses
+	are queued back. A slave that does not respond is backed off, see poll_backoff.h, so that an absent slave does not cost a response timeout
+	on every poll period.
+	The console side reads the cache, queues requests & reads responses, it never touches the bus.
+	On the ESP32 the two sides run in tasks on different cores. They share only the cache & two single producer/single consumer queues, which
+	use no locks. Each cache entry has a sequence count that is odd while the bus side is writing it, so the console side retries a read that
+	overlapped a write. On the host both sides are just called in turn. */
+
+#include <Arduino.h>
+#include "project_config.h"		// cppcheck-suppress [missingInclude]
+
+#ifndef CFG_GATEWAY_SLAVE_COUNT_MAX
+#define CFG_GATEWAY_SLAVE_COUNT_MAX 8
+#endif
+#ifndef CFG_GATEWAY_CACHE_REGS_MAX
+#define CFG_GATEWAY_CACHE_REGS_MAX 16		// Max registers polled from each slave.
+#endif
+#ifndef CFG_GATEWAY_QUEUE_SIZE
+#define CFG_GATEWAY_QUEUE_SIZE 8			// Must be a power of 2 and no more than 128.
+#endif
+#ifndef CFG_GATEWAY_POLL_PERIOD_MS
+#define CFG_GATEWAY_POLL_PERIOD_MS 100		// Each slave is polled at most this often.
+#endif
+#ifndef CFG_GATEWAY_RESPONSE_TIMEOUT_MS
+#define CFG_GATEWAY_RESPONSE_TIMEOUT_MS 50
+#endif
+#ifndef CFG_GATEWAY_BACKOFF_THRESHOLD
+#define CFG_GATEWAY_BACKOFF_THRESHOLD 2		// A slave that misses more than this many polls in a row is backed off.
+#endif
+#ifndef CFG_GATEWAY_BACKOFF_MAX
+#define CFG_GATEWAY_BACKOFF_MAX 5			// A backed off slave is polled at least every 2^this poll periods.
+#endif
+
+// Largest request or response that can pass through the request & response queues, excluding the CRC. Also the MODBUS driver RX buffer size.
+enum { GATEWAY_FRAME_SIZE_MAX = 64 };
+
+// A slave to poll.
+typedef struct {
+	uint8_t id;						// MODBUS slave ID.
+	uint16_t address;				// First holding register.
+	uint8_t count;					// Number of registers, at most CFG_GATEWAY_CACHE_REGS_MAX.
+} GatewaySlaveDef;
+
+// Status of a cache entry.
+enum {
+	GATEWAY_STATUS_UNKNOWN,			// Not polled yet.
+	GATEWAY_STATUS_OK,				// Last poll was good.
+	GATEWAY_STATUS_NO_RESPONSE,		// Last poll timed out, the registers are from the last good poll.
+	GATEWAY_STATUS_BAD_RESPONSE,	// Last poll got an exception or a response of the wrong size.
+};
+
+// Copy of a cache entry.
+typedef struct {
+	uint32_t timestamp_ms;			// millis() of last good poll.
+	uint16_t polls;					// Count of polls & failed polls, wrap around.
+	uint16_t errors;
+	uint8_t status;
+	uint8_t count;					// Number of registers.
+	uint16_t regs[CFG_GATEWAY_CACHE_REGS_MAX];
+} GatewayCacheImage;
+
+// A request or response without the CRC. A response of zero length means that the slave did not respond.
+typedef struct {
+	uint8_t len;
+	uint8_t frame[GATEWAY_FRAME_SIZE_MAX];
+} GatewayFrame;
+
+// Bus side. The roster is copied, the stream is the RS485 UART, which must be set up for half duplex so that write() then flush() sends a frame.
+void gatewayInit(Stream& bus, uint32_t baud, const GatewaySlaveDef* roster, uint8_t count);
+void gatewayBusService();
+
+// Console side.
+uint8_t gatewaySlaveCount();
+const GatewaySlaveDef* gatewaySlaveDef(uint8_t idx);
+
+// Copy the cache entry for slave idx, returns false if idx is out of range.
+bool gatewayCacheRead(uint8_t idx, GatewayCacheImage* img);
+
+// Queue a request to be sent, returns false if the queue is full or it is too long.
+bool gatewayRequest(const uint8_t* frame, uint8_t len);
+
+// Read the next response to a request, returns false if none.
+bool gatewayResponse(GatewayFrame* resp);
+
+#endif // GATEWAY_H__
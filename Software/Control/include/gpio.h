@@ -0,0 +1,28 @@
+#ifndef GPIO_H__
+#define GPIO_H__
+
+// Pin Assignments for ESP32 DevKit, project: Control. Written by hand as gpio_mk.py only knows AVR ports.
+enum {
+    // Serial
+    GPIO_PIN_RX0 = 3,                              // Onboard USB serial port
+    GPIO_PIN_TX0 = 1,                              // Onboard USB serial port
+
+    // Misc
+    GPIO_PIN_LED = 2,                              // Onboard LED
+
+    // Bus
+    GPIO_PIN_RS485_RXD = 16,                       // RS485 RX
+    GPIO_PIN_RS485_TXD = 17,                       // RS485 TX
+    GPIO_PIN_RS485_TX_EN = 4,                      // Enable RS485 xmitter, driven by the UART as RTS in RS485 half duplex mode.
+
+    // Debug
+    GPIO_PIN_SP4 = 5,                              // Spare, MODBUS service timing.
+};
+
+#define GPIO_SERIAL_CONSOLE Serial // Serial port for console.
+#define GPIO_SERIAL_RS485 Serial2 // Serial port for RS485.
+
+static inline void gpioSp4SetModeOutput() { pinMode(GPIO_PIN_SP4, OUTPUT); }
+static inline void gpioSp4Write(bool b) { digitalWrite(GPIO_PIN_SP4, b); }
+
+#endif   // GPIO_H__
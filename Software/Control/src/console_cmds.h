@@ -0,0 +1,46 @@
+#ifndef CONSOLE_CMDS_H__
+#define CONSOLE_CMDS_H__
+
+// This file is autogenerated from `console_cmds.src'. Do not edit, your changes will be lost!
+
+
+// Info
+static void console_cmd_0() {		// ?VER
+	print_banner();
+}
+
+// Gateway
+static void console_cmd_1() {		// ?GW
+	fori (gatewaySlaveCount()) print_cache(i);
+}
+static void console_cmd_2() {		// ?C
+	print_cache((uint8_t)consoleStackPop());
+}
+static void console_cmd_3() {		// STREAM
+	f_stream_period_ms = (uint16_t)consoleStackPop();
+}
+
+// MODBUS
+static void console_cmd_4() {		// READ
+	send_request(MODBUS_FC_READ_HOLDING_REGISTERS);
+}
+static void console_cmd_5() {		// WRITE
+	send_request(MODBUS_FC_WRITE_SINGLE_REGISTER);
+}
+
+static const uint8_t CONSOLE_CMDS_DISP[3] PROGMEM = {
+	2, 0, 1
+};
+static const console_cmd_def_t CONSOLE_CMDS_DEFS[6] PROGMEM = {
+	{ 0x6899, console_cmd_2 },                    // ?C
+	{ 0xd8b7, console_cmd_4 },                    // READ
+	{ 0xd859, console_cmd_3 },                    // STREAM
+	{ 0xa8f8, console_cmd_5 },                    // WRITE
+	{ 0xc33b, console_cmd_0 },                    // ?VER
+	{ 0x7c6a, console_cmd_1 },                    // ?GW
+};
+static bool console_cmds_user(char* cmd) {
+	return consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, 3, CONSOLE_CMDS_DEFS, 6);
+}
+
+#endif   // CONSOLE_CMDS_H__
@@ -0,0 +1,237 @@
+#include <Arduino.h>
+
+#include "project_config.h"
+#include "utils.h"
+#include "modbus.h"
+#include "poll_backoff.h"
+#include "gateway.h"
+
+/* Single producer/single consumer queue with no locks, the producer only writes the tail & the consumer only writes the head. A put stores
+	the item then releases the tail, a get acquires the tail before reading the item, so the consumer on another core never sees a stale item.
+	This is DECLARE_QUEUE_TYPE() in utils.h with the ordering made explicit, which the AVR does not need. */
+#define DECLARE_SPSC_QUEUE_TYPE(name_, type_, size_)																		\
+typedef struct {																										\
+	type_ fifo[size_];																									\
+	uint8_t head, tail;																									\
+} Queue##name_;																											\
+static inline uint8_t queue##name_##Mask() { return (size_) - (uint8_t)1U; }											\
+static inline void queue##name_##Init(Queue##name_* q) { q->head = q->tail = 0U; }										\
+static inline bool queue##name_##Put(Queue##name_* q, const type_* el) {												\
+	const uint8_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);													\
+	if ((uint8_t)(tail - __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) >= (uint8_t)(size_)) return false;				\
+	q->fifo[tail & queue##name_##Mask()] = *el;																			\
+	__atomic_store_n(&q->tail, (uint8_t)(tail + 1U), __ATOMIC_RELEASE);													\
+	return true;																										\
+}																														\
+static inline bool queue##name_##Get(Queue##name_* q, type_* el) {														\
+	const uint8_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);													\
+	if (head == __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE)) return false;												\
+	*el = q->fifo[head & queue##name_##Mask()];																			\
+	__atomic_store_n(&q->head, (uint8_t)(head + 1U), __ATOMIC_RELEASE);													\
+	return true;																										\
+}
+
+DECLARE_SPSC_QUEUE_TYPE(GatewayRequest, GatewayFrame, CFG_GATEWAY_QUEUE_SIZE)
+DECLARE_SPSC_QUEUE_TYPE(GatewayResponse, GatewayFrame, CFG_GATEWAY_QUEUE_SIZE)
+
+// Cache entry, the sequence count is odd while the bus side is writing.
+typedef struct {
+	uint32_t seq;
+	GatewayCacheImage img;
+} CacheEntry;
+
+// What the bus side is waiting for.
+enum {
+	PENDING_NONE,
+	PENDING_POLL,					// Poll of slave poll_idx.
+	PENDING_REQUEST,				// Request from the console side.
+};
+
+static struct {
+	Stream* bus;
+	GatewaySlaveDef roster[CFG_GATEWAY_SLAVE_COUNT_MAX];
+	uint8_t count;
+	CacheEntry cache[CFG_GATEWAY_SLAVE_COUNT_MAX];
+	uint32_t poll_ms[CFG_GATEWAY_SLAVE_COUNT_MAX];		// millis() at start of last poll, or of last poll period skipped when backed off.
+	poll_backoff_t backoff[CFG_GATEWAY_SLAVE_COUNT_MAX];
+	QueueGatewayRequest req_q;
+	QueueGatewayResponse resp_q;
+	uint8_t pending;
+	uint8_t poll_idx;				// Slave being polled, or last polled.
+	uint32_t sent_ms;				// millis() when request sent.
+} f_gateway;
+
+// Cache writes are only done by the bus side.
+static CacheEntry* cache_write_begin(uint8_t idx) {
+	CacheEntry* c = &f_gateway.cache[idx];
+	__atomic_store_n(&c->seq, c->seq + 1U, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return c;
+}
+static void cache_write_end(CacheEntry* c) {
+	__atomic_store_n(&c->seq, c->seq + 1U, __ATOMIC_RELEASE);
+}
+static void cache_set_status(uint8_t idx, uint8_t status) {
+	CacheEntry* c = cache_write_begin(idx);
+	c->img.status = status;
+	c->img.polls += 1;
+	if (GATEWAY_STATUS_OK != status)
+		c->img.errors += 1;
+	cache_write_end(c);
+}
+
+// REQ: [ID FC=3 addr:16 count:16] RESP: [ID FC=3 byte-count value-0:16, ...]
+static void handle_poll_response(const BufferDynamic& f_response) {
+	const uint8_t idx = f_gateway.poll_idx;
+	const uint8_t count = f_gateway.roster[idx].count;
+	(void)pollBackoffResponse(&f_gateway.backoff[idx], CFG_GATEWAY_BACKOFF_THRESHOLD);		// Any response shows that the slave is there.
+	if ((MODBUS_FC_READ_HOLDING_REGISTERS != f_response[MODBUS_FRAME_IDX_FUNCTION]) ||
+	  (f_response[MODBUS_FRAME_IDX_DATA] != 2U * count) || (f_response.len() != 2U * count + 5U)) {
+		cache_set_status(idx, GATEWAY_STATUS_BAD_RESPONSE);
+		return;
+	}
+	CacheEntry* c = cache_write_begin(idx);
+	fori (count)
+		c->img.regs[i] = f_response.getU16_be((uint8_t)(MODBUS_FRAME_IDX_DATA + 1U + 2U * i));
+	c->img.timestamp_ms = millis();
+	c->img.status = GATEWAY_STATUS_OK;
+	c->img.polls += 1;
+	cache_write_end(c);
+}
+
+static void modbus_cb(uint8_t evt) {
+	if ((MODBUS_CB_EVT_M_RESP_RX != evt) || (PENDING_NONE == f_gateway.pending))
+		return;
+	const BufferDynamic& f_response = modbusRxFrame();
+	if (f_response[MODBUS_FRAME_IDX_SLAVE_ID] != modbusTxFrame()[MODBUS_FRAME_IDX_SLAVE_ID])		// Not for us, keep waiting.
+		return;
+
+	if (PENDING_POLL == f_gateway.pending)
+		handle_poll_response(f_response);
+	else {
+		GatewayFrame resp;
+		resp.len = (uint8_t)(f_response.len() - 2U);		// Less CRC.
+		memcpy(resp.frame, (const uint8_t*)f_response, resp.len);
+		(void)queueGatewayResponsePut(&f_gateway.resp_q, &resp);	// Dropped if the console side is not reading responses.
+	}
+	f_gateway.pending = PENDING_NONE;
+}
+
+static void pending_timeout() {
+	if (PENDING_POLL == f_gateway.pending)
+		cache_set_status(f_gateway.poll_idx, GATEWAY_STATUS_NO_RESPONSE);
+	else {
+		GatewayFrame resp;
+		resp.len = 0;
+		(void)queueGatewayResponsePut(&f_gateway.resp_q, &resp);
+	}
+	f_gateway.pending = PENDING_NONE;
+}
+
+static void send(const uint8_t* frame, uint8_t len, uint8_t pending) {
+	f_gateway.pending = pending;
+	f_gateway.sent_ms = millis();
+	modbusSend(frame, len);
+}
+
+/* Poll the next slave in turn that has not been polled for the poll period. Each poll period is a pass for the back-off, so a backed off
+	slave skips poll periods until it is due. */
+static void poll_next() {
+	const uint32_t now = millis();
+	fori (f_gateway.count) {
+		const uint8_t idx = (uint8_t)((f_gateway.poll_idx + 1U + i) % f_gateway.count);
+		if ((now - f_gateway.poll_ms[idx]) >= CFG_GATEWAY_POLL_PERIOD_MS) {
+			poll_backoff_t* b = &f_gateway.backoff[idx];
+			if (pollBackoffIsBackedOff(b, CFG_GATEWAY_BACKOFF_THRESHOLD) && !pollBackoffIsDue(b)) {
+				f_gateway.poll_ms[idx] = now;
+				continue;
+			}
+			const GatewaySlaveDef* def = &f_gateway.roster[idx];
+			uint8_t req[6];
+			req[MODBUS_FRAME_IDX_SLAVE_ID] = def->id;
+			req[MODBUS_FRAME_IDX_FUNCTION] = MODBUS_FC_READ_HOLDING_REGISTERS;
+			req[MODBUS_FRAME_IDX_DATA + 0] = (uint8_t)(def->address >> 8);
+			req[MODBUS_FRAME_IDX_DATA + 1] = (uint8_t)def->address;
+			req[MODBUS_FRAME_IDX_DATA + 2] = 0U;
+			req[MODBUS_FRAME_IDX_DATA + 3] = def->count;
+			f_gateway.poll_idx = idx;
+			f_gateway.poll_ms[idx] = now;
+			pollBackoffSent(b, CFG_GATEWAY_BACKOFF_THRESHOLD, CFG_GATEWAY_BACKOFF_MAX);
+			send(req, sizeof(req), PENDING_POLL);
+			break;
+		}
+	}
+}
+
+static int16_t modbus_recv() {
+	return (f_gateway.bus->available() > 0) ? (int16_t)f_gateway.bus->read() : (int16_t)-1;
+}
+static void modbus_send_buf(const uint8_t* buf, uint8_t sz) {
+	f_gateway.bus->write(buf, sz);
+	f_gateway.bus->flush();			// UART drives the transmit enable in half duplex mode.
+}
+
+void gatewayInit(Stream& bus, uint32_t baud, const GatewaySlaveDef* roster, uint8_t count) {
+	memset(&f_gateway, 0, sizeof(f_gateway));
+	f_gateway.bus = &bus;
+	f_gateway.count = utilsLimitMax<uint8_t>(count, CFG_GATEWAY_SLAVE_COUNT_MAX);
+	const uint32_t now = millis();
+	fori (f_gateway.count) {
+		f_gateway.roster[i] = roster[i];
+		f_gateway.roster[i].count = utilsLimitMax<uint8_t>(roster[i].count, CFG_GATEWAY_CACHE_REGS_MAX);
+		f_gateway.cache[i].img.count = f_gateway.roster[i].count;
+		f_gateway.poll_ms[i] = now - CFG_GATEWAY_POLL_PERIOD_MS;		// All due for a poll.
+		pollBackoffInit(&f_gateway.backoff[i]);
+	}
+	f_gateway.poll_idx = (uint8_t)(f_gateway.count - 1U);				// So first poll is slave 0.
+	queueGatewayRequestInit(&f_gateway.req_q);
+	queueGatewayResponseInit(&f_gateway.resp_q);
+	while (bus.available() > 0) bus.read();		// Flush any received chars from buffer.
+	modbusInit(modbus_send_buf, modbus_recv, GATEWAY_FRAME_SIZE_MAX + 2U, baud, modbus_cb);
+}
+
+void gatewayBusService() {
+	modbusService();
+	if (PENDING_NONE != f_gateway.pending) {
+		if ((millis() - f_gateway.sent_ms) < CFG_GATEWAY_RESPONSE_TIMEOUT_MS)
+			return;
+		pending_timeout();
+	}
+	if (modbusIsBusyBus())
+		return;
+
+	GatewayFrame req;
+	if (queueGatewayRequestGet(&f_gateway.req_q, &req))		// Console requests go before polls.
+		send(req.frame, req.len, PENDING_REQUEST);
+	else if (f_gateway.count > 0U)
+		poll_next();
+}
+
+uint8_t gatewaySlaveCount() { return f_gateway.count; }
+const GatewaySlaveDef* gatewaySlaveDef(uint8_t idx) { return (idx < f_gateway.count) ? &f_gateway.roster[idx] : NULL; }
+
+bool gatewayCacheRead(uint8_t idx, GatewayCacheImage* img) {
+	if (idx >= f_gateway.count)
+		return false;
+	const CacheEntry* c = &f_gateway.cache[idx];
+	while (1) {
+		const uint32_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+		if (0U == (seq & 1U)) {
+			*img = c->img;
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&c->seq, __ATOMIC_RELAXED) == seq)
+				return true;
+		}
+	}
+}
+
+bool gatewayRequest(const uint8_t* frame, uint8_t len) {
+	if ((len < 2U) || (len > GATEWAY_FRAME_SIZE_MAX))
+		return false;
+	GatewayFrame req;
+	req.len = len;
+	memcpy(req.frame, frame, len);
+	return queueGatewayRequestPut(&f_gateway.req_q, &req);
+}
+
+bool gatewayResponse(GatewayFrame* resp) { return queueGatewayResponseGet(&f_gateway.resp_q, resp); }
@@ -0,0 +1,225 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include "host.h"
+#include "modbus.h"
+#include "gateway.h"
+
+/* Test the gateway on the host with the bus side & console side called in turn. The RS485 UART is a host HAL serial port, requests sent by the
+	gateway are decoded by simulated slaves, which queue a response to be received after a turnaround delay. */
+
+#define BUS Serial2
+
+static const GatewaySlaveDef ROSTER[] = {
+	{ 1, 100, 3 },
+	{ 2, 100, 3 },
+	{ 16, 100, 1 },
+};
+
+// Simulated slaves, each may be absent or return an exception.
+enum { SLAVE_PRESENT, SLAVE_ABSENT, SLAVE_EXCEPTION };
+static uint8_t f_slave_mode[256];
+static uint8_t f_tx[GATEWAY_FRAME_SIZE_MAX + 2];
+static uint8_t f_tx_len;
+static uint16_t f_slave_writes;
+
+static void tx_cb(uint8_t c) {
+	if (f_tx_len < sizeof(f_tx))
+		f_tx[f_tx_len++] = c;
+}
+static void add_crc(uint8_t* f, uint8_t* len) {
+	const uint16_t crc = modbusCrc(f, *len);
+	f[(*len)++] = (uint8_t)crc;
+	f[(*len)++] = (uint8_t)(crc >> 8);
+}
+
+// Register value returned by a slave.
+static uint16_t slave_reg(uint8_t id, uint16_t address) { return (uint16_t)((id << 8) + (address & 0xffU)); }
+
+// All requests from the gateway are 8 bytes with the CRC.
+static void slave_service() {
+	if (f_tx_len < 8)
+		return;
+	f_tx_len = 0;
+	TEST_ASSERT_EQUAL_UINT16(modbusCrc(f_tx, 6), (uint16_t)(f_tx[6] | (f_tx[7] << 8)));
+	const uint8_t id = f_tx[MODBUS_FRAME_IDX_SLAVE_ID];
+	if (SLAVE_ABSENT == f_slave_mode[id])
+		return;
+
+	uint8_t resp[GATEWAY_FRAME_SIZE_MAX + 2];
+	uint8_t len = 0;
+	resp[len++] = id;
+	if (SLAVE_EXCEPTION == f_slave_mode[id]) {
+		resp[len++] = (uint8_t)(f_tx[MODBUS_FRAME_IDX_FUNCTION] | 0x80U);
+		resp[len++] = 2;		// Illegal data address.
+	}
+	else if (MODBUS_FC_READ_HOLDING_REGISTERS == f_tx[MODBUS_FRAME_IDX_FUNCTION]) {
+		const uint16_t address = (uint16_t)((f_tx[2] << 8) | f_tx[3]);
+		const uint8_t count = f_tx[5];
+		resp[len++] = MODBUS_FC_READ_HOLDING_REGISTERS;
+		resp[len++] = (uint8_t)(2U * count);
+		for (uint8_t i = 0; i < count; i += 1) {
+			const uint16_t v = slave_reg(id, (uint16_t)(address + i));
+			resp[len++] = (uint8_t)(v >> 8);
+			resp[len++] = (uint8_t)v;
+		}
+	}
+	else {				// Write single register echoes the request.
+		memcpy(resp, f_tx, 6);
+		len = 6;
+		f_slave_writes += 1;
+	}
+	add_crc(resp, &len);
+	BUS.hostRx(resp, len, 500);
+}
+
+// Run the bus side for a time, the console side is the test.
+static void run_ms(uint32_t ms) {
+	const uint64_t end = hostMicros64() + (uint64_t)ms * 1000U;
+	while (hostMicros64() < end) {
+		gatewayBusService();
+		slave_service();
+		hostAdvanceMicros(50);
+	}
+}
+
+void setUp() {
+	memset(f_slave_mode, SLAVE_PRESENT, sizeof(f_slave_mode));
+	f_tx_len = 0;
+	f_slave_writes = 0;
+	BUS.begin(38400);
+	BUS.hostSetTxCallback(tx_cb);
+	hostAdvanceMicros(10000U);		// Let any response from the last test arrive so that the gateway flushes it from the UART.
+	gatewayInit(BUS, 38400, ROSTER, UTILS_ELEMENT_COUNT(ROSTER));
+}
+void tearDown() { /* empty */ }
+
+void testCacheInitial() {
+	TEST_ASSERT_EQUAL_UINT8(UTILS_ELEMENT_COUNT(ROSTER), gatewaySlaveCount());
+	TEST_ASSERT_EQUAL_UINT8(16, gatewaySlaveDef(2)->id);
+	TEST_ASSERT_NULL(gatewaySlaveDef(3));
+	GatewayCacheImage img;
+	TEST_ASSERT_TRUE(gatewayCacheRead(0, &img));
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_UNKNOWN, img.status);
+	TEST_ASSERT_EQUAL_UINT8(3, img.count);
+	TEST_ASSERT_FALSE(gatewayCacheRead(3, &img));
+}
+
+void testPollFillsCache() {
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS);
+	fori (UTILS_ELEMENT_COUNT(ROSTER)) {
+		GatewayCacheImage img;
+		TEST_ASSERT_TRUE(gatewayCacheRead(i, &img));
+		TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_OK, img.status);
+		TEST_ASSERT_EQUAL_UINT16(1, img.polls);
+		TEST_ASSERT_EQUAL_UINT16(0, img.errors);
+		forj (ROSTER[i].count)
+			TEST_ASSERT_EQUAL_UINT16(slave_reg(ROSTER[i].id, (uint16_t)(ROSTER[i].address + j)), img.regs[j]);
+	}
+}
+
+void testPollPeriod() {
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS * 10U - 1U);
+	GatewayCacheImage img;
+	gatewayCacheRead(0, &img);
+	TEST_ASSERT_EQUAL_UINT16(10, img.polls);
+	TEST_ASSERT_UINT32_WITHIN(CFG_GATEWAY_POLL_PERIOD_MS, millis(), img.timestamp_ms + CFG_GATEWAY_POLL_PERIOD_MS / 2U);
+}
+
+void testNoResponse() {
+	f_slave_mode[2] = SLAVE_ABSENT;
+	run_ms(CFG_GATEWAY_RESPONSE_TIMEOUT_MS + 20U);				// Slave 0 polled, slave 1 times out, slave 2 polled.
+	GatewayCacheImage img;
+	gatewayCacheRead(1, &img);
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_NO_RESPONSE, img.status);
+	TEST_ASSERT_EQUAL_UINT16(1, img.errors);
+	gatewayCacheRead(2, &img);									// Next slave still polled.
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_OK, img.status);
+
+	f_slave_mode[2] = SLAVE_PRESENT;							// Recovers.
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS);
+	gatewayCacheRead(1, &img);
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_OK, img.status);
+	TEST_ASSERT_EQUAL_UINT16(1, img.errors);
+}
+
+void testNoResponseBackoff() {
+	f_slave_mode[2] = SLAVE_ABSENT;
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS * 64U);
+	GatewayCacheImage img;
+	gatewayCacheRead(1, &img);
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_NO_RESPONSE, img.status);
+	TEST_ASSERT_UINT16_WITHIN(3, CFG_GATEWAY_BACKOFF_THRESHOLD + 1U + 5U, img.polls);	// Backed off after threshold, then waits 1, 2, 4...
+	gatewayCacheRead(0, &img);																// Others polled every period.
+	TEST_ASSERT_UINT16_WITHIN(1, 64, img.polls);
+
+	f_slave_mode[2] = SLAVE_PRESENT;													// Recovers by the longest back-off.
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS * ((1U << CFG_GATEWAY_BACKOFF_MAX) + 1U));
+	gatewayCacheRead(1, &img);
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_OK, img.status);
+	const uint16_t polls = img.polls;
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS * 10U);											// Then polled every period.
+	gatewayCacheRead(1, &img);
+	TEST_ASSERT_UINT16_WITHIN(1, polls + 10U, img.polls);
+}
+
+void testBadResponse() {
+	f_slave_mode[1] = SLAVE_EXCEPTION;
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS);
+	GatewayCacheImage img;
+	gatewayCacheRead(0, &img);
+	TEST_ASSERT_EQUAL_UINT8(GATEWAY_STATUS_BAD_RESPONSE, img.status);
+	TEST_ASSERT_EQUAL_UINT16(1, img.errors);
+}
+
+void testRequest() {
+	static const uint8_t REQ[] = { 16, MODBUS_FC_WRITE_SINGLE_REGISTER, 0, 100, 0x12, 0x34 };
+	TEST_ASSERT_TRUE(gatewayRequest(REQ, sizeof(REQ)));
+	run_ms(20);
+	TEST_ASSERT_EQUAL_UINT16(1, f_slave_writes);
+	GatewayFrame resp;
+	TEST_ASSERT_TRUE(gatewayResponse(&resp));
+	TEST_ASSERT_EQUAL_UINT8(sizeof(REQ), resp.len);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(REQ, resp.frame, sizeof(REQ));
+	TEST_ASSERT_FALSE(gatewayResponse(&resp));
+}
+
+void testRequestNoResponse() {
+	static const uint8_t REQ[] = { 5, MODBUS_FC_WRITE_SINGLE_REGISTER, 0, 100, 0x12, 0x34 };
+	f_slave_mode[5] = SLAVE_ABSENT;
+	TEST_ASSERT_TRUE(gatewayRequest(REQ, sizeof(REQ)));
+	run_ms(CFG_GATEWAY_RESPONSE_TIMEOUT_MS + 20U);
+	GatewayFrame resp;
+	TEST_ASSERT_TRUE(gatewayResponse(&resp));
+	TEST_ASSERT_EQUAL_UINT8(0, resp.len);
+}
+
+void testRequestQueueFull() {
+	static const uint8_t REQ[] = { 16, MODBUS_FC_WRITE_SINGLE_REGISTER, 0, 100, 0x12, 0x34 };
+	fori (CFG_GATEWAY_QUEUE_SIZE)
+		TEST_ASSERT_TRUE(gatewayRequest(REQ, sizeof(REQ)));
+	TEST_ASSERT_FALSE(gatewayRequest(REQ, sizeof(REQ)));
+	TEST_ASSERT_FALSE(gatewayRequest(REQ, 1));								// Too short or long.
+	TEST_ASSERT_FALSE(gatewayRequest(REQ, GATEWAY_FRAME_SIZE_MAX + 1U));
+
+	run_ms(CFG_GATEWAY_POLL_PERIOD_MS);								// All sent, responses in order.
+	TEST_ASSERT_EQUAL_UINT16(CFG_GATEWAY_QUEUE_SIZE, f_slave_writes);
+	GatewayFrame resp;
+	fori (CFG_GATEWAY_QUEUE_SIZE)
+		TEST_ASSERT_TRUE(gatewayResponse(&resp));
+	TEST_ASSERT_FALSE(gatewayResponse(&resp));
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(testCacheInitial);
+	RUN_TEST(testPollFillsCache);
+	RUN_TEST(testPollPeriod);
+	RUN_TEST(testNoResponse);
+	RUN_TEST(testNoResponseBackoff);
+	RUN_TEST(testBadResponse);
+	RUN_TEST(testRequest);
+	RUN_TEST(testRequestNoResponse);
+	RUN_TEST(testRequestQueueFull);
+	return UNITY_END();
+}
@@ -3,7 +3,7 @@
 
 // Define version of NV data. If you change the schema or the implementation, increment the number to force any existing
 // EEPROM to flag as corrupt. Also increment to force the default values to be set for testing.
-const uint16_t REGS_DEF_VERSION = 4;
+const uint16_t REGS_DEF_VERSION = 5;
 
 /* [[[ Definition start...
 FLAGS [fmt=hex] "Various flags.
@@ -14,6 +14,8 @@ FLAGS [fmt=hex] "Various flags.
 	cable is faulty, or that another slave is interfering with the bus."
 - DC_LOW [bit=1] "External DC power volts low.
 	The DC volts suppliting power to the slave from the bus cable is low indicating a possible problem."
+- RAM_LOW [bit=3] "Free RAM low.
+	The minimum free RAM has dropped below a threshold, so the stack may collide with other data."
 - EEPROM_READ_BAD_0 [bit=13] "EEPROM bank 0 corrupt.
 	EEPROM bank 0 corrupt. If bank 1 is corrupt too then a default set of values has been written. Flag written at startup only."
 - EEPROM_READ_BAD_1 [bit=14] "EEPROM bank 1 corrupt.
@@ -30,6 +32,14 @@ VOLTS_MON_BUS "Bus volts /mV."
 RELAYS "Bed control relays.
 	Lower 8 bits are written to relays, upper 8 bits ignored. Note that if the Controller is sending data then these values
 	will be overwritten	very quickly."
+LOOP_TIME_MAX "Max main loop time /us.
+	From the loop profiler, cleared by console command PROF-CLR. Saturates at 65535."
+LOOP_WORST_SERVICE "Slowest service in the slowest loop.
+	Index of the service that took longest in the slowest loop seen by the loop profiler, see console command ?PROF."
+RAM_FREE "Free RAM /bytes.
+	Current free RAM between the top of the heap and the stack pointer."
+RAM_FREE_MIN "Minimum free RAM /bytes.
+	Free RAM that has never been used by the stack or heap since startup, found by scanning for RAM painted at startup."
 ENABLES [nv fmt=hex] "Non-volatile enable flags.
 	A number of flags that are rarely written by the code, but control the behaviour of the system."
 - DUMP_MODBUS_EVENTS [bit=0] "Dump MODBUS event value.
@@ -47,6 +57,8 @@ MODBUS_DUMP_EVENT_MASK [nv fmt=hex default=0x0000] "Dump MODBUS events mask, ref
 	If MODBUS dump events is enabled, only events matching the bitmask in this register are dumped."
 MODBUS_DUMP_SLAVE_ID [nv default=0] "For master, only dump MODBUS events from this slave ID.
 	Event must be from this slace ID."
+RELAY_IDX [nv default=0] "Index of this Relay on the bus.
+	Added to the MODBUS slave ID of Relay 0 so that an installation can have more than one Relay, read at startup only."
 >>>  Definition end, declaration start... */
 
 // Declare the indices to the registers.
@@ -58,25 +70,31 @@ enum {
     REGS_IDX_VOLTS_MON_12V_IN = 4,
     REGS_IDX_VOLTS_MON_BUS = 5,
     REGS_IDX_RELAYS = 6,
-    REGS_IDX_ENABLES = 7,
-    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 8,
-    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 9,
-    COUNT_REGS = 10
+    REGS_IDX_LOOP_TIME_MAX = 7,
+    REGS_IDX_LOOP_WORST_SERVICE = 8,
+    REGS_IDX_RAM_FREE = 9,
+    REGS_IDX_RAM_FREE_MIN = 10,
+    REGS_IDX_ENABLES = 11,
+    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 12,
+    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 13,
+    REGS_IDX_RELAY_IDX = 14,
+    COUNT_REGS = 15
 };
 
 // Define the start of the NV regs. The region is from this index up to the end of the register array.
 #define REGS_START_NV_IDX REGS_IDX_ENABLES
 
 // Define default values for the NV segment.
-#define REGS_NV_DEFAULT_VALS 0, 0, 0
+#define REGS_NV_DEFAULT_VALS 0, 0, 0, 0
 
 // Define how to format the reg when printing.
-#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_U
+#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_U, CFMT_U
 
 // Flags/masks for register FLAGS.
 enum {
     	REGS_FLAGS_MASK_MODBUS_MASTER_NO_COMMS = (int)0x1,
     	REGS_FLAGS_MASK_DC_LOW = (int)0x2,
+    	REGS_FLAGS_MASK_RAM_LOW = (int)0x8,
     	REGS_FLAGS_MASK_EEPROM_READ_BAD_0 = (int)0x2000,
     	REGS_FLAGS_MASK_EEPROM_READ_BAD_1 = (int)0x4000,
     	REGS_FLAGS_MASK_WATCHDOG_RESTART = (int)0x8000,
@@ -100,9 +118,14 @@ enum {
  static const char REGS_NAMES_4[] PROGMEM = "VOLTS_MON_12V_IN";                         \
  static const char REGS_NAMES_5[] PROGMEM = "VOLTS_MON_BUS";                            \
  static const char REGS_NAMES_6[] PROGMEM = "RELAYS";                                   \
- static const char REGS_NAMES_7[] PROGMEM = "ENABLES";                                  \
- static const char REGS_NAMES_8[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                   \
- static const char REGS_NAMES_9[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                     \
+ static const char REGS_NAMES_7[] PROGMEM = "LOOP_TIME_MAX";                            \
+ static const char REGS_NAMES_8[] PROGMEM = "LOOP_WORST_SERVICE";                       \
+ static const char REGS_NAMES_9[] PROGMEM = "RAM_FREE";                                 \
+ static const char REGS_NAMES_10[] PROGMEM = "RAM_FREE_MIN";                            \
+ static const char REGS_NAMES_11[] PROGMEM = "ENABLES";                                 \
+ static const char REGS_NAMES_12[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                  \
+ static const char REGS_NAMES_13[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                    \
+ static const char REGS_NAMES_14[] PROGMEM = "RELAY_IDX";                               \
                                                                                         \
  static const char* const REGS_NAMES[] PROGMEM = {                                      \
    REGS_NAMES_0,                                                                        \
@@ -115,6 +138,11 @@ enum {
    REGS_NAMES_7,                                                                        \
    REGS_NAMES_8,                                                                        \
    REGS_NAMES_9,                                                                        \
+   REGS_NAMES_10,                                                                       \
+   REGS_NAMES_11,                                                                       \
+   REGS_NAMES_12,                                                                       \
+   REGS_NAMES_13,                                                                       \
+   REGS_NAMES_14,                                                                       \
  }
 
 // Declare an array of description text for each register.
@@ -126,9 +154,14 @@ enum {
  static const char REGS_DESCRS_4[] PROGMEM = "DC power in volts /mV.";                  \
  static const char REGS_DESCRS_5[] PROGMEM = "Bus volts /mV.";                          \
  static const char REGS_DESCRS_6[] PROGMEM = "Bed control relays.";                     \
- static const char REGS_DESCRS_7[] PROGMEM = "Non-volatile enable flags.";              \
- static const char REGS_DESCRS_8[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
- static const char REGS_DESCRS_9[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
+ static const char REGS_DESCRS_7[] PROGMEM = "Max main loop time /us.";                 \
+ static const char REGS_DESCRS_8[] PROGMEM = "Slowest service in the slowest loop.";    \
+ static const char REGS_DESCRS_9[] PROGMEM = "Free RAM /bytes.";                        \
+ static const char REGS_DESCRS_10[] PROGMEM = "Minimum free RAM /bytes.";               \
+ static const char REGS_DESCRS_11[] PROGMEM = "Non-volatile enable flags.";             \
+ static const char REGS_DESCRS_12[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
+ static const char REGS_DESCRS_13[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
+ static const char REGS_DESCRS_14[] PROGMEM = "Index of this Relay on the bus.";        \
                                                                                         \
  static const char* const REGS_DESCRS[] PROGMEM = {                                     \
    REGS_DESCRS_0,                                                                       \
@@ -141,6 +174,11 @@ enum {
    REGS_DESCRS_7,                                                                       \
    REGS_DESCRS_8,                                                                       \
    REGS_DESCRS_9,                                                                       \
+   REGS_DESCRS_10,                                                                      \
+   REGS_DESCRS_11,                                                                      \
+   REGS_DESCRS_12,                                                                      \
+   REGS_DESCRS_13,                                                                      \
+   REGS_DESCRS_14,                                                                      \
  }
 
 // Declare a multiline string description of the fields.
@@ -149,6 +187,7 @@ enum {
     "\nFlags:"                                                                          \
     "\n MODBUS_MASTER_NO_COMMS: 0 (No comms from MODBUS master.)"                       \
     "\n DC_LOW: 1 (External DC power volts low.)"                                       \
+    "\n RAM_LOW: 3 (Free RAM low.)"                                                     \
     "\n EEPROM_READ_BAD_0: 13 (EEPROM bank 0 corrupt.)"                                 \
     "\n EEPROM_READ_BAD_1: 14 (EEPROM bank 1 corrupt.)"                                 \
     "\n WATCHDOG_RESTART: 15 (Device has restarted from a watchdog timeout.)"           \
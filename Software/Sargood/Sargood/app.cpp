@@ -50,24 +50,24 @@ enum {
 	AXIS_DIR_UP = 1,
 };
 static void axis_set_drive(uint8_t axis, uint8_t dir) {
-	regsUpdateMask(REGS_IDX_RELAY_STATE, RELAY_HEAD_MASK << (axis*2), dir << (axis*2));
-	eventPublish(EV_RELAY_WRITE, REGS[REGS_IDX_RELAY_STATE]);
+	regsUpdateMask(REGS_IDX_RELAY_STATE_0, RELAY_HEAD_MASK << (axis*2), dir << (axis*2));
+	eventPublish(EV_RELAY_WRITE, REGS[REGS_IDX_RELAY_STATE_0]);
 }
 
 static uint8_t axis_get_dir(uint8_t axis) {
-	return ((uint8_t)REGS[REGS_IDX_RELAY_STATE] >> (axis*2)) & 3;
+	return ((uint8_t)REGS[REGS_IDX_RELAY_STATE_0] >> (axis*2)) & 3;
 }
 static int8_t axis_get_active() {
-	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE] & RELAY_HEAD_MASK) return AXIS_HEAD;
-	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE] & RELAY_FOOT_MASK) return AXIS_FOOT;
-	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE] & RELAY_BED_MASK) return AXIS_BED;
-	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE] & RELAY_TILT_MASK) return AXIS_TILT;
+	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE_0] & RELAY_HEAD_MASK) return AXIS_HEAD;
+	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE_0] & RELAY_FOOT_MASK) return AXIS_FOOT;
+	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE_0] & RELAY_BED_MASK) return AXIS_BED;
+	if ((uint8_t)REGS[REGS_IDX_RELAY_STATE_0] & RELAY_TILT_MASK) return AXIS_TILT;
 	return -1;
 }
 
 static void axis_stop_all() {
-	REGS[REGS_IDX_RELAY_STATE] = 0U;
-	eventPublish(EV_RELAY_WRITE, REGS[REGS_IDX_RELAY_STATE]);
+	REGS[REGS_IDX_RELAY_STATE_0] = 0U;
+	eventPublish(EV_RELAY_WRITE, REGS[REGS_IDX_RELAY_STATE_0]);
 }
 
 // Simple timers. The service function returns a bitmask of any that have timed out, which is a useful idea.
@@ -292,14 +292,25 @@ static struct {
 	uint8_t axis_idx;		// Counts axes and indexes into order array.
 	uint8_t axis_current;	// Axis we are currently using.
 	const uint8_t* axis_current_p;	// Points to current item in axis order array.
+	bool stale;				// Set while waiting for fresh tilt.
 } s_slew_ctx;   
 
 static int16_t get_slew_target_pos(uint8_t axis) { return driverPresets(s_slew_ctx.preset_idx)[axis]; }
 static int16_t get_slew_current_pos(uint8_t axis) { return (int16_t)REGS[REGS_IDX_TILT_SENSOR_0 + axis]; }
+
+/* Tilt that is too old is not used to start or stop a slew, e.g. if the bus is congested, so the state waits for fresh tilt. A moving axis keeps
+	moving while it waits, and the slew timeout stops it if fresh tilt never arrives. Only the first stale tilt in a run is published. */
+static bool is_slew_pos_stale(uint8_t axis) {
+	const bool stale = REGS[REGS_IDX_SENSOR_AGE_0 + axis] > REGS[REGS_IDX_SLEW_SENSOR_AGE_MAX];
+	if (stale && !s_slew_ctx.stale)
+		eventPublish(EV_SLEW_STALE, axis, REGS[REGS_IDX_SENSOR_AGE_0 + axis]);
+	s_slew_ctx.stale = stale;
+	return stale;
+}
 enum { SLEW_DIR_STOP = 0, SLEW_DIR_UP = 1, SLEW_DIR_DOWN = -1 };
 static int8_t get_dir_for_slew(uint8_t axis) {
 	const int16_t delta = get_slew_target_pos(axis) - get_slew_current_pos(axis);
-	return (uint8_t)utilsWindow(delta, -(int16_t)REGS[REGS_IDX_SLEW_START_DEADBAND], +(int16_t)REGS[REGS_IDX_SLEW_START_DEADBAND]);
+	return (uint8_t)utilsWindow<int16_t>(delta, -(int16_t)REGS[REGS_IDX_SLEW_START_DEADBAND], +(int16_t)REGS[REGS_IDX_SLEW_START_DEADBAND]);
 }
 
 static uint8_t handle_preset_slew() {
@@ -327,6 +338,7 @@ static uint8_t handle_preset_slew() {
 
 			// Decide order to move axes...
 			s_slew_ctx.axis_idx = 0U;
+			s_slew_ctx.stale = false;
 			{
 				uint8_t slew_order = 0;		// Default is first item, 0, 1. 
 				if (REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_SLEW_ORDER_FORCE) {	// Order forced to always fwd or rev. 			
@@ -362,6 +374,8 @@ static uint8_t handle_preset_slew() {
 			handle_set_state(ST_AXIS_DONE, s_slew_ctx.axis_current);
 			break;
 		}
+		if (is_slew_pos_stale(s_slew_ctx.axis_current))
+			break;
 
 		// Get direction to go, or we might be there anyways.
 		eventPublish(EV_SLEW_TARGET, s_slew_ctx.axis_current, get_slew_target_pos(s_slew_ctx.axis_current));
@@ -369,7 +383,7 @@ static uint8_t handle_preset_slew() {
 		const int8_t start_dir = get_dir_for_slew(s_slew_ctx.axis_current);
 
 		// Start moving...
-		ASSERT(0 == REGS[REGS_IDX_RELAY_STATE]);	// Assume all motors stopped here. 
+		ASSERT(0 == REGS[REGS_IDX_RELAY_STATE_0]);	// Assume all motors stopped here. 
 		if (start_dir > 0) {
 			axis_set_drive(s_slew_ctx.axis_current, AXIS_DIR_UP);
 			handle_set_state(ST_AXIS_SLEWING, s_slew_ctx.axis_current);
@@ -385,6 +399,8 @@ static uint8_t handle_preset_slew() {
 
 	case ST_AXIS_SLEWING: {
 		// Check for position reached. We can't just check for zero as it might overshoot.
+		if (is_slew_pos_stale(s_slew_ctx.axis_current))
+			break;
 		const int8_t target_dir = get_dir_for_slew(s_slew_ctx.axis_current);
 		if (0 == target_dir) {
 			eventPublish(EV_SLEW_STOP, s_slew_ctx.axis_current, get_slew_target_pos(s_slew_ctx.axis_current));
@@ -20,6 +20,11 @@
 	SLEW_FINAL		Slew rest pos; p8: axis idx; p16=current
 	RELAY_WRITE		Relay write; p8: relay
 	DEBUG_SLEW_ORDER Chosen slew order, p8=index.
+	REGS_CHANGED	Subscribed register changed; p8: register idx; p16=new value.
+	RAM_LOW			Minimum free RAM below threshold; p16=free bytes.
+	SLAVE_ONLINE	Slave responded & is queried on each schedule; p8: slave ID.
+	SLAVE_OFFLINE	Slave stopped responding & is only probed by the discovery scan; p8: slave ID.
+	SLEW_STALE		Slew waiting for fresh tilt; p8: axis idx; p16=age /ms.
 
    >>> End event definitions, begin generated code. */
 
@@ -52,7 +57,12 @@ enum {
     EV_SLEW_FINAL = 24,                 // Slew rest pos; p8: axis idx; p16=current
     EV_RELAY_WRITE = 25,                // Relay write; p8: relay
     EV_DEBUG_SLEW_ORDER = 26,           // Chosen slew order, p8=index.
-    COUNT_EV = 27,                      // Total number of events defined.
+    EV_REGS_CHANGED = 27,               // Subscribed register changed; p8: register idx; p16=new value.
+    EV_RAM_LOW = 28,                    // Minimum free RAM below threshold; p16=free bytes.
+    EV_SLAVE_ONLINE = 29,               // Slave responded & is queried on each schedule; p8: slave ID.
+    EV_SLAVE_OFFLINE = 30,              // Slave stopped responding & is only probed by the discovery scan; p8: slave ID.
+    EV_SLEW_STALE = 31,                 // Slew waiting for fresh tilt; p8: axis idx; p16=age /ms.
+    COUNT_EV = 32,                      // Total number of events defined.
 };
 
 // Size of trace mask in bytes.
@@ -87,6 +97,11 @@ enum {
  static const char EVENT_NAMES_24[] PROGMEM = "SLEW_FINAL";                             \
  static const char EVENT_NAMES_25[] PROGMEM = "RELAY_WRITE";                            \
  static const char EVENT_NAMES_26[] PROGMEM = "DEBUG_SLEW_ORDER";                       \
+ static const char EVENT_NAMES_27[] PROGMEM = "REGS_CHANGED";                           \
+ static const char EVENT_NAMES_28[] PROGMEM = "RAM_LOW";                                \
+ static const char EVENT_NAMES_29[] PROGMEM = "SLAVE_ONLINE";                           \
+ static const char EVENT_NAMES_30[] PROGMEM = "SLAVE_OFFLINE";                          \
+ static const char EVENT_NAMES_31[] PROGMEM = "SLEW_STALE";                             \
                                                                                         \
  static const char* const EVENT_NAMES[] PROGMEM = {                                     \
    EVENT_NAMES_0,                                                                       \
@@ -116,6 +131,11 @@ enum {
    EVENT_NAMES_24,                                                                      \
    EVENT_NAMES_25,                                                                      \
    EVENT_NAMES_26,                                                                      \
+   EVENT_NAMES_27,                                                                      \
+   EVENT_NAMES_28,                                                                      \
+   EVENT_NAMES_29,                                                                      \
+   EVENT_NAMES_30,                                                                      \
+   EVENT_NAMES_31,                                                                      \
  }
 
 // Event Descriptions.
@@ -147,6 +167,11 @@ enum {
  static const char EVENT_DESCS_24[] PROGMEM = "Slew rest pos; p8: axis idx; p16=current";                                                   \
  static const char EVENT_DESCS_25[] PROGMEM = "Relay write; p8: relay";                                                                     \
  static const char EVENT_DESCS_26[] PROGMEM = "Chosen slew order, p8=index.";                                                               \
+ static const char EVENT_DESCS_27[] PROGMEM = "Subscribed register changed; p8: register idx; p16=new value.";                              \
+ static const char EVENT_DESCS_28[] PROGMEM = "Minimum free RAM below threshold; p16=free bytes.";                                          \
+ static const char EVENT_DESCS_29[] PROGMEM = "Slave responded & is queried on each schedule; p8: slave ID.";                               \
+ static const char EVENT_DESCS_30[] PROGMEM = "Slave stopped responding & is only probed by the discovery scan; p8: slave ID.";             \
+ static const char EVENT_DESCS_31[] PROGMEM = "Slew waiting for fresh tilt; p8: axis idx; p16=age /ms.";                                    \
                                                                                                                                             \
  static const char* const EVENT_DESCS[] PROGMEM = {                                                                                         \
    EVENT_DESCS_0,                                                                                                                           \
@@ -176,6 +201,11 @@ enum {
    EVENT_DESCS_24,                                                                                                                          \
    EVENT_DESCS_25,                                                                                                                          \
    EVENT_DESCS_26,                                                                                                                          \
+   EVENT_DESCS_27,                                                                                                                          \
+   EVENT_DESCS_28,                                                                                                                          \
+   EVENT_DESCS_29,                                                                                                                          \
+   EVENT_DESCS_30,                                                                                                                          \
+   EVENT_DESCS_31,                                                                                                                          \
  }
 
 // ]]] End generated code.
@@ -5,6 +5,7 @@
 #include "gpio.h"
 #include "regs.h"
 #include "AsyncLiquidCrystal.h"
+#include "lcd_fb.h"
 #include "event.h"
 #include "driver.h"
 #include "thread.h"
@@ -19,28 +20,33 @@ thread_ticks_t threadGetTicks() { return (thread_ticks_t)millis(); }
 // LCD changed to use non-blocking driver which doesn't lock up the processor for 10's of ms. 
 //
 
+// Text is written to a framebuffer which sends only changed characters to the LCD driver queue.
 AsyncLiquidCrystal f_lcd(GPIO_PIN_LCD_RS, GPIO_PIN_LCD_E, GPIO_PIN_LCD_D4, GPIO_PIN_LCD_D5, GPIO_PIN_LCD_D6, GPIO_PIN_LCD_D7);
+static bool lcd_fb_set_cursor(uint8_t col, uint8_t row) { return f_lcd.setCursor(col, row); }
+static bool lcd_fb_write(uint8_t c) { return (1 == f_lcd.write(c)); }
 static void lcd_init() {
 	f_lcd.begin(GPIO_LCD_NUM_COLS, GPIO_LCD_NUM_ROWS);
+	lcdFbInit(lcd_fb_set_cursor, lcd_fb_write);
 }
 static void lcd_printf_of(char c, void* arg) {
-	*(uint8_t*)arg += 1;
-	f_lcd.write(c);
+	(void)arg;
+	lcdFbWrite(c);
 }
 void lcd_printf(uint8_t row, PGM_P fmt, ...) {
-	f_lcd.setCursor(0, row);
+	lcdFbSetCursor(0, row);
 	va_list ap;
 	va_start(ap, fmt);
-	uint8_t cc = 0;
-	myprintf(lcd_printf_of, &cc, fmt, ap);
-	while (cc++ < GPIO_LCD_NUM_COLS)
-		f_lcd.write(' ');
+	myprintf(lcd_printf_of, NULL, fmt, ap);
+	lcdFbClearToEol();
 	va_end(ap);
 }
 static void lcd_service() {
+	lcdFbUpdate();
 	f_lcd.processQueue();
 }
 static void lcd_flush() {
+	while (!lcdFbUpdate())
+		f_lcd.flush();
 	f_lcd.flush();
 }
 
@@ -161,10 +167,10 @@ const static IrCmdDef IR_CMD_DEFS[] PROGMEM = {
 
 int ir_cmds_compare(const void* k, const void* elem) {
 	const IrCmdDef* ir_cmd_def = (const IrCmdDef*)elem;
-	return (int)k - (int)pgm_read_byte(&ir_cmd_def->ir_cmd);
+	return (int)(intptr_t)k - (int)pgm_read_byte(&ir_cmd_def->ir_cmd);
 }
 uint8_t search_cmd(uint8_t code, const IrCmdDef* cmd_tab, size_t cmd_cnt) {
-	const IrCmdDef* ir_cmd_def = (const IrCmdDef*)bsearch((const void*)(int)code, cmd_tab, cmd_cnt, sizeof(IrCmdDef), ir_cmds_compare);
+	const IrCmdDef* ir_cmd_def = (const IrCmdDef*)bsearch((const void*)(intptr_t)code, cmd_tab, cmd_cnt, sizeof(IrCmdDef), ir_cmds_compare);
 	return ir_cmd_def ? pgm_read_byte(&ir_cmd_def->app_cmd) : (uint8_t)APP_CMD_IDLE;
 }
 
@@ -514,6 +520,7 @@ typedef struct {
 	uint8_t menu_item_idx;
 	uint8_t menu_item_value;
 	uint8_t msg_idx;
+	regs_t faults;			// Fault flags from last EV_REGS_CHANGED for the flags register.
 } SmLcdContext;
 static SmLcdContext f_sm_lcd_ctx;
 
@@ -582,6 +589,14 @@ const char* get_error_message() {
 static int8_t sm_lcd(EventSmContextBase* context, t_event ev) {
 	SmLcdContext* my_context = (SmLcdContext*)context;        // Downcast to derived class.
 
+	// Track fault flags in all states so that only newly set faults are acted on, a fault clearing also publishes an event.
+	regs_t new_faults = 0U;
+	if ((EV_REGS_CHANGED == event_id(ev)) && (REGS_IDX_FLAGS == event_p8(ev))) {
+		const regs_t faults = event_p16(ev) & (APP_FLAGS_MASK_SENSORS_ALL | REGS_FLAGS_MASK_FAULT_RELAY);
+		new_faults = faults & (regs_t)~my_context->faults;
+		my_context->faults = faults;
+	}
+
 	switch (context->st) {
 		case ST_INIT:
 		switch(event_id(ev)) {
@@ -653,10 +668,6 @@ static int8_t sm_lcd(EventSmContextBase* context, t_event ev) {
 			if (event_p8(ev) == TIMER_MSG)	// Takes care of redrawing the banner/status message after a command status. 
 				eventSmPostSelf(context);
 			else if (event_p8(ev) == TIMER_UPDATE_INFO) {
-				// Turn on backlight if any devices are faulty.
-				if (regsFlags() & (APP_FLAGS_MASK_SENSORS_ALL | REGS_FLAGS_MASK_FAULT_RELAY))
-					backlight_on();			
-				
 				// Display status on top line of LCD.
 				const char * const msg = get_error_message();
 				if (msg)
@@ -673,6 +684,11 @@ static int8_t sm_lcd(EventSmContextBase* context, t_event ev) {
 				driverSetLcdBacklight(0);
 			break;
 
+			case EV_REGS_CHANGED:	// Only source of turning the backlight on for a fault, so it is on as soon as a device goes faulty.
+			if (new_faults)
+				backlight_on();
+			break;
+
 			case EV_SW_TOUCH_MENU:
 			if (event_p8(ev) == EV_P8_SW_LONG_HOLD)
 				return ST_MENU;
@@ -743,9 +759,24 @@ static int8_t sm_lcd(EventSmContextBase* context, t_event ev) {
 	return EVENT_SM_NO_CHANGE;
 }
 
+// Publish changes to subscribed registers as events.
+// Only publish flags changes that touch the fault bits, the flags change for many other reasons that the GUI does not care about.
+static void regs_change_publish(uint8_t idx, regs_t v) {
+	if (REGS_IDX_FLAGS == idx) {
+		static regs_t s_faults;
+		const regs_t faults = v & (APP_FLAGS_MASK_SENSORS_ALL | REGS_FLAGS_MASK_FAULT_RELAY);
+		if (faults == s_faults)
+			return;
+		s_faults = faults;
+	}
+	eventPublish(EV_REGS_CHANGED, idx, v);
+}
+
 void guiInit() {
 	threadInit(&f_tcb_rs232_cmd);
 	eventInit();
+	regsChangeSetCallback(regs_change_publish);
+	regsChangeSubscribe(REGS_IDX_FLAGS, true);
 	lcd_init();
 	eventSmInit(sm_lcd, (EventSmContextBase*)&f_sm_lcd_ctx, 0);
 }
@@ -13,6 +13,15 @@
 // The Sargood controller has just 2 sensors
 #define CFG_TILT_SENSOR_COUNT 2
 
+// Slave roster, the Sensors & Relays queried by the master on each schedule. The app uses the first CFG_TILT_SENSOR_COUNT Sensors and Relay 0,
+//  any others are just read or written with their registers. The host simulation overrides these to time larger installations.
+#ifndef CFG_SLAVE_SENSOR_COUNT
+#define CFG_SLAVE_SENSOR_COUNT CFG_TILT_SENSOR_COUNT
+#endif
+#ifndef CFG_SLAVE_RELAY_COUNT
+#define CFG_SLAVE_RELAY_COUNT 1
+#endif
+
 // Watchdog.
 #define CFG_WATCHDOG_TIMEOUT WDTO_2S
 #define CFG_WATCHDOG_ENABLE 1
@@ -30,6 +39,13 @@ enum {
 
 #define CFG_LC2_USE_SWITCH 0
 
+// Loop profiler, times each service called from the main loop. Disable to save a few us per loop.
+#define CFG_WANT_LOOP_PROF 1
+
+// LCD framebuffer size, matches GPIO_LCD_NUM_COLS & GPIO_LCD_NUM_ROWS.
+#define CFG_LCD_FB_COLS 16
+#define CFG_LCD_FB_ROWS 2
+
 // Product name
 #define CFG_PRODUCT_NAME_STR "TSA Sargood Bed Controller"
 
@@ -3,7 +3,7 @@
 
 // Define version of NV data. If you change the schema or the implementation, increment the number to force any existing
 // EEPROM to flag as corrupt. Also increment to force the default values to be set for testing.
-const uint16_t REGS_DEF_VERSION = 8;
+const uint16_t REGS_DEF_VERSION = 11;
 
 /* [[[ Definition start...
 
@@ -14,11 +14,8 @@ FLAGS [fmt=hex] "Various flags.
 	The DC volts supplying power to the slave from the bus cable is low indicating a possible problem."
 - FAULT_NOT_AWAKE [bit=1] "Controller not awake"
 - FAULT_SLEW_TIMEOUT [bit=2] "Total time on slew axes has timed out."
-- FAULT_RELAY [bit=3] "Any fault on Relay."
-- FAULT_SENSOR_0 [bit=4] "Any fault on Sensor 0 if enabled."
-- FAULT_SENSOR_1 [bit=5] "Any fault on Sensor 1 if enabled."
-- FAULT_SENSOR_2 [bit=6] "Any fault on Sensor 2 if enabled."
-- FAULT_SENSOR_3 [bit=7] "Any fault on Sensor 3 if enabled."
+- FAULT_RELAY [bit=3] "Any fault on any Relay."
+- FAULT_SENSOR_# [bit=4 count=4] "Any fault on Sensor # if enabled."
 - SW_TOUCH_LEFT [bit=8] "Touch sw LEFT."
 - SW_TOUCH_RIGHT [bit=9] "Touch sw RIGHT."
 - SW_TOUCH_MENU [bit=10] "Touch sw MENU."
@@ -34,33 +31,43 @@ RESTART [fmt=hex] "MCUSR in low byte, wdog in high byte.
 	refer to devWatchdogInit()."
 ADC_VOLTS_MON_BUS "Raw ADC Bus volts."
 VOLTS_MON_BUS "Bus volts /mV."
-TILT_SENSOR_0 [fmt=signed] "Tilt angle Sensor 0.
+TILT_SENSOR_# [fmt=signed count=4] "Tilt angle Sensor #.
 	Value zero for horizontal, can measure nearly a full circle."
-TILT_SENSOR_1 [fmt=signed] "Tilt angle Sensor 1.
-	Value zero for horizontal, can measure nearly a full circle."
-SENSOR_STATUS_0 "Status from Sensor 0.
+SENSOR_STATUS_# [count=4] "Status from Sensor #.
 	Generally values >= 100 are good.
 	Values: 0 = no response, 1 = responding but faulty, 2 = invalid response.
 	100 = not moving, 101 = angle increasing towards vertical, 102 = angle decreasing."
-SENSOR_STATUS_1 "Status from Sensor 1.
-	See SENSOR_STATUS_0."
-RELAY_STATUS "Status from Relay .
+SENSOR_AGE_# [count=4] "Age of tilt from Sensor # /ms.
+	Time since the Sensor sampled the tilt, from the age that it reports including its filter delay, plus the time for the response on the
+	bus. Updated on each update cycle, 65535 if unknown or Sensor faulty."
+RELAY_STATUS_# [count=4] "Status from Relay #.
 	Generally values >= 100 are good.
 	Values: 0 = no response, 1 = responding but faulty, 2 = invalid response.
 	100 = OK."
-SENSOR_0_FAULTS "Number of distinct Sensor 0 faults.
+SENSOR_#_FAULTS [count=4] "Number of distinct Sensor # faults.
 	Count increments only when status changes from good to fault, or from one fault to another."
-SENSOR_1_FAULTS "Number of Sensor 1 faults.
-	As for SENSOR_0_FAULTS."
-RELAY_FAULTS "Counts number of Relay faults.
+RELAY_#_FAULTS [count=4] "Counts number of Relay # faults.
 	As for SENSOR_0_FAULTS."
-RELAY_STATE [fmt=hex] "Value written to relays."
+RELAY_STATE_# [fmt=hex count=4] "Value written to Relay #."
+SLAVES_ONLINE [fmt=hex] "Slaves online, bit n set for slave n in the roster.
+	The roster has the Relays first then the Sensors. A slave goes offline after more than MAX_SLAVE_ERRORS missed responses, and is then
+	only queried by the discovery scan until it responds."
 UPDATE_COUNT "Incremented on each update cycle."
 CMD_ACTIVE "Current running command."
 CMD_STATUS "Status from previous command."
+LOOP_TIME_MAX "Max main loop time /us.
+	From the loop profiler, cleared by console command PROF-CLR. Saturates at 65535."
+LOOP_WORST_SERVICE "Slowest service in the slowest loop.
+	Index of the service that took longest in the slowest loop seen by the loop profiler, see console command ?PROF."
+RAM_FREE "Free RAM /bytes.
+	Current free RAM between the top of the heap and the stack pointer."
+RAM_FREE_MIN "Minimum free RAM /bytes.
+	Free RAM that has never been used by the stack or heap since startup, found by scanning for RAM painted at startup."
 SLEW_TIMEOUT [nv default=30] "Timeout for axis slew in seconds."
 JOG_DURATION_MS [nv default=500] "Jog duration for single axis in ms."
 MAX_SLAVE_ERRORS [nv default=3] "Max number of consecutive slave errors before flagging."
+SLAVE_PROBE_BACKOFF_MAX [nv default=5] "Max back-off for probing an offline slave.
+	An offline slave is probed after 1 schedule pass, then 2, 4, ... up to 2 to the power of this value, max 7."
 
 ENABLES [nv fmt=hex] "Non-volatile enable flags.
 	A number of flags that are rarely written by the code, but control the behaviour of the system."
@@ -72,15 +79,15 @@ ENABLES [nv fmt=hex] "Non-volatile enable flags.
 	If set then registers are dumped at a set rate."
 - DUMP_REGS_FAST [bit=2] "Dump regs at 5/s rather than 1/s."
 - ALWAYS_AWAKE [bit=3] "Controller always awake, ignored WAKE command."
-- SENSOR_DISABLE_0 [bit=4] "Disable Sensor 0."
-- SENSOR_DISABLE_1 [bit=5] "Disable Sensor 1."
-- SENSOR_DISABLE_2 [bit=6] "Disable Sensor 2."
-- SENSOR_DISABLE_3 [bit=7] "Disable Sensor 3."
+- SENSOR_DISABLE_# [bit=4 count=4] "Disable Sensor #."
 - TOUCH_DISABLE [bit=8] "Disable touch buttons."
 - SLAVE_UPDATE_DISABLE [bit=9] "Disable slave MODBUS schedule.
 	Disable the schedule that reads Sensors and writes the Relay. For testing onlyas all slaves will go to fault state."
 - SLEW_ORDER_FORCE [bit=10] "Force constant slew order."
 - SLEW_ORDER_F_DIR [bit=11] "Forced slew order fwd - rev."
+- SENSOR_RBE [bit=12] "Read Sensors by exception.
+	Sensors only send tilt & status when they change, so responses are shorter and the schedule is quicker. Sensors in a fault state
+	are always read in full."
 - TRACE_FORMAT_BINARY [bit=13] "Dump trace in binary format."
 - TRACE_FORMAT_CONCISE [bit=14] "Dump trace in concise text format."
 - DISABLE_BLINKY_LED [bit=15] "Disable setting Blinky Led from fault states.
@@ -93,6 +100,9 @@ MODBUS_DUMP_SLAVE_ID [nv default=0] "For master, only dump MODBUS events from th
 SLEW_STOP_DEADBAND [default=30 nv] "Stop slew when within this deadband."
 SLEW_START_DEADBAND [default=50 nv] "Only start slew if delta tilt less than start-deadband.
 	If the tilt error is less than this value then slew is not started."
+SLEW_SENSOR_AGE_MAX [default=750 nv] "Max age of tilt used for slew /ms.
+	Older tilt is not used to start or stop a slew, instead the slew waits for fresh tilt, and times out if it never gets it. A stationary
+	Sensor averages over 400ms, so its tilt may be up to 600ms old plus the poll period."
 RUN_ON_TIME_POS1 [nv] "Run on time in ms for restore position 1 only."
 
 >>>  Definition end, declaration start... */
@@ -105,36 +115,73 @@ enum {
     REGS_IDX_VOLTS_MON_BUS = 3,
     REGS_IDX_TILT_SENSOR_0 = 4,
     REGS_IDX_TILT_SENSOR_1 = 5,
-    REGS_IDX_SENSOR_STATUS_0 = 6,
-    REGS_IDX_SENSOR_STATUS_1 = 7,
-    REGS_IDX_RELAY_STATUS = 8,
-    REGS_IDX_SENSOR_0_FAULTS = 9,
-    REGS_IDX_SENSOR_1_FAULTS = 10,
-    REGS_IDX_RELAY_FAULTS = 11,
-    REGS_IDX_RELAY_STATE = 12,
-    REGS_IDX_UPDATE_COUNT = 13,
-    REGS_IDX_CMD_ACTIVE = 14,
-    REGS_IDX_CMD_STATUS = 15,
-    REGS_IDX_SLEW_TIMEOUT = 16,
-    REGS_IDX_JOG_DURATION_MS = 17,
-    REGS_IDX_MAX_SLAVE_ERRORS = 18,
-    REGS_IDX_ENABLES = 19,
-    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 20,
-    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 21,
-    REGS_IDX_SLEW_STOP_DEADBAND = 22,
-    REGS_IDX_SLEW_START_DEADBAND = 23,
-    REGS_IDX_RUN_ON_TIME_POS1 = 24,
-    COUNT_REGS = 25
+    REGS_IDX_TILT_SENSOR_2 = 6,
+    REGS_IDX_TILT_SENSOR_3 = 7,
+    REGS_IDX_SENSOR_STATUS_0 = 8,
+    REGS_IDX_SENSOR_STATUS_1 = 9,
+    REGS_IDX_SENSOR_STATUS_2 = 10,
+    REGS_IDX_SENSOR_STATUS_3 = 11,
+    REGS_IDX_SENSOR_AGE_0 = 12,
+    REGS_IDX_SENSOR_AGE_1 = 13,
+    REGS_IDX_SENSOR_AGE_2 = 14,
+    REGS_IDX_SENSOR_AGE_3 = 15,
+    REGS_IDX_RELAY_STATUS_0 = 16,
+    REGS_IDX_RELAY_STATUS_1 = 17,
+    REGS_IDX_RELAY_STATUS_2 = 18,
+    REGS_IDX_RELAY_STATUS_3 = 19,
+    REGS_IDX_SENSOR_0_FAULTS = 20,
+    REGS_IDX_SENSOR_1_FAULTS = 21,
+    REGS_IDX_SENSOR_2_FAULTS = 22,
+    REGS_IDX_SENSOR_3_FAULTS = 23,
+    REGS_IDX_RELAY_0_FAULTS = 24,
+    REGS_IDX_RELAY_1_FAULTS = 25,
+    REGS_IDX_RELAY_2_FAULTS = 26,
+    REGS_IDX_RELAY_3_FAULTS = 27,
+    REGS_IDX_RELAY_STATE_0 = 28,
+    REGS_IDX_RELAY_STATE_1 = 29,
+    REGS_IDX_RELAY_STATE_2 = 30,
+    REGS_IDX_RELAY_STATE_3 = 31,
+    REGS_IDX_SLAVES_ONLINE = 32,
+    REGS_IDX_UPDATE_COUNT = 33,
+    REGS_IDX_CMD_ACTIVE = 34,
+    REGS_IDX_CMD_STATUS = 35,
+    REGS_IDX_LOOP_TIME_MAX = 36,
+    REGS_IDX_LOOP_WORST_SERVICE = 37,
+    REGS_IDX_RAM_FREE = 38,
+    REGS_IDX_RAM_FREE_MIN = 39,
+    REGS_IDX_SLEW_TIMEOUT = 40,
+    REGS_IDX_JOG_DURATION_MS = 41,
+    REGS_IDX_MAX_SLAVE_ERRORS = 42,
+    REGS_IDX_SLAVE_PROBE_BACKOFF_MAX = 43,
+    REGS_IDX_ENABLES = 44,
+    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 45,
+    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 46,
+    REGS_IDX_SLEW_STOP_DEADBAND = 47,
+    REGS_IDX_SLEW_START_DEADBAND = 48,
+    REGS_IDX_SLEW_SENSOR_AGE_MAX = 49,
+    REGS_IDX_RUN_ON_TIME_POS1 = 50,
+    COUNT_REGS = 51
+};
+
+// Declare the number of registers in each block, they follow on from the register with index 0.
+enum {
+    REGS_BLOCK_COUNT_TILT_SENSOR = 4,
+    REGS_BLOCK_COUNT_SENSOR_STATUS = 4,
+    REGS_BLOCK_COUNT_SENSOR_AGE = 4,
+    REGS_BLOCK_COUNT_RELAY_STATUS = 4,
+    REGS_BLOCK_COUNT_SENSOR_FAULTS = 4,
+    REGS_BLOCK_COUNT_RELAY_FAULTS = 4,
+    REGS_BLOCK_COUNT_RELAY_STATE = 4,
 };
 
 // Define the start of the NV regs. The region is from this index up to the end of the register array.
 #define REGS_START_NV_IDX REGS_IDX_SLEW_TIMEOUT
 
 // Define default values for the NV segment.
-#define REGS_NV_DEFAULT_VALS 30, 500, 3, 0, 0, 0, 30, 50, 0
+#define REGS_NV_DEFAULT_VALS 30, 500, 3, 5, 0, 0, 0, 30, 50, 750, 0
 
 // Define how to format the reg when printing.
-#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_D, CFMT_D, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U
+#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_D, CFMT_D, CFMT_D, CFMT_D, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_X, CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U
 
 // Flags/masks for register FLAGS.
 enum {
@@ -170,6 +217,7 @@ enum {
     	REGS_ENABLES_MASK_SLAVE_UPDATE_DISABLE = (int)0x200,
     	REGS_ENABLES_MASK_SLEW_ORDER_FORCE = (int)0x400,
     	REGS_ENABLES_MASK_SLEW_ORDER_F_DIR = (int)0x800,
+    	REGS_ENABLES_MASK_SENSOR_RBE = (int)0x1000,
     	REGS_ENABLES_MASK_TRACE_FORMAT_BINARY = (int)0x2000,
     	REGS_ENABLES_MASK_TRACE_FORMAT_CONCISE = (int)0x4000,
     	REGS_ENABLES_MASK_DISABLE_BLINKY_LED = (int)0x8000,
@@ -183,25 +231,51 @@ enum {
  static const char REGS_NAMES_3[] PROGMEM = "VOLTS_MON_BUS";                            \
  static const char REGS_NAMES_4[] PROGMEM = "TILT_SENSOR_0";                            \
  static const char REGS_NAMES_5[] PROGMEM = "TILT_SENSOR_1";                            \
- static const char REGS_NAMES_6[] PROGMEM = "SENSOR_STATUS_0";                          \
- static const char REGS_NAMES_7[] PROGMEM = "SENSOR_STATUS_1";                          \
- static const char REGS_NAMES_8[] PROGMEM = "RELAY_STATUS";                             \
- static const char REGS_NAMES_9[] PROGMEM = "SENSOR_0_FAULTS";                          \
- static const char REGS_NAMES_10[] PROGMEM = "SENSOR_1_FAULTS";                         \
- static const char REGS_NAMES_11[] PROGMEM = "RELAY_FAULTS";                            \
- static const char REGS_NAMES_12[] PROGMEM = "RELAY_STATE";                             \
- static const char REGS_NAMES_13[] PROGMEM = "UPDATE_COUNT";                            \
- static const char REGS_NAMES_14[] PROGMEM = "CMD_ACTIVE";                              \
- static const char REGS_NAMES_15[] PROGMEM = "CMD_STATUS";                              \
- static const char REGS_NAMES_16[] PROGMEM = "SLEW_TIMEOUT";                            \
- static const char REGS_NAMES_17[] PROGMEM = "JOG_DURATION_MS";                         \
- static const char REGS_NAMES_18[] PROGMEM = "MAX_SLAVE_ERRORS";                        \
- static const char REGS_NAMES_19[] PROGMEM = "ENABLES";                                 \
- static const char REGS_NAMES_20[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                  \
- static const char REGS_NAMES_21[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                    \
- static const char REGS_NAMES_22[] PROGMEM = "SLEW_STOP_DEADBAND";                      \
- static const char REGS_NAMES_23[] PROGMEM = "SLEW_START_DEADBAND";                     \
- static const char REGS_NAMES_24[] PROGMEM = "RUN_ON_TIME_POS1";                        \
+ static const char REGS_NAMES_6[] PROGMEM = "TILT_SENSOR_2";                            \
+ static const char REGS_NAMES_7[] PROGMEM = "TILT_SENSOR_3";                            \
+ static const char REGS_NAMES_8[] PROGMEM = "SENSOR_STATUS_0";                          \
+ static const char REGS_NAMES_9[] PROGMEM = "SENSOR_STATUS_1";                          \
+ static const char REGS_NAMES_10[] PROGMEM = "SENSOR_STATUS_2";                         \
+ static const char REGS_NAMES_11[] PROGMEM = "SENSOR_STATUS_3";                         \
+ static const char REGS_NAMES_12[] PROGMEM = "SENSOR_AGE_0";                            \
+ static const char REGS_NAMES_13[] PROGMEM = "SENSOR_AGE_1";                            \
+ static const char REGS_NAMES_14[] PROGMEM = "SENSOR_AGE_2";                            \
+ static const char REGS_NAMES_15[] PROGMEM = "SENSOR_AGE_3";                            \
+ static const char REGS_NAMES_16[] PROGMEM = "RELAY_STATUS_0";                          \
+ static const char REGS_NAMES_17[] PROGMEM = "RELAY_STATUS_1";                          \
+ static const char REGS_NAMES_18[] PROGMEM = "RELAY_STATUS_2";                          \
+ static const char REGS_NAMES_19[] PROGMEM = "RELAY_STATUS_3";                          \
+ static const char REGS_NAMES_20[] PROGMEM = "SENSOR_0_FAULTS";                         \
+ static const char REGS_NAMES_21[] PROGMEM = "SENSOR_1_FAULTS";                         \
+ static const char REGS_NAMES_22[] PROGMEM = "SENSOR_2_FAULTS";                         \
+ static const char REGS_NAMES_23[] PROGMEM = "SENSOR_3_FAULTS";                         \
+ static const char REGS_NAMES_24[] PROGMEM = "RELAY_0_FAULTS";                          \
+ static const char REGS_NAMES_25[] PROGMEM = "RELAY_1_FAULTS";                          \
+ static const char REGS_NAMES_26[] PROGMEM = "RELAY_2_FAULTS";                          \
+ static const char REGS_NAMES_27[] PROGMEM = "RELAY_3_FAULTS";                          \
+ static const char REGS_NAMES_28[] PROGMEM = "RELAY_STATE_0";                           \
+ static const char REGS_NAMES_29[] PROGMEM = "RELAY_STATE_1";                           \
+ static const char REGS_NAMES_30[] PROGMEM = "RELAY_STATE_2";                           \
+ static const char REGS_NAMES_31[] PROGMEM = "RELAY_STATE_3";                           \
+ static const char REGS_NAMES_32[] PROGMEM = "SLAVES_ONLINE";                           \
+ static const char REGS_NAMES_33[] PROGMEM = "UPDATE_COUNT";                            \
+ static const char REGS_NAMES_34[] PROGMEM = "CMD_ACTIVE";                              \
+ static const char REGS_NAMES_35[] PROGMEM = "CMD_STATUS";                              \
+ static const char REGS_NAMES_36[] PROGMEM = "LOOP_TIME_MAX";                           \
+ static const char REGS_NAMES_37[] PROGMEM = "LOOP_WORST_SERVICE";                      \
+ static const char REGS_NAMES_38[] PROGMEM = "RAM_FREE";                                \
+ static const char REGS_NAMES_39[] PROGMEM = "RAM_FREE_MIN";                            \
+ static const char REGS_NAMES_40[] PROGMEM = "SLEW_TIMEOUT";                            \
+ static const char REGS_NAMES_41[] PROGMEM = "JOG_DURATION_MS";                         \
+ static const char REGS_NAMES_42[] PROGMEM = "MAX_SLAVE_ERRORS";                        \
+ static const char REGS_NAMES_43[] PROGMEM = "SLAVE_PROBE_BACKOFF_MAX";                 \
+ static const char REGS_NAMES_44[] PROGMEM = "ENABLES";                                 \
+ static const char REGS_NAMES_45[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                  \
+ static const char REGS_NAMES_46[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                    \
+ static const char REGS_NAMES_47[] PROGMEM = "SLEW_STOP_DEADBAND";                      \
+ static const char REGS_NAMES_48[] PROGMEM = "SLEW_START_DEADBAND";                     \
+ static const char REGS_NAMES_49[] PROGMEM = "SLEW_SENSOR_AGE_MAX";                     \
+ static const char REGS_NAMES_50[] PROGMEM = "RUN_ON_TIME_POS1";                        \
                                                                                         \
  static const char* const REGS_NAMES[] PROGMEM = {                                      \
    REGS_NAMES_0,                                                                        \
@@ -229,6 +303,32 @@ enum {
    REGS_NAMES_22,                                                                       \
    REGS_NAMES_23,                                                                       \
    REGS_NAMES_24,                                                                       \
+   REGS_NAMES_25,                                                                       \
+   REGS_NAMES_26,                                                                       \
+   REGS_NAMES_27,                                                                       \
+   REGS_NAMES_28,                                                                       \
+   REGS_NAMES_29,                                                                       \
+   REGS_NAMES_30,                                                                       \
+   REGS_NAMES_31,                                                                       \
+   REGS_NAMES_32,                                                                       \
+   REGS_NAMES_33,                                                                       \
+   REGS_NAMES_34,                                                                       \
+   REGS_NAMES_35,                                                                       \
+   REGS_NAMES_36,                                                                       \
+   REGS_NAMES_37,                                                                       \
+   REGS_NAMES_38,                                                                       \
+   REGS_NAMES_39,                                                                       \
+   REGS_NAMES_40,                                                                       \
+   REGS_NAMES_41,                                                                       \
+   REGS_NAMES_42,                                                                       \
+   REGS_NAMES_43,                                                                       \
+   REGS_NAMES_44,                                                                       \
+   REGS_NAMES_45,                                                                       \
+   REGS_NAMES_46,                                                                       \
+   REGS_NAMES_47,                                                                       \
+   REGS_NAMES_48,                                                                       \
+   REGS_NAMES_49,                                                                       \
+   REGS_NAMES_50,                                                                       \
  }
 
 // Declare an array of description text for each register.
@@ -239,25 +339,51 @@ enum {
  static const char REGS_DESCRS_3[] PROGMEM = "Bus volts /mV.";                          \
  static const char REGS_DESCRS_4[] PROGMEM = "Tilt angle Sensor 0.";                    \
  static const char REGS_DESCRS_5[] PROGMEM = "Tilt angle Sensor 1.";                    \
- static const char REGS_DESCRS_6[] PROGMEM = "Status from Sensor 0.";                   \
- static const char REGS_DESCRS_7[] PROGMEM = "Status from Sensor 1.";                   \
- static const char REGS_DESCRS_8[] PROGMEM = "Status from Relay .";                     \
- static const char REGS_DESCRS_9[] PROGMEM = "Number of distinct Sensor 0 faults.";     \
- static const char REGS_DESCRS_10[] PROGMEM = "Number of Sensor 1 faults.";             \
- static const char REGS_DESCRS_11[] PROGMEM = "Counts number of Relay faults.";         \
- static const char REGS_DESCRS_12[] PROGMEM = "Value written to relays.";               \
- static const char REGS_DESCRS_13[] PROGMEM = "Incremented on each update cycle.";      \
- static const char REGS_DESCRS_14[] PROGMEM = "Current running command.";               \
- static const char REGS_DESCRS_15[] PROGMEM = "Status from previous command.";          \
- static const char REGS_DESCRS_16[] PROGMEM = "Timeout for axis slew in seconds.";      \
- static const char REGS_DESCRS_17[] PROGMEM = "Jog duration for single axis in ms.";    \
- static const char REGS_DESCRS_18[] PROGMEM = "Max number of consecutive slave errors before flagging.";\
- static const char REGS_DESCRS_19[] PROGMEM = "Non-volatile enable flags.";             \
- static const char REGS_DESCRS_20[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
- static const char REGS_DESCRS_21[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
- static const char REGS_DESCRS_22[] PROGMEM = "Stop slew when within this deadband.";   \
- static const char REGS_DESCRS_23[] PROGMEM = "Only start slew if delta tilt less than start-deadband.";\
- static const char REGS_DESCRS_24[] PROGMEM = "Run on time in ms for restore position 1 only.";\
+ static const char REGS_DESCRS_6[] PROGMEM = "Tilt angle Sensor 2.";                    \
+ static const char REGS_DESCRS_7[] PROGMEM = "Tilt angle Sensor 3.";                    \
+ static const char REGS_DESCRS_8[] PROGMEM = "Status from Sensor 0.";                   \
+ static const char REGS_DESCRS_9[] PROGMEM = "Status from Sensor 1.";                   \
+ static const char REGS_DESCRS_10[] PROGMEM = "Status from Sensor 2.";                  \
+ static const char REGS_DESCRS_11[] PROGMEM = "Status from Sensor 3.";                  \
+ static const char REGS_DESCRS_12[] PROGMEM = "Age of tilt from Sensor 0 /ms.";         \
+ static const char REGS_DESCRS_13[] PROGMEM = "Age of tilt from Sensor 1 /ms.";         \
+ static const char REGS_DESCRS_14[] PROGMEM = "Age of tilt from Sensor 2 /ms.";         \
+ static const char REGS_DESCRS_15[] PROGMEM = "Age of tilt from Sensor 3 /ms.";         \
+ static const char REGS_DESCRS_16[] PROGMEM = "Status from Relay 0.";                   \
+ static const char REGS_DESCRS_17[] PROGMEM = "Status from Relay 1.";                   \
+ static const char REGS_DESCRS_18[] PROGMEM = "Status from Relay 2.";                   \
+ static const char REGS_DESCRS_19[] PROGMEM = "Status from Relay 3.";                   \
+ static const char REGS_DESCRS_20[] PROGMEM = "Number of distinct Sensor 0 faults.";    \
+ static const char REGS_DESCRS_21[] PROGMEM = "Number of distinct Sensor 1 faults.";    \
+ static const char REGS_DESCRS_22[] PROGMEM = "Number of distinct Sensor 2 faults.";    \
+ static const char REGS_DESCRS_23[] PROGMEM = "Number of distinct Sensor 3 faults.";    \
+ static const char REGS_DESCRS_24[] PROGMEM = "Counts number of Relay 0 faults.";       \
+ static const char REGS_DESCRS_25[] PROGMEM = "Counts number of Relay 1 faults.";       \
+ static const char REGS_DESCRS_26[] PROGMEM = "Counts number of Relay 2 faults.";       \
+ static const char REGS_DESCRS_27[] PROGMEM = "Counts number of Relay 3 faults.";       \
+ static const char REGS_DESCRS_28[] PROGMEM = "Value written to Relay 0.";              \
+ static const char REGS_DESCRS_29[] PROGMEM = "Value written to Relay 1.";              \
+ static const char REGS_DESCRS_30[] PROGMEM = "Value written to Relay 2.";              \
+ static const char REGS_DESCRS_31[] PROGMEM = "Value written to Relay 3.";              \
+ static const char REGS_DESCRS_32[] PROGMEM = "Slaves online, bit n set for slave n in the roster.";\
+ static const char REGS_DESCRS_33[] PROGMEM = "Incremented on each update cycle.";      \
+ static const char REGS_DESCRS_34[] PROGMEM = "Current running command.";               \
+ static const char REGS_DESCRS_35[] PROGMEM = "Status from previous command.";          \
+ static const char REGS_DESCRS_36[] PROGMEM = "Max main loop time /us.";                \
+ static const char REGS_DESCRS_37[] PROGMEM = "Slowest service in the slowest loop.";   \
+ static const char REGS_DESCRS_38[] PROGMEM = "Free RAM /bytes.";                       \
+ static const char REGS_DESCRS_39[] PROGMEM = "Minimum free RAM /bytes.";               \
+ static const char REGS_DESCRS_40[] PROGMEM = "Timeout for axis slew in seconds.";      \
+ static const char REGS_DESCRS_41[] PROGMEM = "Jog duration for single axis in ms.";    \
+ static const char REGS_DESCRS_42[] PROGMEM = "Max number of consecutive slave errors before flagging.";\
+ static const char REGS_DESCRS_43[] PROGMEM = "Max back-off for probing an offline slave.";\
+ static const char REGS_DESCRS_44[] PROGMEM = "Non-volatile enable flags.";             \
+ static const char REGS_DESCRS_45[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
+ static const char REGS_DESCRS_46[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
+ static const char REGS_DESCRS_47[] PROGMEM = "Stop slew when within this deadband.";   \
+ static const char REGS_DESCRS_48[] PROGMEM = "Only start slew if delta tilt less than start-deadband.";\
+ static const char REGS_DESCRS_49[] PROGMEM = "Max age of tilt used for slew /ms.";     \
+ static const char REGS_DESCRS_50[] PROGMEM = "Run on time in ms for restore position 1 only.";\
                                                                                         \
  static const char* const REGS_DESCRS[] PROGMEM = {                                     \
    REGS_DESCRS_0,                                                                       \
@@ -285,6 +411,32 @@ enum {
    REGS_DESCRS_22,                                                                      \
    REGS_DESCRS_23,                                                                      \
    REGS_DESCRS_24,                                                                      \
+   REGS_DESCRS_25,                                                                      \
+   REGS_DESCRS_26,                                                                      \
+   REGS_DESCRS_27,                                                                      \
+   REGS_DESCRS_28,                                                                      \
+   REGS_DESCRS_29,                                                                      \
+   REGS_DESCRS_30,                                                                      \
+   REGS_DESCRS_31,                                                                      \
+   REGS_DESCRS_32,                                                                      \
+   REGS_DESCRS_33,                                                                      \
+   REGS_DESCRS_34,                                                                      \
+   REGS_DESCRS_35,                                                                      \
+   REGS_DESCRS_36,                                                                      \
+   REGS_DESCRS_37,                                                                      \
+   REGS_DESCRS_38,                                                                      \
+   REGS_DESCRS_39,                                                                      \
+   REGS_DESCRS_40,                                                                      \
+   REGS_DESCRS_41,                                                                      \
+   REGS_DESCRS_42,                                                                      \
+   REGS_DESCRS_43,                                                                      \
+   REGS_DESCRS_44,                                                                      \
+   REGS_DESCRS_45,                                                                      \
+   REGS_DESCRS_46,                                                                      \
+   REGS_DESCRS_47,                                                                      \
+   REGS_DESCRS_48,                                                                      \
+   REGS_DESCRS_49,                                                                      \
+   REGS_DESCRS_50,                                                                      \
  }
 
 // Declare a multiline string description of the fields.
@@ -294,7 +446,7 @@ enum {
     "\n DC_LOW: 0 (External DC power volts low.)"                                       \
     "\n FAULT_NOT_AWAKE: 1 (Controller not awake.)"                                     \
     "\n FAULT_SLEW_TIMEOUT: 2 (Total time on slew axes has timed out.)"                 \
-    "\n FAULT_RELAY: 3 (Any fault on Relay.)"                                           \
+    "\n FAULT_RELAY: 3 (Any fault on any Relay.)"                                       \
     "\n FAULT_SENSOR_0: 4 (Any fault on Sensor 0 if enabled.)"                          \
     "\n FAULT_SENSOR_1: 5 (Any fault on Sensor 1 if enabled.)"                          \
     "\n FAULT_SENSOR_2: 6 (Any fault on Sensor 2 if enabled.)"                          \
@@ -320,6 +472,7 @@ enum {
     "\n SLAVE_UPDATE_DISABLE: 9 (Disable slave MODBUS schedule.)"                       \
     "\n SLEW_ORDER_FORCE: 10 (Force constant slew order.)"                              \
     "\n SLEW_ORDER_F_DIR: 11 (Forced slew order fwd - rev.)"                            \
+    "\n SENSOR_RBE: 12 (Read Sensors by exception.)"                                    \
     "\n TRACE_FORMAT_BINARY: 13 (Dump trace in binary format.)"                         \
     "\n TRACE_FORMAT_CONCISE: 14 (Dump trace in concise text format.)"                  \
     "\n DISABLE_BLINKY_LED: 15 (Disable setting Blinky Led from fault states.)"         \
@@ -0,0 +1,382 @@
+#include <Arduino.h>
+
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "project_config.h"
+#include "gpio.h"
+#include "utils.h"
+#include "buffer.h"
+#include "modbus.h"
+#include "sbc2022_modbus.h"
+#include "modbus_rbe.h"
+#include "regs.h"
+#include "host.h"
+
+/* Runs the Sargood firmware on the host with the Relay & Sensor slaves simulated on the RS485 bus, and a simple bed model that moves the tilt
+	sensors when Relay 0 is on. Console commands are replayed from a script, then a report is printed. All possible slaves are simulated, the
+	firmware only queries those in its roster, which may be set from the Makefile, see `make latency'.
+	Script lines are `<ms> <console text>', the text is sent to the console at that simulated time. Blank lines & lines starting with `#' are
+	ignored. Text `!unplug <id>' or `!plug <id>' is not sent, instead the slave with that ID stops or starts responding. */
+
+// Firmware entry points in main.cpp.
+void setup();
+void loop();
+
+static struct {
+	const char* script;
+	uint32_t duration_ms;
+	uint32_t step_us;
+	bool verbose;
+} f_opts = { NULL, 0, 50, false };
+
+// Script.
+//
+
+typedef struct {
+	uint32_t at_ms;
+	char text[80];
+} script_line_t;
+static script_line_t f_script[256];
+static uint16_t f_script_len, f_script_next;
+
+static bool script_load(const char* fn) {
+	FILE* fp = fopen(fn, "rt");
+	if (NULL == fp) {
+		fprintf(stderr, "Cannot open script `%s': %s\n", fn, strerror(errno));
+		return false;
+	}
+	char line[256];
+	while ((NULL != fgets(line, sizeof(line), fp)) && (f_script_len < UTILS_ELEMENT_COUNT(f_script))) {
+		line[strcspn(line, "\r\n")] = '\0';
+		char* text;
+		const unsigned long at = strtoul(line, &text, 10);
+		if (('#' == line[0]) || (text == line))
+			continue;
+		script_line_t* sl = &f_script[f_script_len++];
+		sl->at_ms = (uint32_t)at;
+		snprintf(sl->text, sizeof(sl->text), "%s\r", text + strspn(text, " \t"));
+	}
+	fclose(fp);
+	return true;
+}
+
+// Latency from a command being sent to the console to the relay slave seeing a change in the relays. Only the first change after each command
+//  is timed.
+static struct {
+	uint64_t cmd_us;		// Zero if no command pending.
+	uint32_t count;
+	uint64_t min, max, total;
+} f_latency = { 0, 0, UINT64_MAX, 0, 0 };
+
+static void latency_relay_changed() {
+	if (f_latency.cmd_us) {
+		const uint64_t t = hostMicros64() - f_latency.cmd_us;
+		f_latency.cmd_us = 0;
+		f_latency.count += 1;
+		f_latency.total += t;
+		if (t < f_latency.min) f_latency.min = t;
+		if (t > f_latency.max) f_latency.max = t;
+	}
+}
+
+static bool sim_command(const char* text);
+static void script_service() {
+	while ((f_script_next < f_script_len) && (f_script[f_script_next].at_ms <= millis())) {
+		const script_line_t* sl = &f_script[f_script_next++];
+		if (f_opts.verbose)
+			printf("%8lu> %s\n", (unsigned long)millis(), sl->text);
+		if (!sim_command(sl->text)) {
+			GPIO_SERIAL_CONSOLE.hostRx(sl->text);
+			f_latency.cmd_us = hostMicros64();
+		}
+	}
+}
+
+// Slaves, they respond to any valid request addressed to them after a turnaround delay.
+//
+
+static const uint32_t SLAVE_TURNAROUND_US = 500;
+static const int16_t TILT_MIN = -2000, TILT_MAX = 6000;
+static const int32_t TILT_RATE_PER_SEC = 100;
+/* Sensors sample tilt at the rate of the default accel data rate & averaging, which is faster when moving. As in the Sensor, motion is checked
+	once a second, and a Sensor goes back to the stationary rate after a number of checks without motion. The age reported includes the delay
+	of the Sensor's averaging & filter for the default filter constant. */
+static const uint32_t SENSOR_SAMPLE_MOVING_US = 50000, SENSOR_SAMPLE_STILL_US = 400000;
+static const uint16_t SENSOR_FILTER_DELAY_MOVING_MS = 75, SENSOR_FILTER_DELAY_STILL_MS = 200;
+static const uint32_t SENSOR_MOTION_CHECK_US = 1000000;
+static const uint8_t SENSOR_STILL_HOLD = 3;
+
+static struct {
+	uint16_t relay;							// Relay 0, drives the bed.
+	uint32_t relay_writes;					// Writes to any Relay.
+	int32_t tilt_x1000[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];		// Scaled to integrate small steps.
+	int16_t tilt_sampled[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];	// Tilt reported by Sensors, sampled from the bed model.
+	uint64_t sample_us[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];		// Time Sensors last sampled.
+	bool sample_moving[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];		// Set if Sensor is sampling at rate for moving.
+	uint8_t still_checks[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];
+	uint64_t motion_check_us;
+	uint16_t sample_count;
+	int8_t motion[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];
+	modbus_rbe_t rbe[SBC2022_MODBUS_SLAVE_COUNT_SENSOR];		// For reads by exception, with the Sensor default deadband & silence.
+	uint32_t requests, responses;
+	uint32_t id_requests[256];				// Requests to each slave ID, answered or not.
+	bool absent[256];						// Set for slave IDs that never respond.
+} f_slaves;
+
+static int16_t sensor_tilt(uint8_t idx) { return (int16_t)(f_slaves.tilt_x1000[idx] / 1000); }
+static uint16_t sensor_age_ms(uint8_t idx) {
+	return (uint16_t)((hostMicros64() - f_slaves.sample_us[idx]) / 1000U +
+	  (f_slaves.sample_moving[idx] ? SENSOR_FILTER_DELAY_MOVING_MS : SENSOR_FILTER_DELAY_STILL_MS));
+}
+
+// Sensor tilt age seen by the app.
+static struct {
+	uint32_t count;
+	uint64_t total;
+	uint16_t max;
+} f_sensor_age;
+
+static void slave_respond(BufferDynamic& resp) {
+	resp.addU16_le(modbusCrc(resp, resp.len()));
+	GPIO_SERIAL_RS485.hostRx(resp, resp.len(), SLAVE_TURNAROUND_US);
+	f_slaves.responses += 1;
+}
+
+static void slave_handle_request(const uint8_t* req, uint8_t sz) {
+	if ((sz < 4) || (modbusCrc(req, (uint8_t)(sz - 2U)) != (uint16_t)(req[sz - 2] | (req[sz - 1] << 8))))
+		return;
+	f_slaves.requests += 1;
+	const uint8_t id = req[MODBUS_FRAME_IDX_SLAVE_ID], fc = req[MODBUS_FRAME_IDX_FUNCTION];
+	f_slaves.id_requests[id] += 1;
+	if (f_slaves.absent[id])
+		return;
+	const uint16_t address = (uint16_t)((req[MODBUS_FRAME_IDX_DATA] << 8) | req[MODBUS_FRAME_IDX_DATA + 1]);
+	const uint16_t value = (uint16_t)((req[MODBUS_FRAME_IDX_DATA + 2] << 8) | req[MODBUS_FRAME_IDX_DATA + 3]);
+	static BufferDynamic resp(32);
+	resp.clear();
+
+	if ((id >= SBC2022_MODBUS_SLAVE_ID_RELAY) && (id < SBC2022_MODBUS_SLAVE_ID_RELAY + SBC2022_MODBUS_SLAVE_COUNT_RELAY) &&
+	  (MODBUS_FC_WRITE_SINGLE_REGISTER == fc) && (8 == sz) && (SBC2022_MODBUS_REGISTER_RELAY == address)) {
+		f_slaves.relay_writes += 1;
+		if ((SBC2022_MODBUS_SLAVE_ID_RELAY == id) && (value != f_slaves.relay)) {
+			if (f_opts.verbose)
+				printf("%8lu: relay %02x -> %02x\n", (unsigned long)millis(), f_slaves.relay, value);
+			f_slaves.relay = value;
+			latency_relay_changed();
+		}
+		fori (6)
+			resp.add(req[i]);
+		slave_respond(resp);
+	}
+	else if ((id >= SBC2022_MODBUS_SLAVE_ID_SENSOR_0) && (id < SBC2022_MODBUS_SLAVE_ID_SENSOR_0 + SBC2022_MODBUS_SLAVE_COUNT_SENSOR) &&
+	  (MODBUS_FC_READ_HOLDING_REGISTERS == fc) && (8 == sz) &&
+	  ((SBC2022_MODBUS_REGISTER_SENSOR_TILT == address) || (SBC2022_MODBUS_REGISTER_SENSOR_RBE == address)) && (value <= 4)) {
+		const uint8_t idx = (uint8_t)(id - SBC2022_MODBUS_SLAVE_ID_SENSOR_0);
+		const uint16_t regs[4] = {
+			(uint16_t)f_slaves.tilt_sampled[idx],
+			(uint16_t)((f_slaves.motion[idx] > 0) ? SBC2022_MODBUS_STATUS_SLAVE_MOTION_POS :
+			  ((f_slaves.motion[idx] < 0) ? SBC2022_MODBUS_STATUS_SLAVE_MOTION_NEG : SBC2022_MODBUS_STATUS_SLAVE_OK)),
+			f_slaves.sample_count,
+			sensor_age_ms(idx),
+		};
+		if (SBC2022_MODBUS_REGISTER_SENSOR_RBE == address) {
+			static const uint16_t DEADBANDS[4] = { 1, 0, UINT16_MAX, 0 };
+			BufferDynamic req_frame(8);
+			req_frame.addMem(req, 6);
+			const uint16_t mask = modbusRbeChanges(&f_slaves.rbe[idx], regs, DEADBANDS, (uint8_t)value, 500);
+			if (modbusRbeBuildResponse(&f_slaves.rbe[idx], resp, req_frame, regs, (uint8_t)value, mask))
+				slave_respond(resp);
+			return;
+		}
+		resp.add(id);
+		resp.add(fc);
+		resp.add((uint8_t)(value * 2U));
+		fori (value)
+			resp.addU16_be(regs[i]);
+		slave_respond(resp);
+	}
+}
+
+// Handle a script command for the simulation, returns false if not one.
+static bool sim_command(const char* text) {
+	char cmd[16];
+	unsigned id;
+	if ((2 != sscanf(text, "!%15s %u", cmd, &id)) || (id > 255))
+		return false;
+	if (0 == strcmp(cmd, "unplug"))
+		f_slaves.absent[id] = true;
+	else if (0 == strcmp(cmd, "plug"))
+		f_slaves.absent[id] = false;
+	else
+		return false;
+	return true;
+}
+
+// Print changes to the fault flags & online slaves, so the time taken to flag & clear a fault can be seen.
+static void faults_service() {
+	static regs_t s_flags, s_online;
+	const regs_t flags = regsFlags() & (REGS_FLAGS_MASK_FAULT_RELAY | REGS_FLAGS_MASK_FAULT_SENSOR_0 | REGS_FLAGS_MASK_FAULT_SENSOR_1 |
+	  REGS_FLAGS_MASK_FAULT_SENSOR_2 | REGS_FLAGS_MASK_FAULT_SENSOR_3);
+	if (f_opts.verbose && ((flags != s_flags) || (REGS[REGS_IDX_SLAVES_ONLINE] != s_online)))
+		printf("%8lu: fault flags 0x%04x, online 0x%x\n", (unsigned long)millis(), flags, REGS[REGS_IDX_SLAVES_ONLINE]);
+	s_flags = flags;
+	s_online = REGS[REGS_IDX_SLAVES_ONLINE];
+
+	static uint16_t s_update_count;
+	if (REGS[REGS_IDX_UPDATE_COUNT] != s_update_count) {
+		s_update_count = REGS[REGS_IDX_UPDATE_COUNT];
+		if (!isSlaveStatusFault((uint8_t)REGS[REGS_IDX_SENSOR_STATUS_0])) {
+			const uint16_t age = REGS[REGS_IDX_SENSOR_AGE_0];
+			f_sensor_age.count += 1;
+			f_sensor_age.total += age;
+			if (age > f_sensor_age.max) f_sensor_age.max = age;
+		}
+	}
+}
+
+// Collect bytes sent to the RS485 bus, the master always sends a frame with a single flush so a frame is all the bytes sent in one loop.
+static void slaves_service() {
+	const size_t sz = GPIO_SERIAL_RS485.hostTxLen();
+	if (sz > 0) {
+		slave_handle_request(GPIO_SERIAL_RS485.hostTxBuf(), (uint8_t)utilsLimitMax<size_t>(sz, 255));
+		GPIO_SERIAL_RS485.hostTxClear();
+	}
+}
+
+// Bed model, head relays move sensor 0, foot relays move sensor 1.
+static void bed_update(uint32_t dt_us) {
+	static const uint8_t RELAY_UP[2] = { 0x01, 0x04 }, RELAY_DOWN[2] = { 0x02, 0x08 };
+	fori (2) {
+		f_slaves.motion[i] = (int8_t)(!!(f_slaves.relay & RELAY_UP[i]) - !!(f_slaves.relay & RELAY_DOWN[i]));
+		f_slaves.tilt_x1000[i] += f_slaves.motion[i] * TILT_RATE_PER_SEC * (int32_t)dt_us / 1000;
+		f_slaves.tilt_x1000[i] = utilsLimit<int32_t>(f_slaves.tilt_x1000[i], TILT_MIN * 1000, TILT_MAX * 1000);
+	}
+	const bool motion_check = (hostMicros64() - f_slaves.motion_check_us >= SENSOR_MOTION_CHECK_US);
+	if (motion_check)
+		f_slaves.motion_check_us = hostMicros64();
+	fori (SBC2022_MODBUS_SLAVE_COUNT_SENSOR) {
+		if (motion_check) {
+			if (f_slaves.motion[i]) {
+				f_slaves.sample_moving[i] = true;
+				f_slaves.still_checks[i] = 0;
+			}
+			else if (++f_slaves.still_checks[i] >= SENSOR_STILL_HOLD) {
+				f_slaves.sample_moving[i] = false;
+				f_slaves.still_checks[i] = SENSOR_STILL_HOLD;
+			}
+		}
+		if (hostMicros64() - f_slaves.sample_us[i] >= (f_slaves.sample_moving[i] ? SENSOR_SAMPLE_MOVING_US : SENSOR_SAMPLE_STILL_US)) {
+			f_slaves.sample_us[i] = hostMicros64();
+			f_slaves.tilt_sampled[i] = sensor_tilt(i);
+			if (0 == i)
+				f_slaves.sample_count += 1;
+		}
+	}
+}
+
+// Console output, echoed if verbose.
+static void console_tx(uint8_t c) {
+	if (f_opts.verbose)
+		putchar(c);
+}
+
+static double wall_seconds() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void usage() {
+	fprintf(stderr, "Usage: sargood_sim [-v] [-t duration-ms] [-s loop-step-us] [-x absent-slave-id]... script\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	int opt;
+	while (-1 != (opt = getopt(argc, argv, "vt:s:x:"))) {
+		switch (opt) {
+			case 'v': f_opts.verbose = true; break;
+			case 't': f_opts.duration_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 's': f_opts.step_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'x': f_slaves.absent[(uint8_t)strtoul(optarg, NULL, 0)] = true; break;
+			default: usage();
+		}
+	}
+	if (optind != argc - 1)
+		usage();
+	f_opts.script = argv[optind];
+	if (!script_load(f_opts.script))
+		return 1;
+	if (0 == f_opts.duration_ms)		// Default to run long enough for the last command to complete.
+		f_opts.duration_ms = (f_script_len ? f_script[f_script_len - 1].at_ms : 0U) + 5000U;
+
+	hostEepromErase();
+	hostLcdAttach(GPIO_PIN_LCD_RS, GPIO_PIN_LCD_E, GPIO_PIN_LCD_D4, GPIO_PIN_LCD_D5, GPIO_PIN_LCD_D6, GPIO_PIN_LCD_D7,
+	  GPIO_LCD_NUM_COLS, GPIO_LCD_NUM_ROWS);
+	hostAnalogSet(GPIO_PIN_VOLTS_MON_BUS, 800);		// About 12V.
+	fori (2)
+		f_slaves.tilt_x1000[i] = 1000L * 1000L;
+	fori (SBC2022_MODBUS_SLAVE_COUNT_SENSOR) {
+		f_slaves.tilt_sampled[i] = sensor_tilt(i);
+		f_slaves.sample_moving[i] = true;		// Sensors start at the moving rate.
+	}
+	fori (SBC2022_MODBUS_SLAVE_COUNT_SENSOR)
+		modbusRbeInit(&f_slaves.rbe[i]);
+	GPIO_SERIAL_CONSOLE.hostSetTxCallback(console_tx);
+
+	const double wall_start = wall_seconds();
+	setup();
+	uint64_t loops = 0;
+	uint64_t then = hostMicros64();
+	while (millis() < f_opts.duration_ms) {
+		script_service();
+		loop();
+		slaves_service();
+		faults_service();
+		hostAdvanceMicros(f_opts.step_us);
+		const uint64_t now = hostMicros64();
+		bed_update((uint32_t)(now - then));
+		then = now;
+		loops += 1;
+	}
+	const double wall = wall_seconds() - wall_start, sim = (double)hostMicros64() * 1e-6;
+
+	if (f_opts.verbose)
+		printf("\n");
+	printf("script=%s\n", f_opts.script);
+	printf("loops=%llu\n", (unsigned long long)loops);
+	printf("sim_seconds=%.3f\n", sim);
+	printf("host_seconds=%.3f\n", wall);
+	printf("loops_per_host_second=%.0f\n", (wall > 0.0) ? (double)loops / wall : 0.0);
+	printf("loops_per_sim_second=%.0f\n", (sim > 0.0) ? (double)loops / sim : 0.0);
+	printf("sensors=%u\n", CFG_SLAVE_SENSOR_COUNT);
+	printf("relays=%u\n", CFG_SLAVE_RELAY_COUNT);
+	printf("slaves=%u\n", CFG_SLAVE_SENSOR_COUNT + CFG_SLAVE_RELAY_COUNT);
+	if (REGS[REGS_IDX_UPDATE_COUNT])
+		printf("schedule_period_us=%llu\n", (unsigned long long)(hostMicros64() / REGS[REGS_IDX_UPDATE_COUNT]));
+	printf("slaves_online=0x%x\n", REGS[REGS_IDX_SLAVES_ONLINE]);
+	printf("flags=0x%x\n", regsFlags());
+	printf("modbus_requests=%lu\n", (unsigned long)f_slaves.requests);
+	for (unsigned id = 0; id < UTILS_ELEMENT_COUNT(f_slaves.id_requests); id += 1) {		// Not fori() as that has a uint8_t counter.
+		if (f_slaves.id_requests[id])
+			printf("modbus_requests_id_%u=%lu\n", id, (unsigned long)f_slaves.id_requests[id]);
+	}
+	printf("relay_writes=%lu\n", (unsigned long)f_slaves.relay_writes);
+	printf("latency_count=%lu\n", (unsigned long)f_latency.count);
+	if (f_latency.count) {
+		printf("latency_min_us=%llu\n", (unsigned long long)f_latency.min);
+		printf("latency_mean_us=%llu\n", (unsigned long long)(f_latency.total / f_latency.count));
+		printf("latency_max_us=%llu\n", (unsigned long long)f_latency.max);
+	}
+	if (f_sensor_age.count) {
+		printf("sensor_0_age_mean_ms=%llu\n", (unsigned long long)(f_sensor_age.total / f_sensor_age.count));
+		printf("sensor_0_age_max_ms=%u\n", f_sensor_age.max);
+	}
+	fori (GPIO_LCD_NUM_ROWS)
+		printf("lcd_row_%u=\"%s\"\n", i, hostLcdRow(i));
+	fori (2)
+		printf("tilt_%u=%d\n", i, sensor_tilt(i));
+	return 0;
+}
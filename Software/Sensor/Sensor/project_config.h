@@ -76,6 +76,9 @@ enum {
 // For lc2.h
 #define CFG_LC2_USE_SWITCH 0
 
+// Loop profiler, times each service called from the main loop. Disable to save a few us per loop.
+#define CFG_WANT_LOOP_PROF 1
+
 // Timers
 // TODO: Update to new standard (see FLW).
 enum {
@@ -3,7 +3,7 @@
 
 // Define version of NV data. If you change the schema or the implementation, increment the number to force any existing
 // EEPROM to flag as corrupt. Also increment to force the default values to be set for testing.
-const uint16_t REGS_DEF_VERSION = 9;
+const uint16_t REGS_DEF_VERSION = 12;
 
 /* [[[ Definition start...
 FLAGS [fmt=hex] "Various flags.
@@ -14,6 +14,8 @@ FLAGS [fmt=hex] "Various flags.
 	cable is faulty, or that another slave is interfering with the bus."
 - DC_LOW [bit=1] "External DC power volts low.
 	The DC volts supplying power to the slave from the bus cable is low indicating a possible problem."
+- RAM_LOW [bit=3] "Free RAM low.
+	The minimum free RAM has dropped below a threshold, so the stack may collide with other data."
 - ACCEL_FAIL [bit=2] "Accel sample rate bad."
 - EEPROM_READ_BAD_0 [bit=13] "EEPROM bank 0 corrupt.
 	EEPROM bank 0 corrupt. If bank 1 is corrupt too then a default set of values has been written. Flag written at startup only."
@@ -31,9 +33,21 @@ ACCEL_TILT_ANGLE_LP [fmt=signed] "Tilt angle low pass filtered."
 TILT_DELTA [fmt=signed] "Delta between current and last filtered tilt value."
 ACCEL_SAMPLE_COUNT "Incremented on every new accumulated reading from the accel."
 ACCEL_DATA_RATE_MEAS "Accel. measured sample rate."
+ACCEL_DATA_RATE_RUN "Accel. data rate in use Hz.
+	Either ACCEL_DATA_RATE_SET when moving or ACCEL_DATA_RATE_STILL when stationary, see ACCEL_RATE_STILL_THRESHOLD."
+ACCEL_AVG_RUN "Number of accel samples averaged in use.
+	Either ACCEL_AVG when moving or ACCEL_AVG_STILL when stationary."
 ACCEL_X	[fmt=signed] "Accel. raw X axis reading."
 ACCEL_Y	[fmt=signed] "Accel. raw Y axis reading."
 ACCEL_Z	[fmt=signed] "Accel. raw Z axis reading."
+LOOP_TIME_MAX "Max main loop time /us.
+	From the loop profiler, cleared by console command PROF-CLR. Saturates at 65535."
+LOOP_WORST_SERVICE "Slowest service in the slowest loop.
+	Index of the service that took longest in the slowest loop seen by the loop profiler, see console command ?PROF."
+RAM_FREE "Free RAM /bytes.
+	Current free RAM between the top of the heap and the stack pointer."
+RAM_FREE_MIN "Minimum free RAM /bytes.
+	Free RAM that has never been used by the stack or heap since startup, found by scanning for RAM painted at startup."
 ENABLES [nv fmt=hex] "Non-volatile enable flags.
 	A number of flags that are rarely written by the code, but control the behaviour of the system."
 - DUMP_MODBUS_EVENTS [bit=0] "Dump MODBUS event value.
@@ -44,6 +58,8 @@ ENABLES [nv fmt=hex] "Non-volatile enable flags.
 	If set then registers are dumped at a set rate."
 - DUMP_REGS_FAST [bit=2] "Dump regs at 5/s rather than 1/s."
 - TILT_NO_QUAD_CORRECT [bit=4] "Do not correct for tilt angles outside +/-90Deg."
+- ACCEL_RATE_FIXED [bit=5] "Do not adapt accel data rate to motion.
+	Always use the data rate & averaging for moving."
 - DISABLE_BLINKY_LED [bit=15] "Disable setting Blinky Led from fault states.
 	Used for testing the blinky LED, if set then the system will not set the LED pattern, allowing it to be set by the console
 	for testing the driver."
@@ -53,12 +69,27 @@ MODBUS_DUMP_SLAVE_ID [nv default=0] "For master, only dump MODBUS events from th
 	Event must be from this slave ID."
 TILT_FULL_SCALE [nv default=573] "Tilt value for 90Deg * 2/pi.
 	The approximate value for scaled tilt at 90Deg, with zero for horizontal. E.g. for 900 value=900*2/pi=573."
-ACCEL_AVG [nv default=20] "Number of accel samples to average."
-ACCEL_DATA_RATE_SET [nv default=400] "Accel data rate Hz."
+ACCEL_AVG [nv default=20] "Number of accel samples to average when moving."
+ACCEL_DATA_RATE_SET [nv default=400] "Accel data rate when moving Hz.
+	Rates are 6.25Hz times a power of 2, others are rounded down."
+ACCEL_AVG_STILL [nv default=40] "Number of accel samples to average when stationary."
+ACCEL_DATA_RATE_STILL [nv default=100] "Accel data rate when stationary Hz.
+	A lower rate averaged over a longer time gives quieter tilt, but the age of the tilt seen by the master must be less than its
+	SLEW_SENSOR_AGE_MAX, or it will not start a slew. The tilt filters are per averaged sample, so when stationary their constants are
+	reduced by log2 of the ratio of the averaging periods to keep the same time constant."
 ACCEL_DATA_RATE_TEST [nv default=0] "Test accel sample rate check if non-zero."
 ACCEL_TILT_FILTER_K [nv default=1] "Tilt filter constant for value returned to master."
 ACCEL_TILT_MOTION_DISC_FILTER_K [nv default=4] "Tilt filter constant for tilt motion discrimination."
 ACCEL_TILT_MOTION_DISC_THRESHOLD [nv default=5] "Threshold for tilt motion discrimination."
+ACCEL_RATE_STILL_THRESHOLD [nv default=2] "Threshold for stationary for accel data rate.
+	The accel switches to the moving rate as soon as motion is detected, and back to the stationary rate when the tilt delta is
+	within this threshold for ACCEL_RATE_STILL_HOLD checks in a row. Should be less than ACCEL_TILT_MOTION_DISC_THRESHOLD for hysteresis."
+ACCEL_RATE_STILL_HOLD [nv default=3] "Number of stationary motion checks before switching to stationary rate.
+	Motion is checked once a second."
+TILT_RBE_DEADBAND [nv default=1] "Deadband for reporting tilt by exception.
+	When the master reads tilt by exception, tilt is only reported if it differs from the last value reported by more than this."
+TILT_RBE_MAX_SILENCE_MS [nv default=500] "Max time between full reports by exception /ms.
+	When the master reads tilt by exception, all values are reported if this time has passed since they were last all reported."
 >>>  Definition end, declaration start... */
 
 // Declare the indices to the registers.
@@ -73,35 +104,48 @@ enum {
     REGS_IDX_TILT_DELTA = 7,
     REGS_IDX_ACCEL_SAMPLE_COUNT = 8,
     REGS_IDX_ACCEL_DATA_RATE_MEAS = 9,
-    REGS_IDX_ACCEL_X = 10,
-    REGS_IDX_ACCEL_Y = 11,
-    REGS_IDX_ACCEL_Z = 12,
-    REGS_IDX_ENABLES = 13,
-    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 14,
-    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 15,
-    REGS_IDX_TILT_FULL_SCALE = 16,
-    REGS_IDX_ACCEL_AVG = 17,
-    REGS_IDX_ACCEL_DATA_RATE_SET = 18,
-    REGS_IDX_ACCEL_DATA_RATE_TEST = 19,
-    REGS_IDX_ACCEL_TILT_FILTER_K = 20,
-    REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K = 21,
-    REGS_IDX_ACCEL_TILT_MOTION_DISC_THRESHOLD = 22,
-    COUNT_REGS = 23
+    REGS_IDX_ACCEL_DATA_RATE_RUN = 10,
+    REGS_IDX_ACCEL_AVG_RUN = 11,
+    REGS_IDX_ACCEL_X = 12,
+    REGS_IDX_ACCEL_Y = 13,
+    REGS_IDX_ACCEL_Z = 14,
+    REGS_IDX_LOOP_TIME_MAX = 15,
+    REGS_IDX_LOOP_WORST_SERVICE = 16,
+    REGS_IDX_RAM_FREE = 17,
+    REGS_IDX_RAM_FREE_MIN = 18,
+    REGS_IDX_ENABLES = 19,
+    REGS_IDX_MODBUS_DUMP_EVENT_MASK = 20,
+    REGS_IDX_MODBUS_DUMP_SLAVE_ID = 21,
+    REGS_IDX_TILT_FULL_SCALE = 22,
+    REGS_IDX_ACCEL_AVG = 23,
+    REGS_IDX_ACCEL_DATA_RATE_SET = 24,
+    REGS_IDX_ACCEL_AVG_STILL = 25,
+    REGS_IDX_ACCEL_DATA_RATE_STILL = 26,
+    REGS_IDX_ACCEL_DATA_RATE_TEST = 27,
+    REGS_IDX_ACCEL_TILT_FILTER_K = 28,
+    REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K = 29,
+    REGS_IDX_ACCEL_TILT_MOTION_DISC_THRESHOLD = 30,
+    REGS_IDX_ACCEL_RATE_STILL_THRESHOLD = 31,
+    REGS_IDX_ACCEL_RATE_STILL_HOLD = 32,
+    REGS_IDX_TILT_RBE_DEADBAND = 33,
+    REGS_IDX_TILT_RBE_MAX_SILENCE_MS = 34,
+    COUNT_REGS = 35
 };
 
 // Define the start of the NV regs. The region is from this index up to the end of the register array.
 #define REGS_START_NV_IDX REGS_IDX_ENABLES
 
 // Define default values for the NV segment.
-#define REGS_NV_DEFAULT_VALS 0, 0, 0, 573, 20, 400, 0, 1, 4, 5
+#define REGS_NV_DEFAULT_VALS 0, 0, 0, 573, 20, 400, 40, 100, 0, 1, 4, 5, 2, 3, 1, 500
 
 // Define how to format the reg when printing.
-#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_D, CFMT_U, CFMT_D, CFMT_D, CFMT_U, CFMT_U, CFMT_D, CFMT_D, CFMT_D, CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U
+#define REGS_FORMAT_DEF CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_D, CFMT_U, CFMT_D, CFMT_D, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_D, CFMT_D, CFMT_D, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_X, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U
 
 // Flags/masks for register FLAGS.
 enum {
     	REGS_FLAGS_MASK_MODBUS_MASTER_NO_COMMS = (int)0x1,
     	REGS_FLAGS_MASK_DC_LOW = (int)0x2,
+    	REGS_FLAGS_MASK_RAM_LOW = (int)0x8,
     	REGS_FLAGS_MASK_ACCEL_FAIL = (int)0x4,
     	REGS_FLAGS_MASK_EEPROM_READ_BAD_0 = (int)0x2000,
     	REGS_FLAGS_MASK_EEPROM_READ_BAD_1 = (int)0x4000,
@@ -114,6 +158,7 @@ enum {
     	REGS_ENABLES_MASK_DUMP_REGS = (int)0x2,
     	REGS_ENABLES_MASK_DUMP_REGS_FAST = (int)0x4,
     	REGS_ENABLES_MASK_TILT_NO_QUAD_CORRECT = (int)0x10,
+    	REGS_ENABLES_MASK_ACCEL_RATE_FIXED = (int)0x20,
     	REGS_ENABLES_MASK_DISABLE_BLINKY_LED = (int)0x8000,
 };
 
@@ -129,19 +174,31 @@ enum {
  static const char REGS_NAMES_7[] PROGMEM = "TILT_DELTA";                               \
  static const char REGS_NAMES_8[] PROGMEM = "ACCEL_SAMPLE_COUNT";                       \
  static const char REGS_NAMES_9[] PROGMEM = "ACCEL_DATA_RATE_MEAS";                     \
- static const char REGS_NAMES_10[] PROGMEM = "ACCEL_X";                                 \
- static const char REGS_NAMES_11[] PROGMEM = "ACCEL_Y";                                 \
- static const char REGS_NAMES_12[] PROGMEM = "ACCEL_Z";                                 \
- static const char REGS_NAMES_13[] PROGMEM = "ENABLES";                                 \
- static const char REGS_NAMES_14[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                  \
- static const char REGS_NAMES_15[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                    \
- static const char REGS_NAMES_16[] PROGMEM = "TILT_FULL_SCALE";                         \
- static const char REGS_NAMES_17[] PROGMEM = "ACCEL_AVG";                               \
- static const char REGS_NAMES_18[] PROGMEM = "ACCEL_DATA_RATE_SET";                     \
- static const char REGS_NAMES_19[] PROGMEM = "ACCEL_DATA_RATE_TEST";                    \
- static const char REGS_NAMES_20[] PROGMEM = "ACCEL_TILT_FILTER_K";                     \
- static const char REGS_NAMES_21[] PROGMEM = "ACCEL_TILT_MOTION_DISC_FILTER_K";         \
- static const char REGS_NAMES_22[] PROGMEM = "ACCEL_TILT_MOTION_DISC_THRESHOLD";        \
+ static const char REGS_NAMES_10[] PROGMEM = "ACCEL_DATA_RATE_RUN";                     \
+ static const char REGS_NAMES_11[] PROGMEM = "ACCEL_AVG_RUN";                           \
+ static const char REGS_NAMES_12[] PROGMEM = "ACCEL_X";                                 \
+ static const char REGS_NAMES_13[] PROGMEM = "ACCEL_Y";                                 \
+ static const char REGS_NAMES_14[] PROGMEM = "ACCEL_Z";                                 \
+ static const char REGS_NAMES_15[] PROGMEM = "LOOP_TIME_MAX";                           \
+ static const char REGS_NAMES_16[] PROGMEM = "LOOP_WORST_SERVICE";                      \
+ static const char REGS_NAMES_17[] PROGMEM = "RAM_FREE";                                \
+ static const char REGS_NAMES_18[] PROGMEM = "RAM_FREE_MIN";                            \
+ static const char REGS_NAMES_19[] PROGMEM = "ENABLES";                                 \
+ static const char REGS_NAMES_20[] PROGMEM = "MODBUS_DUMP_EVENT_MASK";                  \
+ static const char REGS_NAMES_21[] PROGMEM = "MODBUS_DUMP_SLAVE_ID";                    \
+ static const char REGS_NAMES_22[] PROGMEM = "TILT_FULL_SCALE";                         \
+ static const char REGS_NAMES_23[] PROGMEM = "ACCEL_AVG";                               \
+ static const char REGS_NAMES_24[] PROGMEM = "ACCEL_DATA_RATE_SET";                     \
+ static const char REGS_NAMES_25[] PROGMEM = "ACCEL_AVG_STILL";                         \
+ static const char REGS_NAMES_26[] PROGMEM = "ACCEL_DATA_RATE_STILL";                   \
+ static const char REGS_NAMES_27[] PROGMEM = "ACCEL_DATA_RATE_TEST";                    \
+ static const char REGS_NAMES_28[] PROGMEM = "ACCEL_TILT_FILTER_K";                     \
+ static const char REGS_NAMES_29[] PROGMEM = "ACCEL_TILT_MOTION_DISC_FILTER_K";         \
+ static const char REGS_NAMES_30[] PROGMEM = "ACCEL_TILT_MOTION_DISC_THRESHOLD";        \
+ static const char REGS_NAMES_31[] PROGMEM = "ACCEL_RATE_STILL_THRESHOLD";              \
+ static const char REGS_NAMES_32[] PROGMEM = "ACCEL_RATE_STILL_HOLD";                   \
+ static const char REGS_NAMES_33[] PROGMEM = "TILT_RBE_DEADBAND";                       \
+ static const char REGS_NAMES_34[] PROGMEM = "TILT_RBE_MAX_SILENCE_MS";                 \
                                                                                         \
  static const char* const REGS_NAMES[] PROGMEM = {                                      \
    REGS_NAMES_0,                                                                        \
@@ -167,6 +224,18 @@ enum {
    REGS_NAMES_20,                                                                       \
    REGS_NAMES_21,                                                                       \
    REGS_NAMES_22,                                                                       \
+   REGS_NAMES_23,                                                                       \
+   REGS_NAMES_24,                                                                       \
+   REGS_NAMES_25,                                                                       \
+   REGS_NAMES_26,                                                                       \
+   REGS_NAMES_27,                                                                       \
+   REGS_NAMES_28,                                                                       \
+   REGS_NAMES_29,                                                                       \
+   REGS_NAMES_30,                                                                       \
+   REGS_NAMES_31,                                                                       \
+   REGS_NAMES_32,                                                                       \
+   REGS_NAMES_33,                                                                       \
+   REGS_NAMES_34,                                                                       \
  }
 
 // Declare an array of description text for each register.
@@ -182,18 +251,30 @@ enum {
  static const char REGS_DESCRS_8[] PROGMEM = "Incremented on every new accumulated reading from the accel.";\
  static const char REGS_DESCRS_9[] PROGMEM = "Accel.";                                  \
  static const char REGS_DESCRS_10[] PROGMEM = "Accel.";                                 \
- static const char REGS_DESCRS_11[] PROGMEM = "Accel.";                                 \
+ static const char REGS_DESCRS_11[] PROGMEM = "Number of accel samples averaged in use.";\
  static const char REGS_DESCRS_12[] PROGMEM = "Accel.";                                 \
- static const char REGS_DESCRS_13[] PROGMEM = "Non-volatile enable flags.";             \
- static const char REGS_DESCRS_14[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
- static const char REGS_DESCRS_15[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
- static const char REGS_DESCRS_16[] PROGMEM = "Tilt value for 90Deg * 2/pi.";           \
- static const char REGS_DESCRS_17[] PROGMEM = "Number of accel samples to average.";    \
- static const char REGS_DESCRS_18[] PROGMEM = "Accel data rate Hz.";                    \
- static const char REGS_DESCRS_19[] PROGMEM = "Test accel sample rate check if non-zero.";\
- static const char REGS_DESCRS_20[] PROGMEM = "Tilt filter constant for value returned to master.";\
- static const char REGS_DESCRS_21[] PROGMEM = "Tilt filter constant for tilt motion discrimination.";\
- static const char REGS_DESCRS_22[] PROGMEM = "Threshold for tilt motion discrimination.";\
+ static const char REGS_DESCRS_13[] PROGMEM = "Accel.";                                 \
+ static const char REGS_DESCRS_14[] PROGMEM = "Accel.";                                 \
+ static const char REGS_DESCRS_15[] PROGMEM = "Max main loop time /us.";                \
+ static const char REGS_DESCRS_16[] PROGMEM = "Slowest service in the slowest loop.";   \
+ static const char REGS_DESCRS_17[] PROGMEM = "Free RAM /bytes.";                       \
+ static const char REGS_DESCRS_18[] PROGMEM = "Minimum free RAM /bytes.";               \
+ static const char REGS_DESCRS_19[] PROGMEM = "Non-volatile enable flags.";             \
+ static const char REGS_DESCRS_20[] PROGMEM = "Dump MODBUS events mask, refer MODBUS_CB_EVT_xxx.";\
+ static const char REGS_DESCRS_21[] PROGMEM = "For master, only dump MODBUS events from this slave ID.";\
+ static const char REGS_DESCRS_22[] PROGMEM = "Tilt value for 90Deg * 2/pi.";           \
+ static const char REGS_DESCRS_23[] PROGMEM = "Number of accel samples to average when moving.";\
+ static const char REGS_DESCRS_24[] PROGMEM = "Accel data rate when moving Hz.";        \
+ static const char REGS_DESCRS_25[] PROGMEM = "Number of accel samples to average when stationary.";\
+ static const char REGS_DESCRS_26[] PROGMEM = "Accel data rate when stationary Hz.";    \
+ static const char REGS_DESCRS_27[] PROGMEM = "Test accel sample rate check if non-zero.";\
+ static const char REGS_DESCRS_28[] PROGMEM = "Tilt filter constant for value returned to master.";\
+ static const char REGS_DESCRS_29[] PROGMEM = "Tilt filter constant for tilt motion discrimination.";\
+ static const char REGS_DESCRS_30[] PROGMEM = "Threshold for tilt motion discrimination.";\
+ static const char REGS_DESCRS_31[] PROGMEM = "Threshold for stationary for accel data rate.";\
+ static const char REGS_DESCRS_32[] PROGMEM = "Number of stationary motion checks before switching to stationary rate.";\
+ static const char REGS_DESCRS_33[] PROGMEM = "Deadband for reporting tilt by exception.";\
+ static const char REGS_DESCRS_34[] PROGMEM = "Max time between full reports by exception /ms.";\
                                                                                         \
  static const char* const REGS_DESCRS[] PROGMEM = {                                     \
    REGS_DESCRS_0,                                                                       \
@@ -219,6 +300,18 @@ enum {
    REGS_DESCRS_20,                                                                      \
    REGS_DESCRS_21,                                                                      \
    REGS_DESCRS_22,                                                                      \
+   REGS_DESCRS_23,                                                                      \
+   REGS_DESCRS_24,                                                                      \
+   REGS_DESCRS_25,                                                                      \
+   REGS_DESCRS_26,                                                                      \
+   REGS_DESCRS_27,                                                                      \
+   REGS_DESCRS_28,                                                                      \
+   REGS_DESCRS_29,                                                                      \
+   REGS_DESCRS_30,                                                                      \
+   REGS_DESCRS_31,                                                                      \
+   REGS_DESCRS_32,                                                                      \
+   REGS_DESCRS_33,                                                                      \
+   REGS_DESCRS_34,                                                                      \
  }
 
 // Declare a multiline string description of the fields.
@@ -227,6 +320,7 @@ enum {
     "\nFlags:"                                                                          \
     "\n MODBUS_MASTER_NO_COMMS: 0 (No comms from MODBUS master.)"                       \
     "\n DC_LOW: 1 (External DC power volts low.)"                                       \
+    "\n RAM_LOW: 3 (Free RAM low.)"                                                     \
     "\n ACCEL_FAIL: 2 (Accel sample rate bad.)"                                         \
     "\n EEPROM_READ_BAD_0: 13 (EEPROM bank 0 corrupt.)"                                 \
     "\n EEPROM_READ_BAD_1: 14 (EEPROM bank 1 corrupt.)"                                 \
@@ -236,6 +330,7 @@ enum {
     "\n DUMP_REGS: 1 (Enable regs dump to console.)"                                    \
     "\n DUMP_REGS_FAST: 2 (Dump regs at 5/s rather than 1/s.)"                          \
     "\n TILT_NO_QUAD_CORRECT: 4 (Do not correct for tilt angles outside +/-90Deg.)"     \
+    "\n ACCEL_RATE_FIXED: 5 (Do not adapt accel data rate to motion.)"                  \
     "\n DISABLE_BLINKY_LED: 15 (Disable setting Blinky Led from fault states.)"         \
 
 // ]]] Declarations end
@@ -2,12 +2,12 @@ del Sensor-Arduino/*.*
 del Sensor-Arduino.zip
 
 robocopy Sensor Sensor-Arduino  project_config.h regs_local.h gpio.h 
-robocopy ..\Shared\Common\include 	Sensor-Arduino console.h modbus.h regs.h buffer.h utils.h
-robocopy ..\Shared\Common\src 		Sensor-Arduino console.cpp modbus.cpp regs.cpp utils.cpp
-robocopy ..\Shared\AVR\include 		Sensor-Arduino dev.h SparkFun_ADXL345.h
-robocopy ..\Shared\AVR\src 			Sensor-Arduino dev.cpp SparkFun_ADXL345.cpp
+robocopy ..\Shared\Common\include 	Sensor-Arduino console.h loop_prof.h modbus.h modbus_rbe.h regs.h buffer.h utils.h
+robocopy ..\Shared\Common\src 		Sensor-Arduino console.cpp loop_prof.cpp modbus.cpp modbus_rbe.cpp regs.cpp utils.cpp
+robocopy ..\Shared\AVR\include 		Sensor-Arduino dev.h SparkFun_ADXL345.h timer_serial.h
+robocopy ..\Shared\AVR\src 			Sensor-Arduino dev.cpp SparkFun_ADXL345.cpp timer_serial.cpp
 
-robocopy ..\Shared\2022SBC 			Sensor-Arduino driver.h driver.cpp sbc2022_modbus.h
+robocopy ..\Shared\2022SBC 			Sensor-Arduino driver.h driver.cpp driver_tables.h sbc2022_modbus.h console_cmds.h
 copy ..\Shared\2022SBC\main.cpp Sensor-Arduino\Sensor-Arduino.ino
 
 "C:\Program Files\7-Zip\7z" a -r -tzip Sensor-Arduino Sensor-Arduino
\ No newline at end of file
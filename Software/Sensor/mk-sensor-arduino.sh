@@ -5,12 +5,12 @@ rm -f Sensor-Arduino/*
 rm -f Sensor-Arduino.zip
 
 cp -r Sensor/{project_config.h,regs_local.h,gpio.h} Sensor-Arduino  
-cp -r ../Shared/Common/include/{console.h,modbus.h,regs.h,buffer.h,utils.h} Sensor-Arduino  
-cp -r ../Shared/Common/src/{console.cpp,modbus.cpp,regs.cpp,utils.cpp} Sensor-Arduino  
-cp -r ../Shared/AVR/include/{dev.h,SparkFun_ADXL345.h} Sensor-Arduino  
-cp -r ../Shared/AVR/src/{dev.cpp,SparkFun_ADXL345.cpp} Sensor-Arduino  
+cp -r ../Shared/Common/include/{console.h,loop_prof.h,modbus.h,modbus_rbe.h,regs.h,buffer.h,utils.h} Sensor-Arduino  
+cp -r ../Shared/Common/src/{console.cpp,loop_prof.cpp,modbus.cpp,modbus_rbe.cpp,regs.cpp,utils.cpp} Sensor-Arduino  
+cp -r ../Shared/AVR/include/{dev.h,SparkFun_ADXL345.h,timer_serial.h} Sensor-Arduino  
+cp -r ../Shared/AVR/src/{dev.cpp,SparkFun_ADXL345.cpp,timer_serial.cpp} Sensor-Arduino  
 
-cp -r ../Shared/2022SBC/{driver.h,driver.cpp,sbc2022_modbus.h} Sensor-Arduino  
+cp -r ../Shared/2022SBC/{driver.h,driver.cpp,driver_tables.h,sbc2022_modbus.h,console_cmds.h} Sensor-Arduino  
 cp ../Shared/2022SBC/main.cpp Sensor-Arduino/Sensor-Arduino.ino
 
 zip -r Sensor-Arduino Sensor-Arduino
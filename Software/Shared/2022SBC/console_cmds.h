@@ -0,0 +1,451 @@
+#ifndef CONSOLE_CMDS_H__
+#define CONSOLE_CMDS_H__
+
+// This file is autogenerated from `console_cmds.src'. Do not edit, your changes will be lost!
+
+
+// Info
+static void console_cmd_0() {		// ?VER
+	print_banner();
+}
+
+// Controller
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_1() {		// CMD
+	appCmdRun(consoleStackPop());
+}
+#endif
+
+// Driver
+static void console_cmd_2() {		// LED
+	driverSetLedPattern(consoleStackPop());
+}
+static void console_cmd_3() {		// ?LED
+	consolePrint(CFMT_D, driverGetLedPattern());
+}
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
+static void console_cmd_4() {		// RLY
+	REGS[REGS_IDX_RELAYS] = consoleStackPop();
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
+static void console_cmd_5() {		// ?RLY
+	consolePrint(CFMT_D, REGS[REGS_IDX_RELAYS]);
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_6() {		// ?S
+	fori (CFG_TILT_SENSOR_COUNT) consolePrint(CFMT_D, REGS[REGS_IDX_TILT_SENSOR_0 + i]);
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_7() {		// ?PR
+	fori (DRIVER_BED_POS_PRESET_COUNT) {
+		forj (CFG_TILT_SENSOR_COUNT) consolePrint(CFMT_D, driverPresets(i)[j]);
+	}
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_8() {		// PR
+	const uint8_t idx = consoleStackPop(); if (idx >= DRIVER_BED_POS_PRESET_COUNT) consoleRaise(CONSOLE_RC_ERROR_USER);
+	fori (CFG_TILT_SENSOR_COUNT) driverPresets(idx)[CFG_TILT_SENSOR_COUNT-i-1] = consoleStackPop();
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_9() {		// ?LIM
+	fori (CFG_TILT_SENSOR_COUNT) {
+		consolePrint(CFMT_D, driverAxisLimitGet(i, DRIVER_AXIS_LIMIT_IDX_LOWER)); consolePrint(CFMT_D, driverAxisLimitGet(i, DRIVER_AXIS_LIMIT_IDX_UPPER));
+	}
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_10() {		// LIM
+	const uint8_t axis_idx = consoleStackPop(); if (axis_idx >= CFG_TILT_SENSOR_COUNT) consoleRaise(CONSOLE_RC_ERROR_USER);
+	driverAxisLimitSet(axis_idx, DRIVER_AXIS_LIMIT_IDX_UPPER, consoleStackPop()); driverAxisLimitSet(axis_idx, DRIVER_AXIS_LIMIT_IDX_LOWER, consoleStackPop());
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_11() {		// BL
+	driverSetLcdBacklight(consoleStackPop());
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_12() {		// ?LCD
+	const lcd_fb_stats_t* stats = lcdFbStats(); consolePrint(CFMT_U_D, (console_cell_t)&stats->queued); consolePrint(CFMT_U_D, (console_cell_t)&stats->direct);
+}
+#endif
+static void console_cmd_13() {		// ?PROF
+	loop_prof_print();
+}
+static void console_cmd_14() {		// PROF-CLR
+	loopProfReset();
+}
+static void console_cmd_15() {		// ?WDS
+	wdog_stats_print();
+}
+static void console_cmd_16() {		// WDS-CLR
+	devWatchdogStatsClear();
+}
+
+// Events
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_17() {		// EVENT
+	eventPublish(consoleStackPop());
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_18() {		// EVENT-EX
+	const uint16_t p16 = consoleStackPop(); const uint8_t p8 = consoleStackPop(); eventPublish(consoleStackPop(), p8, p16);
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_19() {		// CTM
+	eventTraceMaskClear();
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_20() {		// DTM
+	eventTraceMaskSetDefault(); eventTraceMaskSetBit(EV_TIMER, false);  eventTraceMaskSetBit(EV_DEBUG_TIMER_ARM, false); eventTraceMaskSetBit(EV_DEBUG_TIMER_STOP, false);
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_21() {		// ?TM
+	fori ((COUNT_EV + 15) / 16) consolePrint(CFMT_X, ((uint16_t)eventGetTraceMask()[i*2+1]<<8) | (uint16_t)eventGetTraceMask()[i*2]);
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_22() {		// ??TM
+	fori (COUNT_EV) {
+		printf_s(PSTR("\n%d: %S: %c"), i, eventGetEventName(i), eventTraceMaskGetBit(i) + '0');
+		wdt_reset();
+	}
+}
+#endif
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static void console_cmd_23() {		// STM
+	const uint8_t ev_id = consoleStackPop(); eventTraceMaskSetBit(ev_id, consoleStackPop());
+}
+#endif
+
+// MODBUS
+static void console_cmd_24() {		// M
+	regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_MODBUS_EVENTS, true);
+}
+static void console_cmd_25() {		// ATN
+	driverSendAtn();
+}
+static void console_cmd_26() {		// SL
+	modbusSetSlaveId(consoleStackPop());
+}
+static void console_cmd_27() {		// ?SL
+	consolePrint(CFMT_D, modbusGetSlaveId());
+}
+static void console_cmd_28() {		// SEND-RAW
+	uint8_t* d = (uint8_t*)consoleStackPop(); uint8_t sz = *d; modbusSend(d + 1, sz, false);
+}
+static void console_cmd_29() {		// SEND
+	uint8_t* d = (uint8_t*)consoleStackPop(); uint8_t sz = *d; modbusSend(d + 1, sz);
+}
+static void console_cmd_30() {		// WRITE
+	// (val addr sl -) REQ: [FC=6 addr:16 value:16] -- RESP: [FC=6 addr:16 value:16]
+	BufferDynamic rf(10);
+	rf.add(consoleStackPop());
+	rf.add(MODBUS_FC_WRITE_SINGLE_REGISTER);
+	rf.addU16_be((uint16_t)consoleStackPop());
+	rf.addU16_be((uint16_t)consoleStackPop());
+	modbusSend(rf);
+}
+static void console_cmd_31() {		// READ
+	// (count addr sl -) REQ: [FC=3 addr:16 count:16(max 125)] RESP: [FC=3 byte-count value-0:16, ...]
+	BufferDynamic rf(10);
+	rf.add(consoleStackPop());
+	rf.add(MODBUS_FC_READ_HOLDING_REGISTERS);
+	rf.addU16_be((uint16_t)consoleStackPop());
+	rf.addU16_be((uint16_t)consoleStackPop());
+	modbusSend(rf);
+}
+
+// Registers
+static void console_cmd_32() {		// ?V
+	const uint8_t idx = consoleStackPop();
+	if (idx < COUNT_REGS)
+		regsPrintValue(idx);
+	else
+		consolePrint(CFMT_C, (console_cell_t)'?');
+}
+static void console_cmd_33() {		// V
+	const uint8_t idx = consoleStackPop(); const uint16_t v = (uint16_t)consoleStackPop();
+	if (idx < COUNT_REGS)
+		regsWrite(idx, v);		// Change is seen by subscribers.
+}
+static void console_cmd_34() {		// ??V
+	fori(COUNT_REGS) { regsPrintValue(i); }
+}
+static void console_cmd_35() {		// ???V
+	fori (COUNT_REGS) {
+		consolePrint(CFMT_NL, 0);
+		consolePrint(CFMT_D|CFMT_M_NO_SEP, (console_cell_t)i);
+		consolePrint(CFMT_C, (console_cell_t)':');
+		regsPrintValue(i);
+		consolePrint(CFMT_STR_P, (console_cell_t)regsGetRegisterName(i));
+		consolePrint(CFMT_STR_P, (console_cell_t)regsGetRegisterDescription(i));
+		devWatchdogPat(DEV_WATCHDOG_MASK_MAINLOOP);
+	}
+	consolePrint(CFMT_STR_P, (console_cell_t)regsGetHelpStr());
+}
+static void console_cmd_36() {		// DUMP
+	regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS, (consoleStackTos() > 0));
+	regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS_FAST, (consoleStackPop() > 1));
+}
+static void console_cmd_37() {		// X
+	regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS|REGS_ENABLES_MASK_DUMP_REGS_FAST|REGS_ENABLES_MASK_DUMP_MODBUS_EVENTS, 0);
+	f_regs_stream.period = 0;
+}
+static void console_cmd_38() {		// BMASK
+	const console_cell_t w = consoleStackPop(); const uint16_t m = (uint16_t)consoleStackPop();
+	if ((w < 0) || (w >= (REGS_STREAM_MASK_SIZE + 1) / 2))		// Check the whole cell, else 256 would select word 0.
+		consoleRaise(CONSOLE_RC_ERROR_INDEX_OUT_OF_RANGE);
+	else {
+		const uint8_t widx = (uint8_t)w;
+		f_regs_stream.mask[widx * 2] = (uint8_t)m;
+		if ((widx * 2 + 1) < REGS_STREAM_MASK_SIZE) f_regs_stream.mask[widx * 2 + 1] = (uint8_t)(m >> 8);
+	}
+}
+static void console_cmd_39() {		// BDUMP
+	regs_stream_start(consoleStackPop());
+}
+
+// Scripts
+static void console_cmd_40() {		// RUN
+	console_script_run_named((const char*)consoleStackPop());
+}
+static void console_cmd_41() {		// ?RUN
+	fori (UTILS_ELEMENT_COUNT(CONSOLE_SCRIPTS)) consolePrint(CFMT_STR_P, (console_cell_t)pgm_read_word(&CONSOLE_SCRIPTS[i].name));
+}
+static void console_cmd_42() {		// ES-CLR
+	eeprom_update_byte((uint8_t*)EEPROM_SCRIPT_ADDR, '\0');
+}
+static void console_cmd_43() {		// ES-ADD
+	eeprom_script_add((const char*)consoleStackPop());
+}
+static void console_cmd_44() {		// ES-RUN
+	const console_rc_t rc = consoleScriptRun(EEPROM_SCRIPT_ADDR, eeprom_script_read); if (CONSOLE_RC_OK != rc) consoleRaise(rc);
+}
+static void console_cmd_45() {		// ?ES
+	const uint16_t len = eeprom_script_len();
+	for (uint16_t i = 0; i < len; i += 1) {
+		const char c = eeprom_script_read(EEPROM_SCRIPT_ADDR + i);
+		if ('\r' == c) consolePrint(CFMT_NL, 0); else consolePrint(CFMT_C|CFMT_M_NO_SEP, c);
+	}
+}
+
+// Runtime
+static void console_cmd_46() {		// RESTART
+	while (1) continue;
+}
+static void console_cmd_47() {		// CLI
+	cli();
+}
+static void console_cmd_48() {		// ABORT
+	RUNTIME_ERROR(consoleStackPop());
+}
+static void console_cmd_49() {		// ASSERT
+	ASSERT(consoleStackPop());
+}
+
+// Non-volatile
+static void console_cmd_50() {		// NV-DEFAULT
+	driverNvSetDefaults();
+}
+static void console_cmd_51() {		// NV-W
+	driverNvWrite();
+}
+static void console_cmd_52() {		// NV-R
+	driverNvRead();
+}
+
+// Arduino
+static void console_cmd_53() {		// PIN
+	const uint8_t pin = (uint8_t)consoleStackPop(); digitalWrite(pin, (uint8_t)consoleStackPop());
+}
+static void console_cmd_54() {		// ?PIN
+	consolePrint(CFMT_D, (console_cell_t)digitalRead(consoleStackPop()));
+}
+static void console_cmd_55() {		// PMODE
+	const uint8_t pin = (uint8_t)consoleStackPop(); pinMode(pin, (uint8_t)consoleStackPop());
+}
+static void console_cmd_56() {		// ?T
+	const uint32_t t = millis(); consolePrint(CFMT_U_D, (console_cell_t)&t);
+}
+
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD)
+static const uint8_t CONSOLE_CMDS_DISP[16] PROGMEM = {
+	15, 2, 80, 0, 0, 108, 95, 11, 1, 0, 122, 148, 28, 69, 25, 46
+};
+static const console_cmd_def_t CONSOLE_CMDS_DEFS[55] PROGMEM = {
+	{ 0xa8c7, console_cmd_51 },                   // NV-W
+	{ 0xb87e, console_cmd_25 },                   // ATN
+	{ 0xa8c2, console_cmd_52 },                   // NV-R
+	{ 0x048c, console_cmd_40 },                   // RUN
+	{ 0xda7e, console_cmd_14 },                   // PROF-CLR
+	{ 0xb5f3, console_cmd_33 },                   // V
+	{ 0xdeb2, console_cmd_9 },                    // ?LIM
+	{ 0xa9ad, console_cmd_54 },                   // ?PIN
+	{ 0x40cb, console_cmd_39 },                   // BDUMP
+	{ 0xd00f, console_cmd_1 },                    // CMD
+	{ 0x85d3, console_cmd_34 },                   // ??V
+	{ 0x54d7, console_cmd_44 },                   // ES-RUN
+	{ 0xd063, console_cmd_47 },                   // CLI
+	{ 0x76f9, console_cmd_29 },                   // SEND
+	{ 0x4fe9, console_cmd_36 },                   // DUMP
+	{ 0xb5fd, console_cmd_37 },                   // X
+	{ 0x79e5, console_cmd_27 },                   // ?SL
+	{ 0xd8b7, console_cmd_31 },                   // READ
+	{ 0x688e, console_cmd_56 },                   // ?T
+	{ 0x7998, console_cmd_7 },                    // ?PR
+	{ 0x2f99, console_cmd_18 },                   // EVENT-EX
+	{ 0xf690, console_cmd_28 },                   // SEND-RAW
+	{ 0x3cac, console_cmd_35 },                   // ???V
+	{ 0xfeaf, console_cmd_48 },                   // ABORT
+	{ 0xc7da, console_cmd_15 },                   // ?WDS
+	{ 0xdc88, console_cmd_2 },                    // LED
+	{ 0x7a03, console_cmd_21 },                   // ?TM
+	{ 0x5007, console_cmd_49 },                   // ASSERT
+	{ 0x7c2c, console_cmd_45 },                   // ?ES
+	{ 0x7092, console_cmd_46 },                   // RESTART
+	{ 0xfcdb, console_cmd_50 },                   // NV-DEFAULT
+	{ 0xbcb8, console_cmd_20 },                   // DTM
+	{ 0xddf1, console_cmd_12 },                   // ?LCD
+	{ 0xa8f8, console_cmd_30 },                   // WRITE
+	{ 0x47f1, console_cmd_13 },                   // ?PROF
+	{ 0xc33b, console_cmd_0 },                    // ?VER
+	{ 0x688c, console_cmd_32 },                   // ?V
+	{ 0x8963, console_cmd_42 },                   // ES-CLR
+	{ 0x7335, console_cmd_16 },                   // WDS-CLR
+	{ 0x8a29, console_cmd_17 },                   // EVENT
+	{ 0x728b, console_cmd_11 },                   // BL
+	{ 0xdd37, console_cmd_3 },                    // ?LED
+	{ 0x74c7, console_cmd_8 },                    // PR
+	{ 0x3fbc, console_cmd_22 },                   // ??TM
+	{ 0x1012, console_cmd_53 },                   // PIN
+	{ 0xdb0d, console_cmd_10 },                   // LIM
+	{ 0xcbf3, console_cmd_38 },                   // BMASK
+	{ 0xb5e8, console_cmd_24 },                   // M
+	{ 0xb533, console_cmd_41 },                   // ?RUN
+	{ 0xd17f, console_cmd_19 },                   // CTM
+	{ 0x74fa, console_cmd_26 },                   // SL
+	{ 0x48d6, console_cmd_55 },                   // PMODE
+	{ 0x116f, console_cmd_23 },                   // STM
+	{ 0xa37f, console_cmd_43 },                   // ES-ADD
+	{ 0x6889, console_cmd_6 },                    // ?S
+};
+static bool console_cmds_user(char* cmd) {
+	return consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, 16, CONSOLE_CMDS_DEFS, 55);
+}
+#endif
+
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
+static const uint8_t CONSOLE_CMDS_DISP[12] PROGMEM = {
+	2, 34, 73, 5, 8, 215, 4, 15, 1, 14, 11, 0
+};
+static const console_cmd_def_t CONSOLE_CMDS_DEFS[42] PROGMEM = {
+	{ 0x7c2c, console_cmd_45 },                   // ?ES
+	{ 0x07a2, console_cmd_4 },                    // RLY
+	{ 0x7092, console_cmd_46 },                   // RESTART
+	{ 0xda7e, console_cmd_14 },                   // PROF-CLR
+	{ 0x40cb, console_cmd_39 },                   // BDUMP
+	{ 0xa37f, console_cmd_43 },                   // ES-ADD
+	{ 0x048c, console_cmd_40 },                   // RUN
+	{ 0x48d6, console_cmd_55 },                   // PMODE
+	{ 0xb5f3, console_cmd_33 },                   // V
+	{ 0x7335, console_cmd_16 },                   // WDS-CLR
+	{ 0xf690, console_cmd_28 },                   // SEND-RAW
+	{ 0xa9ad, console_cmd_54 },                   // ?PIN
+	{ 0x688e, console_cmd_56 },                   // ?T
+	{ 0xb87e, console_cmd_25 },                   // ATN
+	{ 0x79e5, console_cmd_27 },                   // ?SL
+	{ 0x76f9, console_cmd_29 },                   // SEND
+	{ 0x74fa, console_cmd_26 },                   // SL
+	{ 0xdc88, console_cmd_2 },                    // LED
+	{ 0x3cac, console_cmd_35 },                   // ???V
+	{ 0x47f1, console_cmd_13 },                   // ?PROF
+	{ 0xc7da, console_cmd_15 },                   // ?WDS
+	{ 0xb21d, console_cmd_5 },                    // ?RLY
+	{ 0xfcdb, console_cmd_50 },                   // NV-DEFAULT
+	{ 0xa8c2, console_cmd_52 },                   // NV-R
+	{ 0xd8b7, console_cmd_31 },                   // READ
+	{ 0xcbf3, console_cmd_38 },                   // BMASK
+	{ 0xfeaf, console_cmd_48 },                   // ABORT
+	{ 0x54d7, console_cmd_44 },                   // ES-RUN
+	{ 0x688c, console_cmd_32 },                   // ?V
+	{ 0x8963, console_cmd_42 },                   // ES-CLR
+	{ 0xb5fd, console_cmd_37 },                   // X
+	{ 0x4fe9, console_cmd_36 },                   // DUMP
+	{ 0xdd37, console_cmd_3 },                    // ?LED
+	{ 0xc33b, console_cmd_0 },                    // ?VER
+	{ 0xd063, console_cmd_47 },                   // CLI
+	{ 0x85d3, console_cmd_34 },                   // ??V
+	{ 0xa8c7, console_cmd_51 },                   // NV-W
+	{ 0x1012, console_cmd_53 },                   // PIN
+	{ 0x5007, console_cmd_49 },                   // ASSERT
+	{ 0xa8f8, console_cmd_30 },                   // WRITE
+	{ 0xb533, console_cmd_41 },                   // ?RUN
+	{ 0xb5e8, console_cmd_24 },                   // M
+};
+static bool console_cmds_user(char* cmd) {
+	return consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, 12, CONSOLE_CMDS_DEFS, 42);
+}
+#endif
+
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR)
+static const uint8_t CONSOLE_CMDS_DISP[12] PROGMEM = {
+	8, 0, 1, 28, 19, 51, 0, 3, 5, 27, 18, 2
+};
+static const console_cmd_def_t CONSOLE_CMDS_DEFS[40] PROGMEM = {
+	{ 0xf690, console_cmd_28 },                   // SEND-RAW
+	{ 0xda7e, console_cmd_14 },                   // PROF-CLR
+	{ 0xb5fd, console_cmd_37 },                   // X
+	{ 0xa37f, console_cmd_43 },                   // ES-ADD
+	{ 0x048c, console_cmd_40 },                   // RUN
+	{ 0xdd37, console_cmd_3 },                    // ?LED
+	{ 0x74fa, console_cmd_26 },                   // SL
+	{ 0x8963, console_cmd_42 },                   // ES-CLR
+	{ 0xb5f3, console_cmd_33 },                   // V
+	{ 0x40cb, console_cmd_39 },                   // BDUMP
+	{ 0x7335, console_cmd_16 },                   // WDS-CLR
+	{ 0xb5e8, console_cmd_24 },                   // M
+	{ 0x48d6, console_cmd_55 },                   // PMODE
+	{ 0x5007, console_cmd_49 },                   // ASSERT
+	{ 0x7092, console_cmd_46 },                   // RESTART
+	{ 0x85d3, console_cmd_34 },                   // ??V
+	{ 0xb533, console_cmd_41 },                   // ?RUN
+	{ 0x688c, console_cmd_32 },                   // ?V
+	{ 0xa9ad, console_cmd_54 },                   // ?PIN
+	{ 0xdc88, console_cmd_2 },                    // LED
+	{ 0x7c2c, console_cmd_45 },                   // ?ES
+	{ 0xd8b7, console_cmd_31 },                   // READ
+	{ 0xc7da, console_cmd_15 },                   // ?WDS
+	{ 0x76f9, console_cmd_29 },                   // SEND
+	{ 0xd063, console_cmd_47 },                   // CLI
+	{ 0xfcdb, console_cmd_50 },                   // NV-DEFAULT
+	{ 0x688e, console_cmd_56 },                   // ?T
+	{ 0xa8f8, console_cmd_30 },                   // WRITE
+	{ 0xb87e, console_cmd_25 },                   // ATN
+	{ 0xa8c2, console_cmd_52 },                   // NV-R
+	{ 0x4fe9, console_cmd_36 },                   // DUMP
+	{ 0xcbf3, console_cmd_38 },                   // BMASK
+	{ 0x1012, console_cmd_53 },                   // PIN
+	{ 0x3cac, console_cmd_35 },                   // ???V
+	{ 0x79e5, console_cmd_27 },                   // ?SL
+	{ 0x54d7, console_cmd_44 },                   // ES-RUN
+	{ 0xa8c7, console_cmd_51 },                   // NV-W
+	{ 0xfeaf, console_cmd_48 },                   // ABORT
+	{ 0x47f1, console_cmd_13 },                   // ?PROF
+	{ 0xc33b, console_cmd_0 },                    // ?VER
+};
+static bool console_cmds_user(char* cmd) {
+	return consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, 12, CONSOLE_CMDS_DEFS, 40);
+}
+#endif
+
+#endif   // CONSOLE_CMDS_H__
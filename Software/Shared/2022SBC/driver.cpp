@@ -9,6 +9,8 @@
 #include "console.h"
 #include "driver.h"
 #include "sbc2022_modbus.h"
+#include "modbus_rbe.h"
+#include "driver_tables.h"
 FILENUM(2);
 
 void driverTimingDebug(uint8_t id, uint8_t s) {
@@ -23,6 +25,7 @@ void driverTimingDebug(uint8_t id, uint8_t s) {
 }
 
 static constexpr uint8_t MAX_MODBUS_FRAME_SIZE = 20;
+static constexpr uint32_t MODBUS_BAUDRATE = 38400UL;
 
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
 
@@ -88,8 +91,26 @@ static void init_fault_timer() { // Assumes fault flags are all cleared already.
 //
 
 // Build two different versions of MODBUS register read/write depending on product.
+#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR) || (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
+UTILS_STATIC_ASSERT(SBC2022_MODBUS_REGISTER_WDOG_STATS + DEV_WATCHDOG_LOOP_HIST_BUCKETS <= SBC2022_MODBUS_REGISTER_WDOG_STATS_MAX_GAP);
+static bool read_wdog_stats_register(uint16_t address, uint16_t* value) {
+	if ((address < SBC2022_MODBUS_REGISTER_WDOG_STATS) || (address >= SBC2022_MODBUS_REGISTER_WDOG_STATS_MAX_GAP + DEV_WATCHDOG_MASK_COUNT))
+		return false;
+	dev_watchdog_stats_t stats;
+	devWatchdogStatsGet(&stats);
+	if (address < SBC2022_MODBUS_REGISTER_WDOG_STATS + DEV_WATCHDOG_LOOP_HIST_BUCKETS)
+		*value = stats.loop_hist[address - SBC2022_MODBUS_REGISTER_WDOG_STATS];
+	else if (address < SBC2022_MODBUS_REGISTER_WDOG_STATS_MAX_GAP)
+		*value = 0;
+	else
+		*value = (uint16_t)utilsLimitMaxU32(stats.max_gap_us[address - SBC2022_MODBUS_REGISTER_WDOG_STATS_MAX_GAP] / 1000UL, UINT16_MAX);
+	return true;
+}
+#endif
+
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR
 
+static uint16_t tilt_sample_age_ms();
 static uint8_t read_holding_register(uint16_t address, uint16_t* value) {
 	if (address < COUNT_REGS) {
 		*value = REGS[address];
@@ -110,6 +131,12 @@ static uint8_t read_holding_register(uint16_t address, uint16_t* value) {
 		last = REGS[REGS_IDX_ACCEL_SAMPLE_COUNT];
 		return 0;
 	}
+	if (SBC2022_MODBUS_REGISTER_SENSOR_SAMPLE_AGE == address) {
+		*value = tilt_sample_age_ms();
+		return 0;
+	}
+	if (read_wdog_stats_register(address, value))
+		return 0;
 	*value = (uint16_t)-1;
 	return 1;
 }
@@ -117,6 +144,31 @@ static uint8_t write_holding_register(uint16_t address, uint16_t value) {
 	return 1;
 }
 
+/* Tilt, status, sample count & age can be read by exception. Tilt is reported when it moves by more than a deadband, status & age on any change,
+	and the sample count only in a full report. As reading the sample count resets it, it is only read for a full report, so it is the count
+	since the last full report. Returns false if the request is not for this block. */
+static modbus_rbe_t f_rbe;
+static bool read_holding_registers_rbe(const BufferDynamic& request, BufferDynamic& resp) {
+	const uint16_t address = request.getU16_be(MODBUS_FRAME_IDX_DATA);
+	const uint16_t count   = request.getU16_be(MODBUS_FRAME_IDX_DATA + 2);
+	const uint16_t deadbands[] = { REGS[REGS_IDX_TILT_RBE_DEADBAND], 0U, UINT16_MAX, 0U };
+	if ((SBC2022_MODBUS_REGISTER_SENSOR_RBE != address) || (count > UTILS_ELEMENT_COUNT(deadbands)))
+		return false;
+
+	const uint8_t sample_count_idx = SBC2022_MODBUS_REGISTER_SENSOR_SAMPLE_COUNT - SBC2022_MODBUS_REGISTER_SENSOR_TILT;
+	uint16_t values[UTILS_ELEMENT_COUNT(deadbands)];
+	fori (count) {
+		if (sample_count_idx == i)		// Never changed as deadband is UINT16_MAX, read below if in a full report.
+			values[i] = f_rbe.reported[i];
+		else
+			read_holding_register((uint16_t)(SBC2022_MODBUS_REGISTER_SENSOR_TILT + i), &values[i]);
+	}
+	const uint16_t mask = modbusRbeChanges(&f_rbe, values, deadbands, (uint8_t)count, REGS[REGS_IDX_TILT_RBE_MAX_SILENCE_MS]);
+	if (mask & _BV(sample_count_idx))
+		read_holding_register(SBC2022_MODBUS_REGISTER_SENSOR_SAMPLE_COUNT, &values[sample_count_idx]);
+	return modbusRbeBuildResponse(&f_rbe, resp, request, values, (uint8_t)count, mask);
+}
+
 #elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY
 
 static uint8_t read_holding_register(uint16_t address, uint16_t* value) {
@@ -128,6 +180,8 @@ static uint8_t read_holding_register(uint16_t address, uint16_t* value) {
 		*value = (uint8_t)REGS[REGS_IDX_RELAYS];
 		return 0;
 	}
+	if (read_wdog_stats_register(address, value))
+		return 0;
 	*value = (uint16_t)-1;
 	return 1;
 }
@@ -161,6 +215,12 @@ static void do_handle_modbus_cb(uint8_t evt) {
 				}
 			} break;
 			case MODBUS_FC_READ_HOLDING_REGISTERS: { // REQ: [ID FC=3 addr:16 count:16(max 125)] RESP: [ID FC=3 byte-count value-0:16, ...]
+#if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR
+				if ((8 == frame.len()) && read_holding_registers_rbe(frame, response)) {
+					modbusSend(response);
+					break;
+				}
+#endif
 				if (8 == frame.len()) {
 					uint16_t address = frame.getU16_be(MODBUS_FRAME_IDX_DATA);
 					uint16_t count   = frame.getU16_be(MODBUS_FRAME_IDX_DATA + 2);
@@ -183,11 +243,18 @@ static void do_handle_modbus_cb(uint8_t evt) {
 
 #elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
 
-/* We have CFG_TILT_SENSOR_COUNT Sensors and one Relay slave. The operations on these are:
+/* We have a roster of CFG_SLAVE_RELAY_COUNT Relays and CFG_SLAVE_SENSOR_COUNT Sensors. The operations on these are:
 	* Send a request.
 	* Handle response, which may have a status code.
 	* If no response, log a timeout, which is handled later.
-   So we define these in a table rather than a lump of code. */
+   So we define these in a table with an entry for each kind of slave rather than a lump of code. Slaves of a kind have consecutive IDs and use
+   consecutive registers from blocks allocated by mk_regs.py. */
+UTILS_STATIC_ASSERT((CFG_SLAVE_SENSOR_COUNT >= CFG_TILT_SENSOR_COUNT) && (CFG_SLAVE_SENSOR_COUNT <= SBC2022_MODBUS_SLAVE_COUNT_SENSOR));
+UTILS_STATIC_ASSERT((CFG_SLAVE_RELAY_COUNT >= 1) && (CFG_SLAVE_RELAY_COUNT <= SBC2022_MODBUS_SLAVE_COUNT_RELAY));
+UTILS_STATIC_ASSERT((REGS_BLOCK_COUNT_TILT_SENSOR >= CFG_SLAVE_SENSOR_COUNT) && (REGS_BLOCK_COUNT_SENSOR_STATUS >= CFG_SLAVE_SENSOR_COUNT) &&
+  (REGS_BLOCK_COUNT_SENSOR_FAULTS >= CFG_SLAVE_SENSOR_COUNT) && (REGS_BLOCK_COUNT_SENSOR_AGE >= CFG_SLAVE_SENSOR_COUNT));
+UTILS_STATIC_ASSERT((REGS_BLOCK_COUNT_RELAY_STATUS >= CFG_SLAVE_RELAY_COUNT) && (REGS_BLOCK_COUNT_RELAY_FAULTS >= CFG_SLAVE_RELAY_COUNT) &&
+  (REGS_BLOCK_COUNT_RELAY_STATE >= CFG_SLAVE_RELAY_COUNT));
 
 /* Helper to handle setting a new status. It counts errors when they transition from good to error, or from error to a different error.
 	No need to call it when setting a known good status. */
@@ -199,8 +266,8 @@ static void set_slave_status(uint8_t regs_idx_status, uint8_t new_status, uint8_
 	}
 }
 
-// Construct a request for the given MODBUS slave ID.
-typedef void (*build_slave_request_func)(BufferDynamic& f_request, uint8_t modbus_id);
+// Construct a request for the given MODBUS slave ID, which is slave idx of its kind.
+typedef void (*build_slave_request_func)(BufferDynamic& f_request, uint8_t modbus_id, uint8_t idx);
 
 // Handle a response for the given index, returns true on success
 typedef bool (*handle_slave_response_func)(const BufferDynamic& f_response, const BufferDynamic& f_request, uint8_t idx);
@@ -211,37 +278,72 @@ typedef void (*set_error_func)(uint8_t idx);
 //Check if the device is enabled
 typedef bool (*is_enabled_func)(uint8_t idx);
 
-static void build_request_relay(BufferDynamic& f_request, uint8_t modbus_id) {
+static void build_request_relay(BufferDynamic& f_request, uint8_t modbus_id, uint8_t idx) {
 	f_request.add(modbus_id);
 	f_request.add(MODBUS_FC_WRITE_SINGLE_REGISTER);
 	f_request.addU16_be(SBC2022_MODBUS_REGISTER_RELAY);
-	f_request.addU16_be(REGS[REGS_IDX_RELAY_STATE]);
+	f_request.addU16_be(REGS[REGS_IDX_RELAY_STATE_0 + idx]);
 }
 static bool handle_response_relay(const BufferDynamic& f_response, const BufferDynamic& f_request, uint8_t idx) {
-	(void)idx;		// Not used, only one Relay.
 	// REQ: [ID FC=6 addr:16 value:16] -- RESP: [ID FC=6 addr:16 value:16]
 	if ((8 == f_response.len()) && (MODBUS_FC_WRITE_SINGLE_REGISTER == f_response[MODBUS_FRAME_IDX_FUNCTION])) {
 		uint16_t address = f_request.getU16_be(MODBUS_FRAME_IDX_DATA);
 		if (SBC2022_MODBUS_REGISTER_RELAY == address) {
-			set_slave_status(REGS_IDX_RELAY_STATUS, SBC2022_MODBUS_STATUS_SLAVE_OK, REGS_IDX_RELAY_FAULTS);
+			set_slave_status(REGS_IDX_RELAY_STATUS_0 + idx, SBC2022_MODBUS_STATUS_SLAVE_OK, REGS_IDX_RELAY_0_FAULTS + idx);
 			return true;
 		}
 	}
 	return false;
 }
 static void set_error_relay(uint8_t idx) {
-	set_slave_status(REGS_IDX_RELAY_STATUS, SBC2022_MODBUS_STATUS_SLAVE_NO_RESPONSE, REGS_IDX_RELAY_FAULTS);
+	set_slave_status(REGS_IDX_RELAY_STATUS_0 + idx, SBC2022_MODBUS_STATUS_SLAVE_NO_RESPONSE, REGS_IDX_RELAY_0_FAULTS + idx);
 }
 static bool is_enabled_relay(uint8_t idx) { return true; }
 
-static void build_request_sensor(BufferDynamic& f_request, uint8_t modbus_id) {
+/* Each Sensor reports the age of its tilt when it sends the response. We add the time for the response to get to us, and record the time that
+	the Sensor sampled the tilt, so that the age can be updated when it is used. An unknown age, e.g. from older Sensor firmware that returns
+	65535 for an unknown register, is recorded as being too old to be used. */
+static struct {
+	uint32_t sample_ms[CFG_SLAVE_SENSOR_COUNT];		// millis() when Sensor sampled tilt.
+	uint16_t age_rx[CFG_SLAVE_SENSOR_COUNT];		// Age last received from Sensor, for reads by exception where it is not always sent.
+} f_sensor_age;
+static void sensor_age_update(const BufferDynamic& f_response, uint8_t idx, uint16_t age) {
+	f_sensor_age.age_rx[idx] = age;
+	// Response time on the bus with 10 bits per character, plus 3.5 characters of silence before the driver sees the end of the frame.
+	const uint32_t latency_ms = ((uint32_t)f_response.len() * 10U + 35U) * 1000UL / MODBUS_BAUDRATE;
+	f_sensor_age.sample_ms[idx] = millis() - ((UINT16_MAX == age) ? (uint32_t)UINT16_MAX : (age + latency_ms));
+}
+static uint16_t sensor_age_get(uint8_t idx) {
+	return (uint16_t)utilsLimitMaxU32(millis() - f_sensor_age.sample_ms[idx], UINT16_MAX);
+}
+
+/* Sensors may be read by exception, see modbus_rbe.h, for tilt, status & age, and the sample count in a full report. A Sensor in a fault state
+	is read in full, so that the values are all fresh when it recovers, rather than waiting for the Sensor to send a full report. */
+static constexpr uint8_t SENSOR_READ_COUNT = 4;
+static void build_request_sensor(BufferDynamic& f_request, uint8_t modbus_id, uint8_t idx) {
 	f_request.add(modbus_id);
 	f_request.add(MODBUS_FC_READ_HOLDING_REGISTERS);
+	if ((REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_SENSOR_RBE) && !isSlaveStatusFault(REGS[REGS_IDX_SENSOR_STATUS_0 + idx])) {
+		f_request.addU16_be(SBC2022_MODBUS_REGISTER_SENSOR_RBE);
+		f_request.addU16_be(SENSOR_READ_COUNT);
+		return;
+	}
 	f_request.addU16_be(SBC2022_MODBUS_REGISTER_SENSOR_TILT);
-	// TODO: only need two registers here, but we request 3 for debugging.
-	f_request.addU16_be(3);
+	// TODO: only need tilt, status & age here, but we request the sample count as well for debugging.
+	f_request.addU16_be(SENSOR_READ_COUNT);
 }
 static bool handle_response_sensor(const BufferDynamic& f_response, const BufferDynamic& f_request, uint8_t idx) {
+	if (SBC2022_MODBUS_REGISTER_SENSOR_RBE == f_request.getU16_be(MODBUS_FRAME_IDX_DATA)) {	// Only changed values are sent.
+		uint16_t values[SENSOR_READ_COUNT] = { REGS[REGS_IDX_TILT_SENSOR_0 + idx], REGS[REGS_IDX_SENSOR_STATUS_0 + idx], 0U, f_sensor_age.age_rx[idx] };
+		uint16_t mask;
+		if (!modbusRbeParseResponse(f_response, SENSOR_READ_COUNT, values, &mask))
+			return false;
+		REGS[REGS_IDX_TILT_SENSOR_0 + idx] = (regs_t)values[0];
+		set_slave_status(REGS_IDX_SENSOR_STATUS_0 + idx, values[1], REGS_IDX_SENSOR_0_FAULTS + idx);
+		sensor_age_update(f_response, idx, values[3]);
+		return true;
+	}
+
 // REQ: [ID FC=3 addr:16 count:16(max 125)] RESP: [ID FC=3 byte-count value-0:16, ...]
 	if (MODBUS_FC_READ_HOLDING_REGISTERS == f_response[MODBUS_FRAME_IDX_FUNCTION]) {
 		uint16_t address = f_request.getU16_be(MODBUS_FRAME_IDX_DATA); // Get register address from request frame.
@@ -252,6 +354,7 @@ static bool handle_response_sensor(const BufferDynamic& f_response, const Buffer
 				REGS[REGS_IDX_TILT_SENSOR_0 + idx] = (regs_t)(tilt);
 				set_slave_status(REGS_IDX_SENSOR_STATUS_0 + idx, f_response.getU16_be(MODBUS_FRAME_IDX_DATA + 1 + 2),
 				  REGS_IDX_SENSOR_0_FAULTS + idx);
+				sensor_age_update(f_response, idx, (byte_count >= 8) ? f_response.getU16_be(MODBUS_FRAME_IDX_DATA + 1 + 6) : UINT16_MAX);
 				return true;
 			}
 		}
@@ -267,10 +370,12 @@ static bool is_enabled_sensor(uint8_t idx) {
 }
 
 typedef struct {
-	uint8_t modbus_id;
-	uint8_t idx;	// Used to share action functions between similar slaves.
-	uint8_t regs_idx_status;	//	Status register index in REGS.
-	uint16_t fault_flags_mask;	// mask in FAULT_FLAGS reg.
+	uint8_t modbus_id;			// ID of first slave of this kind.
+	uint8_t count;				// Number of slaves of this kind in the roster.
+	uint8_t required;			// Slaves below this index are used by the app, so they are faulty when offline. Others are just absent.
+	uint8_t regs_idx_status;	// First status register index in REGS.
+	uint16_t fault_flags_mask;	// Mask in FLAGS reg for first slave...
+	bool fault_flag_each;		// ...and set if the mask is shifted left for each slave, else all slaves share it.
 	build_slave_request_func build_request;
 	handle_slave_response_func handle_response;
 	set_error_func set_error;
@@ -278,27 +383,42 @@ typedef struct {
 } SlaveDef;
 static const SlaveDef PROGMEM SLAVES[] = {
 	{
-		SBC2022_MODBUS_SLAVE_ID_RELAY, 0, REGS_IDX_RELAY_STATUS, REGS_FLAGS_MASK_FAULT_RELAY,
+		SBC2022_MODBUS_SLAVE_ID_RELAY, CFG_SLAVE_RELAY_COUNT, 1, REGS_IDX_RELAY_STATUS_0, REGS_FLAGS_MASK_FAULT_RELAY, false,
 		build_request_relay, handle_response_relay,
 		set_error_relay, is_enabled_relay,
 	},
 	{
-		SBC2022_MODBUS_SLAVE_ID_SENSOR_0, 0, REGS_IDX_SENSOR_STATUS_0, REGS_FLAGS_MASK_FAULT_SENSOR_0,
-		build_request_sensor, handle_response_sensor,
-		set_error_sensor, is_enabled_sensor,
-	},
-	{
-		SBC2022_MODBUS_SLAVE_ID_SENSOR_0 + 1, 1, REGS_IDX_SENSOR_STATUS_1, REGS_FLAGS_MASK_FAULT_SENSOR_1,
+		SBC2022_MODBUS_SLAVE_ID_SENSOR_0, CFG_SLAVE_SENSOR_COUNT, CFG_TILT_SENSOR_COUNT, REGS_IDX_SENSOR_STATUS_0, REGS_FLAGS_MASK_FAULT_SENSOR_0, true,
 		build_request_sensor, handle_response_sensor,
 		set_error_sensor, is_enabled_sensor,
 	},
 };
-UTILS_STATIC_ASSERT(UTILS_ELEMENT_COUNT(SLAVES) == (CFG_TILT_SENSOR_COUNT+1));
 
-static int8_t get_slave_def(uint8_t modbus_id) {
+// Slaves in the roster are indexed with the Relays first, then the Sensors, so the schedule is in the same order as before there were many.
+static constexpr uint8_t SLAVE_COUNT = CFG_SLAVE_RELAY_COUNT + CFG_SLAVE_SENSOR_COUNT;
+UTILS_STATIC_ASSERT(SLAVE_COUNT <= 16);		// One bit each in SLAVES_ONLINE register.
+
+// Return the definition for a slave in the roster, and set the index of the slave within its kind.
+static const SlaveDef* get_slave_def(uint8_t slave_idx, uint8_t* idx) {
+	ASSERT(slave_idx < SLAVE_COUNT);
+	const SlaveDef* slave_def = SLAVES;
+	while (slave_idx >= pgm_read_byte(&slave_def->count)) {
+		slave_idx -= pgm_read_byte(&slave_def->count);
+		slave_def += 1;
+	}
+	*idx = slave_idx;
+	return slave_def;
+}
+
+// Return the roster index of a slave from its MODBUS ID, or -1 if not in the roster.
+static int8_t get_slave_idx(uint8_t modbus_id) {
+	uint8_t slave_idx = 0U;
 	fori (UTILS_ELEMENT_COUNT(SLAVES)) {
-		if (pgm_read_byte(&SLAVES[i].modbus_id) == modbus_id)
-			return i;
+		const uint8_t idx = (uint8_t)(modbus_id - pgm_read_byte(&SLAVES[i].modbus_id));	// Wraps to a large value for IDs below the first.
+		const uint8_t count = pgm_read_byte(&SLAVES[i].count);
+		if (idx < count)
+			return slave_idx + idx;
+		slave_idx += count;
 	}
 	return -1;
 }
@@ -307,7 +427,7 @@ static int8_t get_slave_def(uint8_t modbus_id) {
 
 	The slaves are sent requests regularly on a schedule with a window allowed for a reply.
 	Each slave has a counter that is incremented when a request is sent. The counter is cleared
-	when a response was received.
+	when a response was received. The counters are kept by poll_backoff.cpp.
 	If the counter reaches a threshold then the slave goes to error state.
 	These counters are not in registers as they change very quickly so there is no point
 	allowing the console to read them.
@@ -316,16 +436,54 @@ static int8_t get_slave_def(uint8_t modbus_id) {
 	read via the MODBUS response, or a code indicating no comms.
 	The schedule for each slave sets this status to no comms when the request counter reaches the
 	threshold.
+
+	A slave that reaches the threshold is backed off and goes offline, and the schedule then skips it so that missing slaves do not cost bus
+	time. A discovery scan probes at most one offline slave on each pass of the schedule, with each offline slave probed after 1, 2, 4...
+	passes up to a limit, so a dead slave costs very little. Any response puts the slave back online and back to a request on every pass. The
+	online slaves are in register SLAVES_ONLINE.
 */
+#include "poll_backoff.h"
 
 static struct {
-	uint8_t error_counts[CFG_TILT_SENSOR_COUNT + 1];
+	poll_backoff_t backoff[SLAVE_COUNT];
+	uint8_t probe_idx;						// Last slave probed.
+	uint8_t pending_id;						// MODBUS ID of slave whose response ends the current slot, zero for none.
 	bool schedule_done;
 } f_slave_status;
 
-static void slave_record_response_ok(uint8_t slave_idx) { f_slave_status.error_counts[slave_idx] = 0U; }
-static void slave_record_request_sent(uint8_t slave_idx) { if (f_slave_status.error_counts[slave_idx] < 255) f_slave_status.error_counts[slave_idx] += 1; }
-static bool slave_too_many_errors(uint8_t slave_idx) { return f_slave_status.error_counts[slave_idx] > REGS[REGS_IDX_MAX_SLAVE_ERRORS]; }
+static bool slave_is_online(uint8_t slave_idx) { return !!(REGS[REGS_IDX_SLAVES_ONLINE] & ((regs_t)1U << slave_idx)); }
+static void slave_set_online(uint8_t slave_idx, bool online) {
+	if (regsWriteMask(REGS_IDX_SLAVES_ONLINE, (regs_t)1U << slave_idx, online)) {
+		uint8_t idx;
+		const SlaveDef* slave_def = get_slave_def(slave_idx, &idx);
+		eventPublish(online ? EV_SLAVE_ONLINE : EV_SLAVE_OFFLINE, pgm_read_byte(&slave_def->modbus_id) + idx);
+	}
+}
+
+/* Select an offline slave to probe on this pass, or return -1 if none are due. The search starts after the last slave probed so that all
+	are probed in turn. Counts down the wait for all offline slaves, so it must be called exactly once per pass. */
+static int8_t slave_select_probe() {
+	int8_t probe_idx = -1;
+	fori (SLAVE_COUNT) {
+		const uint8_t slave_idx = (uint8_t)((f_slave_status.probe_idx + 1U + i) % SLAVE_COUNT);
+		if (!slave_is_online(slave_idx) && pollBackoffIsDue(&f_slave_status.backoff[slave_idx]) && (probe_idx < 0))
+			probe_idx = (int8_t)slave_idx;
+	}
+	if (probe_idx >= 0)
+		f_slave_status.probe_idx = (uint8_t)probe_idx;
+	return probe_idx;
+}
+
+static uint8_t max_slave_errors() { return (uint8_t)utilsLimitMax<regs_t>(REGS[REGS_IDX_MAX_SLAVE_ERRORS], UINT8_MAX); }
+static void slave_record_response_ok(uint8_t slave_idx) {
+	(void)pollBackoffResponse(&f_slave_status.backoff[slave_idx], max_slave_errors());
+	slave_set_online(slave_idx, true);
+}
+static void slave_record_request_sent(uint8_t slave_idx) {
+	pollBackoffSent(&f_slave_status.backoff[slave_idx], max_slave_errors(),
+	  (uint8_t)utilsLimitMax<regs_t>(REGS[REGS_IDX_SLAVE_PROBE_BACKOFF_MAX], POLL_BACKOFF_MAX));
+}
+static bool slave_too_many_errors(uint8_t slave_idx) { return pollBackoffIsBackedOff(&f_slave_status.backoff[slave_idx], max_slave_errors()); }
 
 static void set_schedule_done() { f_slave_status.schedule_done = true; }
 bool driverSensorUpdateAvailable() { const bool f = f_slave_status.schedule_done; f_slave_status.schedule_done = false; return f; }
@@ -337,49 +495,79 @@ static bool is_slave_faulty(uint8_t regs_idx_status) {
 
 #include "thread.h"
 
-/* This code reads all sensors and writes to the relay, then decides if there is an error condition that should be flagged upwards.
+/* This code reads all sensors and writes to the relays, then decides if there is an error condition that should be flagged upwards.
  * Any slave can just not reply, or the response can be garbled. Additionally a Sensor can be in error if something goes awry with the accelerometer.
  * MODBUS errors are normally transient, so they are ignored until there are more than a set number in a row.
+ * Each online slave gets a slot of up to SLAVE_QUERY_PERIOD ms, plus one more if an offline slave is probed. A slot ends early when the
+ * response arrives, as the MODBUS callback wakes the thread, so only a slave that does not respond costs the whole slot. A slave that stops
+ * responding costs a whole slot on each pass until it goes offline, then only when it is probed. The time for a pass is the worst case delay
+ * from the app setting the relays to the Relay seeing them. See the host simulation in Sargood/sim for the timing with more slaves.
  */
 static constexpr uint16_t SLAVE_QUERY_PERIOD = 12U;
+static thread_sched_tcb_t tcb_query_slaves;
 
 static int8_t thread_query_slaves(void* arg) {
 	static BufferDynamic req(MAX_MODBUS_FRAME_SIZE);
 
 	THREAD_BEGIN();
 	while (1) {
-		static uint8_t slave_idx;
-
-		// Read from all slaves...
-		for (slave_idx = 0; slave_idx < UTILS_ELEMENT_COUNT(SLAVES); slave_idx += 1) {
+		static uint8_t slot;			// Slot for each slave in the roster, then one for the discovery scan.
+		static uint8_t query_count;
+
+		// Read from all online slaves, then probe an offline slave if one is due...
+		query_count = 0U;
+		for (slot = 0; slot <= SLAVE_COUNT; slot += 1) {
+			const int8_t slave_idx = (slot < SLAVE_COUNT) ? (slave_is_online(slot) ? (int8_t)slot : -1) : slave_select_probe();
+			if (slave_idx < 0)
+				continue;
+			query_count += 1;
 			THREAD_START_DELAY();
-			const SlaveDef* const slave_def = &SLAVES[slave_idx];
-			const uint8_t slave_id = pgm_read_byte(&slave_def->modbus_id);
+			uint8_t idx;
+			const SlaveDef* const slave_def = get_slave_def((uint8_t)slave_idx, &idx);
+			const uint8_t slave_id = pgm_read_byte(&slave_def->modbus_id) + idx;
 			const build_slave_request_func build_request = reinterpret_cast<const build_slave_request_func>(pgm_read_ptr(&slave_def->build_request));
 			req.clear();
-			build_request(req, slave_id);
-			slave_record_request_sent(slave_idx);
+			build_request(req, slave_id, idx);
+			slave_record_request_sent((uint8_t)slave_idx);
 			if (!(REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_SLAVE_UPDATE_DISABLE)) {
 				THREAD_WAIT_UNTIL(!modbusIsBusyBus());
+				f_slave_status.pending_id = req[MODBUS_FRAME_IDX_SLAVE_ID];
 				modbusSend(req);
 			}
-			THREAD_WAIT_UNTIL(THREAD_IS_DELAY_DONE(SLAVE_QUERY_PERIOD));
+			THREAD_SLEEP_UNTIL_DELAY_DONE(SLAVE_QUERY_PERIOD);		// Woken early by a response.
+			f_slave_status.pending_id = 0U;
+		}
+		if (0U == query_count) {		// All offline & none due for a probe, so wait a slot rather than spin.
+			THREAD_START_DELAY();
+			THREAD_SLEEP_UNTIL_DELAY_DONE(SLAVE_QUERY_PERIOD);
 		}
 
 		// Should have all responses or timeouts by now so check all used and enabled slaves for fault state.
 		driverTimingDebug(TIMING_DEBUG_EVENT_QUERY_SCHEDULE_START, true);
-		fori (UTILS_ELEMENT_COUNT(SLAVES)) {
-			const SlaveDef* slave_def = &SLAVES[i];
-			const uint8_t idx = pgm_read_byte(&slave_def->idx);
+		regs_t fault_flags_mask = 0U, fault_flags = 0U;
+		fori (SLAVE_COUNT) {
+			uint8_t idx;
+			const SlaveDef* slave_def = get_slave_def(i, &idx);
 			if (slave_too_many_errors(i)) {
 				const set_error_func set_error = reinterpret_cast<const set_error_func>(pgm_read_ptr(&slave_def->set_error));
 				set_error(idx);
+				slave_set_online(i, false);
 			}
 
-			// Update error flags that are used by Command Processor and that drive the Blinky LED.
+			/* Collect error flags that are used by Command Processor and that drive the Blinky LED. A shared flag is set if any slave is faulty.
+				Offline slaves not used by the app are just absent. */
 			const is_enabled_func is_enabled = reinterpret_cast<const is_enabled_func>(pgm_read_ptr(&slave_def->is_enabled));
-			regsWriteMaskFlags(pgm_read_word(&slave_def->fault_flags_mask), (is_enabled(idx) && is_slave_faulty(pgm_read_byte(&slave_def->regs_idx_status))));
+			const regs_t mask = pgm_read_word(&slave_def->fault_flags_mask) << (pgm_read_byte(&slave_def->fault_flag_each) ? idx : 0U);
+			fault_flags_mask |= mask;
+			if (is_enabled(idx) && is_slave_faulty(pgm_read_byte(&slave_def->regs_idx_status) + idx) &&
+			  (slave_is_online(i) || (idx < pgm_read_byte(&slave_def->required))))
+				fault_flags |= mask;
 		}
+		regsUpdateMaskFlags(fault_flags_mask, fault_flags);
+
+		// Age the Sensor tilt values to now, as they are about to be used.
+		fori (CFG_SLAVE_SENSOR_COUNT)
+			REGS[REGS_IDX_SENSOR_AGE_0 + i] = is_slave_faulty(REGS_IDX_SENSOR_STATUS_0 + i) ? UINT16_MAX : sensor_age_get(i);
 
 		set_schedule_done();			// Flag new data available to command thread.
 		REGS[REGS_IDX_UPDATE_COUNT] += 1;
@@ -404,14 +592,18 @@ int8_t driverGetFaultySensor() {
 static void do_handle_modbus_cb(uint8_t evt) {
 	if (MODBUS_CB_EVT_M_RESP_RX == evt) {  // Good response from slave...
 		const BufferDynamic& frame = modbusRxFrame();
-		const int8_t slave_idx = get_slave_def(frame[MODBUS_FRAME_IDX_SLAVE_ID]);	// Do we have a definition?
+		const int8_t slave_idx = get_slave_idx(frame[MODBUS_FRAME_IDX_SLAVE_ID]);	// Is it in the roster?
 		if (slave_idx >= 0) {	// Yes!
-			const SlaveDef* slave_def = &SLAVES[slave_idx];
-			const uint8_t idx = pgm_read_byte(&slave_def->idx);
+			uint8_t idx;
+			const SlaveDef* slave_def = get_slave_def(slave_idx, &idx);
 			const handle_slave_response_func handle_response = reinterpret_cast<const handle_slave_response_func>(pgm_read_ptr(&slave_def->handle_response));
 			if (handle_response(frame, modbusTxFrame(), idx)) 	// Try handling it, return false on failure
 				slave_record_response_ok(slave_idx);
 		}
+		if (frame[MODBUS_FRAME_IDX_SLAVE_ID] == f_slave_status.pending_id) {		// End the slot now, even for a bad response.
+			f_slave_status.pending_id = 0U;
+			threadSchedWake(&tcb_query_slaves);
+		}
 	}
 }
 
@@ -473,7 +665,6 @@ static void modbus_send_buf(const uint8_t* buf, uint8_t sz) {
 	digitalWrite(GPIO_PIN_RS485_TX_EN, LOW);
 }
 
-static constexpr uint32_t MODBUS_BAUDRATE = 38400UL;
 static void modbus_init() {
 	GPIO_SERIAL_RS485.begin(MODBUS_BAUDRATE);
 	digitalWrite(GPIO_PIN_RS485_TX_EN, LOW);
@@ -482,15 +673,19 @@ static void modbus_init() {
 	modbusInit(modbus_send_buf, modbus_recv, MAX_MODBUS_FRAME_SIZE, MODBUS_BAUDRATE, modbus_cb);
 
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY
-	modbusSetSlaveId(SBC2022_MODBUS_SLAVE_ID_RELAY);
+	modbusSetSlaveId(SBC2022_MODBUS_SLAVE_ID_RELAY + utilsLimitMax<regs_t>(REGS[REGS_IDX_RELAY_IDX], SBC2022_MODBUS_SLAVE_COUNT_RELAY - 1));
 #elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR
 	modbusSetSlaveId(SBC2022_MODBUS_SLAVE_ID_SENSOR_0 + (!digitalRead(GPIO_PIN_SEL0)) + 2 * (!digitalRead(GPIO_PIN_SEL1)));
+	modbusRbeInit(&f_rbe);
 #elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
-	fori (SBC2022_MODBUS_SLAVE_COUNT_SENSOR) {
+	fori (CFG_SLAVE_SENSOR_COUNT) {
 		REGS[REGS_IDX_SENSOR_STATUS_0 + i] = SBC2022_MODBUS_STATUS_SLAVE_NO_RESPONSE;
 		REGS[REGS_IDX_TILT_SENSOR_0 + i] = SBC2022_MODBUS_TILT_FAULT;
+		REGS[REGS_IDX_SENSOR_AGE_0 + i] = f_sensor_age.age_rx[i] = UINT16_MAX;
 	}
-	REGS[REGS_IDX_RELAY_STATUS] = SBC2022_MODBUS_STATUS_SLAVE_NO_RESPONSE;
+	fori (CFG_SLAVE_RELAY_COUNT)
+		REGS[REGS_IDX_RELAY_STATUS_0 + i] = SBC2022_MODBUS_STATUS_SLAVE_NO_RESPONSE;
+	REGS[REGS_IDX_SLAVES_ONLINE] = (regs_t)((1UL << SLAVE_COUNT) - 1U);		// Assume all present until they fail to respond.
 #endif
 	modbusSetTimingDebugCb(driverTimingDebug);
 	gpioSp0SetModeOutput();		// These are used by the RS485 debug cb.
@@ -544,14 +739,19 @@ const uint16_t ACCEL_RAW_SAMPLE_RATE_TOLERANCE_PERC = 20;		// Range is nominal +
 //const uint8_t ACCEL_MAX_SAMPLES = 1U << (16 - 10);	// Accelerometer provides 10 bit data.
 
 /* Processing pipeline is:
-	Setup device at data rate in REGS_IDX_ACCEL_DATA_RATE (curr. 400).
-	Accumulate REGS_IDX_ACCEL_AVG samples (curr. 20).
+	Setup device at data rate in REGS_IDX_ACCEL_DATA_RATE_RUN (curr. 400 moving, 100 stationary).
+	Accumulate REGS_IDX_ACCEL_AVG_RUN samples (curr. 20 moving, 40 stationary), so averaged over 50ms moving, 400ms stationary.
 	Compute tilt in ACCEL_TILT_ANGLE low pass filtered with rate set in ACCEL_TILT_FILTER_K, result in REGS_IDX_ACCEL_TILT_ANGLE.
+	The filters run once per averaged sample, so when stationary the filter constants are reduced by log2 of the ratio of the averaging
+	periods, so that the time constants are much the same as when moving.
 
    Motion discrimination is done by a process that runs once a second:
    The tilt value is filtered by a longer time constant filter REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K, result in REGS_IDX_ACCEL_TILT_ANGLE_LP.
    REGS_IDX_TILT_DELTA holds difference between current and last value.
    The delta is compared with +/- REGS_IDX_ACCEL_TILT_MOTION_DISC_THRESHOLD to determine if the tilt is moving up/down or stopped.
+   The data rate & averaging are then set for moving as soon as motion is detected, so that tilt is fresh for a slew, and set back for
+   stationary when the delta has been within REGS_IDX_ACCEL_RATE_STILL_THRESHOLD for REGS_IDX_ACCEL_RATE_STILL_HOLD checks, so that tilt is
+   quieter at rest.
 */
 static struct {
 	int16_t r[3];   				// Accumulators for 3 axes.
@@ -564,6 +764,10 @@ static struct {
 	int32_t tilt_filter_accum;
 	int32_t tilt_motion_disc_filter_accum;
 	int16_t last_tilt;
+	uint32_t sample_ms;				// millis() when tilt was last computed.
+	bool moving;					// Set if using data rate & averaging for moving.
+	uint8_t still_count;			// Motion checks in a row that are within the stationary threshold.
+	uint8_t filter_k_shift;			// Filter constants are reduced by this, zero when moving.
 } f_accel_data;
 
 static void clear_accel_accum() {
@@ -578,7 +782,50 @@ static void tilt_sensor_set_status(bool fault) {
 	}
 }
 
+// Filter constant reduced by the shift for the running averaging period.
+static uint8_t accel_filter_k(regs_t k) {
+	return (uint8_t)((k > f_accel_data.filter_k_shift) ? (k - f_accel_data.filter_k_shift) : 0U);
+}
+// Rescale a filter accumulator, which holds the output scaled by 2^k, from one filter constant to another.
+static void accel_filter_rescale(int32_t* accum, uint8_t k_from, uint8_t k_to) {
+	if (k_to > k_from)
+		*accum *= (int32_t)(1UL << (k_to - k_from));
+	else
+		*accum >>= (k_from - k_to);
+}
+
 ADXL345 adxl = ADXL345(GPIO_PIN_SSEL);				// USE FOR SPI COMMUNICATION, ADXL345(CS_PIN);
+
+// Set data rate & averaging for moving or stationary. Accumulated samples are discarded on a rate change so that rates are not mixed.
+static void accel_set_rate(bool moving) {
+	f_accel_data.moving = moving;
+	REGS[REGS_IDX_ACCEL_AVG_RUN] = REGS[moving ? REGS_IDX_ACCEL_AVG : REGS_IDX_ACCEL_AVG_STILL];
+	const regs_t rate = REGS[moving ? REGS_IDX_ACCEL_DATA_RATE_SET : REGS_IDX_ACCEL_DATA_RATE_STILL];
+	if (rate != REGS[REGS_IDX_ACCEL_DATA_RATE_RUN]) {
+		REGS[REGS_IDX_ACCEL_DATA_RATE_RUN] = rate;
+		adxl.setRate((float)rate);
+		f_accel_data.accel_data_rate_margin = (uint16_t)((uint32_t)rate * (uint32_t)ACCEL_RAW_SAMPLE_RATE_TOLERANCE_PERC / 100);
+		clear_accel_accum();
+		f_accel_data.accum_samples_prev = f_accel_data.raw_sample_counter;
+	}
+
+	// Shift is floor(log2(running averaging period / moving averaging period)), the periods are avg/rate so cross multiply.
+	uint32_t num = (uint32_t)REGS[REGS_IDX_ACCEL_AVG_RUN] * (uint32_t)REGS[REGS_IDX_ACCEL_DATA_RATE_SET];
+	const uint32_t den = utilsLimitMin<uint32_t>((uint32_t)REGS[REGS_IDX_ACCEL_AVG] * (uint32_t)REGS[REGS_IDX_ACCEL_DATA_RATE_RUN], 1U);
+	uint8_t shift = 0U;
+	while ((shift < 8U) && ((num / 2U) >= den)) {
+		num /= 2U;
+		shift += 1U;
+	}
+	if (shift != f_accel_data.filter_k_shift) {		// Rescale filters so that the output does not jump.
+		const uint8_t k_tilt = accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_FILTER_K]);
+		const uint8_t k_disc = accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K]);
+		f_accel_data.filter_k_shift = shift;
+		accel_filter_rescale(&f_accel_data.tilt_filter_accum, k_tilt, accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_FILTER_K]));
+		accel_filter_rescale(&f_accel_data.tilt_motion_disc_filter_accum, k_disc, accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K]));
+	}
+}
+
 static void sensor_accel_init() {
 	adxl.powerOn();									// Power on the ADXL345
 
@@ -590,8 +837,7 @@ static void sensor_accel_init() {
 	adxl.setSpiBit(0);								// Configure the device to be in 4 wire SPI mode when set to '0' or 3 wire SPI mode when set to 1
 													// Default: Set to 1
 													// SPI pins on the ATMega328: 11, 12 and 13 as reference in SPI Library
-	adxl.setRate((float)REGS[REGS_IDX_ACCEL_DATA_RATE_SET]);
- 	f_accel_data.accel_data_rate_margin = (uint16_t)((uint32_t)REGS[REGS_IDX_ACCEL_DATA_RATE_SET] * (uint32_t)ACCEL_RAW_SAMPLE_RATE_TOLERANCE_PERC / 100);
+	accel_set_rate(true);							// Start moving so that tilt is fresh until we know that it is stationary.
 
 	tilt_sensor_set_status(true);					// Start off from fault state.
 }
@@ -600,6 +846,18 @@ static void setup_devices() {
 	sensor_accel_init();
 }
 
+/* Age of the tilt value for the master, which is the time since it was computed, plus the delay of the processing. The average of the raw
+	samples is from the middle of the averaging period, and the tilt filter delays a step by 2^k-1 averaged samples, with k reduced for the
+	running rate. */
+static uint16_t tilt_sample_age_ms() {
+	if (regsFlags() & REGS_FLAGS_MASK_ACCEL_FAIL)
+		return UINT16_MAX;
+	const uint32_t avg_period_ms = (uint32_t)REGS[REGS_IDX_ACCEL_AVG_RUN] * 1000UL / utilsLimitMin<regs_t>(REGS[REGS_IDX_ACCEL_DATA_RATE_RUN], 1U);
+	const uint32_t filter_delay_ms = avg_period_ms / 2U +
+	  avg_period_ms * ((1UL << utilsLimitMax<uint8_t>(accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_FILTER_K]), 8U)) - 1U);
+	return (uint16_t)utilsLimitMaxU32(millis() - f_accel_data.sample_ms + filter_delay_ms, UINT16_MAX);
+}
+
 // Calculate pitch with max value taken from regs. Note that this factor should be 2 * 90deg / pi.
 // Note arg c must be the axis that doesn't change much, else the quadrant correction won't work.
 // TODO: make more robust, maybe if b & c differ in sign do correction.
@@ -626,7 +884,26 @@ static void accel_service_check_sample_rate() {
 	f_accel_data.rate_check_samples_prev = f_accel_data.raw_sample_counter;
 	if (0 != REGS[REGS_IDX_ACCEL_DATA_RATE_TEST])		// Fake sample count for testing.
 		REGS[REGS_IDX_ACCEL_DATA_RATE_MEAS] = REGS[REGS_IDX_ACCEL_DATA_RATE_TEST];
-	tilt_sensor_set_status(!utilsIsInLimit(REGS[REGS_IDX_ACCEL_DATA_RATE_MEAS], REGS[REGS_IDX_ACCEL_DATA_RATE_SET] - f_accel_data.accel_data_rate_margin, REGS[REGS_IDX_ACCEL_DATA_RATE_SET] + f_accel_data.accel_data_rate_margin));
+	tilt_sensor_set_status(!utilsIsInLimit(REGS[REGS_IDX_ACCEL_DATA_RATE_MEAS], REGS[REGS_IDX_ACCEL_DATA_RATE_RUN] - f_accel_data.accel_data_rate_margin, REGS[REGS_IDX_ACCEL_DATA_RATE_RUN] + f_accel_data.accel_data_rate_margin));
+}
+
+/* Switch to moving as soon as motion is detected, or on a fault as the rate may be the cause. Switch to stationary only when the delta has been
+	within a threshold for a number of checks. This runs just after the sample rate check so that the next check is all at the new rate. */
+static void accel_service_adapt_rate() {
+	bool moving = f_accel_data.moving;
+	if ((REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_ACCEL_RATE_FIXED) || (SBC2022_MODBUS_STATUS_SLAVE_OK != REGS[REGS_IDX_ACCEL_TILT_STATUS])) {
+		moving = true;
+		f_accel_data.still_count = 0U;
+	}
+	else if (utilsAbs<int16_t>((int16_t)REGS[REGS_IDX_TILT_DELTA]) <= (int16_t)REGS[REGS_IDX_ACCEL_RATE_STILL_THRESHOLD]) {
+		if (f_accel_data.still_count < UINT8_MAX)
+			f_accel_data.still_count += 1;
+		if (f_accel_data.still_count >= REGS[REGS_IDX_ACCEL_RATE_STILL_HOLD])
+			moving = false;
+	}
+	else
+		f_accel_data.still_count = 0U;
+	accel_set_rate(moving);
 }
 
 void service_devices() {
@@ -646,8 +923,9 @@ void service_devices() {
 				f_accel_data.reset_filter = true;
 			}
 
-			if ((uint16_t)(f_accel_data.raw_sample_counter - f_accel_data.accum_samples_prev) >= REGS[REGS_IDX_ACCEL_AVG]) {	// Check for time to average accumulated readings.
+			if ((uint16_t)(f_accel_data.raw_sample_counter - f_accel_data.accum_samples_prev) >= REGS[REGS_IDX_ACCEL_AVG_RUN]) {	// Check for time to average accumulated readings.
 				REGS[REGS_IDX_ACCEL_SAMPLE_COUNT] += 1;
+				f_accel_data.sample_ms = millis();
 				fori (3)
 					REGS[REGS_IDX_ACCEL_X + i] = (regs_t)f_accel_data.r[i];
 				clear_accel_accum();
@@ -656,10 +934,10 @@ void service_devices() {
 				// Since components are used as a ratio, no need to divide each by counts. Note that the axes are active, quad, inactive.
 				const float tilt_angle = tilt((float)(int16_t)REGS[REGS_IDX_ACCEL_Y], (float)-(int16_t)REGS[REGS_IDX_ACCEL_X], (float)(int16_t)REGS[REGS_IDX_ACCEL_Z]);
 				int16_t tilt_i16 = (int16_t)(0.5 + tilt_angle);
-				REGS[REGS_IDX_ACCEL_TILT_ANGLE] = (regs_t)utilsFilter(&f_accel_data.tilt_filter_accum, tilt_i16, (uint8_t)REGS[REGS_IDX_ACCEL_TILT_FILTER_K], f_accel_data.reset_filter);
+				REGS[REGS_IDX_ACCEL_TILT_ANGLE] = (regs_t)utilsFilter(&f_accel_data.tilt_filter_accum, tilt_i16, accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_FILTER_K]), f_accel_data.reset_filter);
 
 				// Filter tilt value a bit. We do not bother to reset the filter if the filter constant has changed as this will only happen during manual tuning.
-				REGS[REGS_IDX_ACCEL_TILT_ANGLE_LP] = (regs_t)utilsFilter(&f_accel_data.tilt_motion_disc_filter_accum, tilt_i16, (uint8_t)REGS[REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K], f_accel_data.reset_filter);
+				REGS[REGS_IDX_ACCEL_TILT_ANGLE_LP] = (regs_t)utilsFilter(&f_accel_data.tilt_motion_disc_filter_accum, tilt_i16, accel_filter_k(REGS[REGS_IDX_ACCEL_TILT_MOTION_DISC_FILTER_K]), f_accel_data.reset_filter);
 				f_accel_data.reset_filter = false;
 			}
 		}
@@ -670,6 +948,7 @@ void service_devices() {
 	utilsRunEvery(ACCEL_CHECK_PERIOD_MS) {
 		accel_service_check_motion();
 		accel_service_check_sample_rate();
+		accel_service_adapt_rate();
 	}
 }
 
@@ -753,26 +1032,20 @@ static void ir_service() {
 	}
 }
 
-static const uint8_t LED_GAMMA[] PROGMEM = { // https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/
-	0, 0, 0, 1, 1, 2, 2, 3, 4, 5, 6, 8, 9, 11, 13, 14,
-	16, 19, 21, 23, 26, 28, 31, 34, 37, 40, 43, 47, 50, 54, 58, 62,
-	66, 70, 74, 79, 83, 88, 93, 98, 103, 108, 113, 119, 124, 130, 136, 142,
-	148, 154, 161, 167, 174, 180, 187, 194, 201, 209, 216, 224, 231, 239, 247, 255,
-};
 static uint8_t f_lcd_bl_demand, f_lcd_bl_current;
 static void set_lcd_backlight(uint8_t b) {
 	f_lcd_bl_current = b;
 	analogWrite(GPIO_PIN_LCD_BL, 255 - pgm_read_byte(&LED_GAMMA[f_lcd_bl_current]));
 }
-static thread_control_t tcb_query_slaves;
 static void setup_devices() {
 	ir_setup();
-	threadInit(&tcb_query_slaves);
+	threadSchedInit();
+	threadSchedAdd(&tcb_query_slaves, thread_query_slaves, NULL);
 	driverSetLcdBacklight(0);
 }
 static void service_devices() {
 	ir_service();
-	threadRun(&tcb_query_slaves, thread_query_slaves, NULL);
+	threadSchedService();
 }
 void service_devices_50ms() {
 	if (f_lcd_bl_current > f_lcd_bl_demand)
@@ -799,13 +1072,14 @@ static const sw_scan_def_t SWITCHES_DEFS[] PROGMEM = {
 	{ GPIO_PIN_TS_RET, false, switches_action_delay_touch, REGS_FLAGS_MASK_SW_TOUCH_RET, EV_SW_TOUCH_RET },
 };
 static sw_scan_context_t switches_contexts[UTILS_ELEMENT_COUNT(SWITCHES_DEFS)];
+static sw_scan_ports_t switches_ports;	// Switches are read a port at a time and debounced together.
 
 static void switches_setup() {
-	swScanInit(SWITCHES_DEFS, switches_contexts, UTILS_ELEMENT_COUNT(SWITCHES_DEFS));
+	swScanInitPorts(SWITCHES_DEFS, switches_contexts, UTILS_ELEMENT_COUNT(SWITCHES_DEFS), &switches_ports);
 }
 static void switches_service() {
 	if (!(REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_TOUCH_DISABLE))
-		swScanSample(SWITCHES_DEFS, switches_contexts, UTILS_ELEMENT_COUNT(SWITCHES_DEFS));
+		swScanSamplePorts(SWITCHES_DEFS, switches_contexts, UTILS_ELEMENT_COUNT(SWITCHES_DEFS), &switches_ports);
 }
 
 #else
@@ -915,12 +1189,14 @@ static uint8_t nv_init() {
 
 // ADC read.
 //
+// Supply monitor channels are averaged over 16 samples in the ISR, about 1.7ms per channel at 125kHz ADC clock.
+static constexpr uint8_t ADC_OVERSAMPLE_VOLTS_MON = 4;
 const DevAdcChannelDef g_adc_def_list[] PROGMEM = {
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY
-	{ DEV_ADC_REF_AVCC | DEV_ADC_ARD_PIN_TO_CHAN(GPIO_PIN_VOLTS_MON_12V_IN),	&regs_storage[REGS_IDX_ADC_VOLTS_MON_12V_IN],	NULL },
+	{ DEV_ADC_REF_AVCC | DEV_ADC_ARD_PIN_TO_CHAN(GPIO_PIN_VOLTS_MON_12V_IN),	&regs_storage[REGS_IDX_ADC_VOLTS_MON_12V_IN],	NULL,	ADC_OVERSAMPLE_VOLTS_MON },
 #endif
-	{ DEV_ADC_REF_AVCC | DEV_ADC_ARD_PIN_TO_CHAN(GPIO_PIN_VOLTS_MON_BUS),		&regs_storage[REGS_IDX_ADC_VOLTS_MON_BUS],		NULL },
-	{ 0,																		DEV_ADC_RESULT_END,								NULL }
+	{ DEV_ADC_REF_AVCC | DEV_ADC_ARD_PIN_TO_CHAN(GPIO_PIN_VOLTS_MON_BUS),		&regs_storage[REGS_IDX_ADC_VOLTS_MON_BUS],		NULL,	ADC_OVERSAMPLE_VOLTS_MON },
+	{ 0,																		DEV_ADC_RESULT_END,								NULL,	0 }
 };
 
 void adcDriverSetupFunc(void* setup_arg) { /* empty */ }
@@ -935,9 +1211,9 @@ static void adc_start() { devAdcStartConversions(); }
 // Scaling is done by giving scaled output value at 1023 counts.
 static uint16_t scaler_12v_mon(uint16_t raw) {
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
-	return utilsRescaleU16(raw, 1023U, 20151U); // Scales 10 bit ADC with 5V ref and a 10K/3K3 divider. So 13.3 / 3.3 * 5 at input will give 1023 counts.
+	return utilsScale(SCALER_VOLTS_MON_5V_REF, UTILS_ELEMENT_COUNT(SCALER_VOLTS_MON_5V_REF), raw);
 #elif (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR) || (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
-	return utilsRescaleU16(raw, 1023U, 13300U); // Scales 10 bit ADC with 5V ref and a 10K/3K3 divider. So 13.3 / 3.3 * 3.3 at input will give 1023 counts.
+	return utilsScale(SCALER_VOLTS_MON_3V3_REF, UTILS_ELEMENT_COUNT(SCALER_VOLTS_MON_3V3_REF), raw);
 #endif
 }
 
@@ -0,0 +1,37 @@
+#ifndef DRIVER_TABLES_H__
+#define DRIVER_TABLES_H__
+
+// Lookup tables for the driver, regenerate with `mk_tables.py driver_tables.h' after editing the definitions.
+
+/* [[[  Begin table definitions: format <kind> <NAME> <option>=<value> ...
+
+	# LCD backlight brightness, https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/
+	gamma LED_GAMMA size=64 gamma=2.0 max=255
+
+	# Supply monitors, 10 bit ADC to mV with a 10K/3K3 divider, so 13.3/3.3 * Vref at the input gives 1023 counts.
+	# Sargood has a 5V ADC ref, the slaves 3.3V.
+	scaler SCALER_VOLTS_MON_5V_REF points=0:0,1023:20151
+	scaler SCALER_VOLTS_MON_3V3_REF points=0:0,1023:13300
+
+ >>> End table definitions, begin generated code. */
+// Gamma 2.0, 64 steps to 255.
+static const uint8_t LED_GAMMA[] PROGMEM = {
+	0, 0, 0, 1, 1, 2, 2, 3, 4, 5, 6, 8, 9, 11, 13, 14,
+	16, 19, 21, 23, 26, 28, 31, 34, 37, 40, 43, 47, 50, 54, 58, 62,
+	66, 70, 74, 79, 83, 88, 93, 98, 103, 108, 113, 119, 124, 130, 136, 142,
+	148, 154, 161, 167, 174, 180, 187, 194, 201, 209, 216, 224, 231, 239, 247, 255,
+};
+
+// Scaler through 0:0,1023:20151, max error 1.
+static const UtilsScalerSegment SCALER_VOLTS_MON_5V_REF[] PROGMEM = {
+	{ 0, 0, 1290925 }, { 1023, 20151, 0 },
+};
+
+// Scaler through 0:0,1023:13300, max error 0.
+static const UtilsScalerSegment SCALER_VOLTS_MON_3V3_REF[] PROGMEM = {
+	{ 0, 0, 852032 }, { 1023, 13300, 0 },
+};
+
+// ]]] End generated code.
+
+#endif //  DRIVER_TABLES_H__
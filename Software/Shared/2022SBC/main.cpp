@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include <avr/wdt.h>
+#include <avr/eeprom.h>
 
 #include "project_config.h"
 #include "gpio.h"
@@ -11,164 +12,153 @@
 #include "modbus.h"
 #include "driver.h"
 #include "sbc2022_modbus.h"
+#include "loop_prof.h"
 FILENUM(1);
 
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
 #include "event.h"
 #include "app.h"
+#include "lcd_fb.h"
 #endif
 
 // Console
 static void print_banner() { consolePrint(CFMT_STR_P, (console_cell_t)PSTR(CFG_BANNER_STR)); }
-static bool console_cmds_user(char* cmd) {
-  switch (console_hash(cmd)) {
-	case /** ?VER **/ 0xc33b: print_banner(); break;
+// Binary register stream, controlled by console commands BMASK & BDUMP.
+static struct {
+	uint16_t period;						// Period in ms, zero for no stream.
+	uint16_t then;							// Time of last packet.
+	uint8_t seq;							// Incremented for each packet so that the receiver can detect lost packets.
+	uint8_t mask[REGS_STREAM_MASK_SIZE];	// Mask of registers to send.
+} f_regs_stream;
+static void regs_stream_start(uint16_t period) {
+	f_regs_stream.period = period;
+	f_regs_stream.then = (uint16_t)millis() - period;		// Send first packet immediately.
+}
+// Returns the mask to send, if the user mask is all zero the default of all volatile registers is written to the buffer so that the user mask
+//  is never changed.
+static const uint8_t* regs_stream_get_mask(uint8_t* buf) {
+	fori (REGS_STREAM_MASK_SIZE) {
+		if (f_regs_stream.mask[i])
+			return f_regs_stream.mask;
+	}
+	memset(buf, 0, REGS_STREAM_MASK_SIZE);
+	fori (REGS_START_NV_IDX)
+		buf[i / 8] |= (uint8_t)(1U << (i % 8));
+	return buf;
+}
 
-	// Command processor.
+// Console scripts in PROGMEM, run by name with command RUN. Lines are separated by `\r'.
+static const char SCRIPT_NAME_INFO[] PROGMEM = "info";
+static const char SCRIPT_INFO[] PROGMEM = "?VER\r?T ?SL\r??V";
 #if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
-    case /** CMD **/ 0xd00f: appCmdRun(consoleStackPop()); break;
+static const char SCRIPT_NAME_TRACE[] PROGMEM = "trace";
+static const char SCRIPT_TRACE[] PROGMEM = "CTM DTM\r?TM";
+static const char SCRIPT_NAME_POS[] PROGMEM = "pos";
+static const char SCRIPT_POS[] PROGMEM = "?S\r?PR\r?LIM";
 #endif
-
-	// Driver
-    case /** LED **/ 0xdc88: driverSetLedPattern(consoleStackPop()); break;
-    case /** ?LED **/ 0xdd37: consolePrint(CFMT_D, driverGetLedPattern()); break;
-#if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR
-#elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY
-    case /** RLY **/ 0x07a2: REGS[REGS_IDX_RELAYS] = consoleStackPop(); break;
-    case /** ?RLY **/ 0xb21d: consolePrint(CFMT_D, REGS[REGS_IDX_RELAYS]); break;
-#elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
-	case /** ?S **/ 0x6889: fori (CFG_TILT_SENSOR_COUNT) consolePrint(CFMT_D, REGS[REGS_IDX_TILT_SENSOR_0 + i]); break;
-	case /** ?PR **/ 0x7998: fori (DRIVER_BED_POS_PRESET_COUNT) {
-		forj (CFG_TILT_SENSOR_COUNT) consolePrint(CFMT_D, driverPresets(i)[j]);
-	}  break;
-	case /** PR **/ 0x74c7: {
-		const uint8_t idx = consoleStackPop(); if (idx >= DRIVER_BED_POS_PRESET_COUNT) consoleRaise(CONSOLE_RC_ERROR_USER);
-		fori (CFG_TILT_SENSOR_COUNT) driverPresets(idx)[CFG_TILT_SENSOR_COUNT-i-1] = consoleStackPop();
-	} break;
-	case /** ?LIM **/ 0xdeb2: fori (CFG_TILT_SENSOR_COUNT) {
-		consolePrint(CFMT_D, driverAxisLimitGet(i, DRIVER_AXIS_LIMIT_IDX_LOWER)); consolePrint(CFMT_D, driverAxisLimitGet(i, DRIVER_AXIS_LIMIT_IDX_UPPER));
-	}  break;
-	case /** LIM **/ 0xdb0d: {
-		const uint8_t axis_idx = consoleStackPop(); if (axis_idx >= CFG_TILT_SENSOR_COUNT) consoleRaise(CONSOLE_RC_ERROR_USER);
-		driverAxisLimitSet(axis_idx, DRIVER_AXIS_LIMIT_IDX_UPPER, consoleStackPop()); driverAxisLimitSet(axis_idx, DRIVER_AXIS_LIMIT_IDX_LOWER, consoleStackPop());
-	} break;
-#if 0
-	case /** LCD **/ 0xdcce: {
-		const char* msg = (const char*)consoleStackPop();
-		const uint8_t timeout = (uint8_t)consoleStackPop();
-		lcdDriverWrite(consoleStackPop(), timeout, PSTR("%s"), msg);
-		} break;
-#endif
-	case /** BL **/ 0x728b: driverSetLcdBacklight(consoleStackPop()); break;
-	// Events & trace...
-	case /** EVENT **/ 0x8a29: eventPublish(consoleStackPop()); break;
-	case /** EVENT-EX **/ 0x2f99: { const uint16_t p16 = consoleStackPop(); const uint8_t p8 = consoleStackPop(); eventPublish(consoleStackPop(), p8, p16); } break;
-	case /** CTM **/ 0xd17f: eventTraceMaskClear(); break;
-	case /** DTM **/ 0xbcb8: eventTraceMaskSetDefault(); eventTraceMaskSetBit(EV_TIMER, false);  eventTraceMaskSetBit(EV_DEBUG_TIMER_ARM, false); eventTraceMaskSetBit(EV_DEBUG_TIMER_STOP, false); break;
-	case /** ?TM **/ 0x7a03: fori ((COUNT_EV + 15) / 16) consolePrint(CFMT_X, ((uint16_t)eventGetTraceMask()[i*2+1]<<8) | (uint16_t)eventGetTraceMask()[i*2]); break;
-	case /** ??TM **/ 0x3fbc: {
-		fori (COUNT_EV) {
-			printf_s(PSTR("\n%d: %S: %c"), i, eventGetEventName(i), eventTraceMaskGetBit(i) + '0');
-			wdt_reset();
-		}
-	} break;
-	case /** STM **/ 0x116f: { const uint8_t ev_id = consoleStackPop(); eventTraceMaskSetBit(ev_id, consoleStackPop()); } break;
+static const struct {
+	const char* name;
+	const char* script;
+} CONSOLE_SCRIPTS[] PROGMEM = {
+	{ SCRIPT_NAME_INFO,		SCRIPT_INFO },
+#if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
+	{ SCRIPT_NAME_TRACE,	SCRIPT_TRACE },
+	{ SCRIPT_NAME_POS,		SCRIPT_POS },
 #endif
-
-	// MODBUS
-	case /** M **/ 0xb5e8: regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_MODBUS_EVENTS, true); break;
-	case /** ATN **/ 0xb87e: driverSendAtn(); break;
-    case /** SL **/ 0x74fa: modbusSetSlaveId(consoleStackPop()); break;
-    case /** ?SL **/ 0x79e5: consolePrint(CFMT_D, modbusGetSlaveId()); break;
-    case /** SEND-RAW **/ 0xf690: {
-        uint8_t* d = (uint8_t*)consoleStackPop(); uint8_t sz = *d; modbusSend(d + 1, sz, false);
-      } break;
-    case /** SEND **/ 0x76f9: {
-        uint8_t* d = (uint8_t*)consoleStackPop(); uint8_t sz = *d; modbusSend(d + 1, sz);
-      } break;
-    case /** WRITE **/ 0xa8f8: { // (val addr sl -) REQ: [FC=6 addr:16 value:16] -- RESP: [FC=6 addr:16 value:16]
-		BufferDynamic rf(10);
-		rf.add(consoleStackPop());
-		rf.add(MODBUS_FC_WRITE_SINGLE_REGISTER);
-		rf.addU16_be((uint16_t)consoleStackPop());
-		rf.addU16_be((uint16_t)consoleStackPop());
-		modbusSend(rf);
-      } break;
-    case /** READ **/ 0xd8b7: { // (count addr sl -) REQ: [FC=3 addr:16 count:16(max 125)] RESP: [FC=3 byte-count value-0:16, ...]
-		BufferDynamic rf(10);
-		rf.add(consoleStackPop());
-		rf.add(MODBUS_FC_READ_HOLDING_REGISTERS);
-		rf.addU16_be((uint16_t)consoleStackPop());
-		rf.addU16_be((uint16_t)consoleStackPop());
-		modbusSend(rf);
-	  } break;
-
-	// Regs
-    case /** ?V **/ 0x688c:
-	    { const uint8_t idx = consoleStackPop();
-		    if (idx < COUNT_REGS)
-				regsPrintValue(idx);
-			else
-				consolePrint(CFMT_C, (console_cell_t)'?');
-		} break;
-    case /** V **/ 0xb5f3:
-	    { const uint8_t idx = consoleStackPop(); const uint16_t v = (uint16_t)consoleStackPop();
-		    if (idx < COUNT_REGS)
-				CRITICAL( REGS[idx] = v ); // Might be interrupted by an ISR part way through.
-		} break;
-    case /** ??V **/ 0x85d3: fori(COUNT_REGS) { regsPrintValue(i); } break;
-	case /** ???V **/ 0x3cac: {
-		fori (COUNT_REGS) {
-			consolePrint(CFMT_NL, 0);
-			consolePrint(CFMT_D|CFMT_M_NO_SEP, (console_cell_t)i);
-			consolePrint(CFMT_C, (console_cell_t)':');
-			regsPrintValue(i);
-			consolePrint(CFMT_STR_P, (console_cell_t)regsGetRegisterName(i));
-			consolePrint(CFMT_STR_P, (console_cell_t)regsGetRegisterDescription(i));
-			devWatchdogPat(DEV_WATCHDOG_MASK_MAINLOOP);
-		}
-		consolePrint(CFMT_STR_P, (console_cell_t)regsGetHelpStr());
+};
+static void console_script_run_named(const char* name) {
+	fori (UTILS_ELEMENT_COUNT(CONSOLE_SCRIPTS)) {
+		if (0 == strcasecmp_P(name, (const char*)pgm_read_word(&CONSOLE_SCRIPTS[i].name))) {
+			const console_rc_t rc = consoleScriptRun((const char*)pgm_read_word(&CONSOLE_SCRIPTS[i].script), consoleScriptReadProgmem);
+			if (CONSOLE_RC_OK != rc)
+				consoleRaise(rc);
+			return;
 		}
-		break;
-    case /** DUMP **/ 0x4fe9:
-		regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS, (consoleStackTos() > 0));
-		regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS_FAST, (consoleStackPop() > 1));
-		break;
-	case /** X **/ 0xb5fd:
-		regsWriteMask(REGS_IDX_ENABLES, REGS_ENABLES_MASK_DUMP_REGS|REGS_ENABLES_MASK_DUMP_REGS_FAST|REGS_ENABLES_MASK_DUMP_MODBUS_EVENTS, 0);
-		break; // Shortcut for killing dump.
-
-	// Runtime errors...
-    case /** RESTART **/ 0x7092: while (1) continue; break;
-    case /** CLI **/ 0xd063: cli(); break;
-    case /** ABORT **/ 0xfeaf: RUNTIME_ERROR(consoleStackPop()); break;
-	case /** ASSERT **/ 0x5007: ASSERT(consoleStackPop()); break;
-
-	// EEPROM data
-	case /** NV-DEFAULT **/ 0xfcdb: driverNvSetDefaults(); break;
-	case /** NV-W **/ 0xa8c7: driverNvWrite(); break;
-	case /** NV-R **/ 0xa8c2: driverNvRead(); break;
+	}
+	consoleRaise(CONSOLE_RC_ERROR_INDEX_OUT_OF_RANGE);
+}
 
-	// Arduino system access...
-    case /** PIN **/ 0x1012: {
-        const uint8_t pin = (uint8_t)consoleStackPop();
-        digitalWrite(pin, (uint8_t)consoleStackPop());
-      } break;
-    case /** ?PIN **/ 0xa9ad: 
-		consolePrint(CFMT_D, (console_cell_t)digitalRead(consoleStackPop()));
-        break;
-    case /** PMODE **/ 0x48d6: {
-        const uint8_t pin = (uint8_t)consoleStackPop();
-        pinMode(pin, (uint8_t)consoleStackPop());
-      } break;
-    case /** ?T **/ 0x688e: { const uint32_t t = millis(); consolePrint(CFMT_U_D, (console_cell_t)&t); } break;
+/* A single script in a reserved area at the top of EEPROM, written a line at a time by the console with ES-ADD. It is at a fixed address rather
+	than declared EEMEM so that it does not move the NV register data. Erased EEPROM reads 0xff, which terminates the script. */
+#define EEPROM_SCRIPT_SIZE 256U
+#define EEPROM_SCRIPT_ADDR ((char*)(E2END + 1U - EEPROM_SCRIPT_SIZE))
+static char eeprom_script_read(const char* p) {
+	const uint8_t c = eeprom_read_byte((const uint8_t*)p);
+	return (0xff == c) ? '\0' : (char)c;
+}
+static uint16_t eeprom_script_len() {
+	uint16_t len = 0;
+	while ((len < EEPROM_SCRIPT_SIZE) && ('\0' != eeprom_script_read(EEPROM_SCRIPT_ADDR + len)))
+		len += 1;
+	return len;
+}
+static void eeprom_script_add(const char* line) {
+	uint16_t len = eeprom_script_len();
+	if ((len + strlen(line) + 2U) > EEPROM_SCRIPT_SIZE)		// Need room for line, newline & terminator.
+		consoleRaise(CONSOLE_RC_ERROR_INDEX_OUT_OF_RANGE);
+	while ('\0' != *line)
+		eeprom_update_byte((uint8_t*)EEPROM_SCRIPT_ADDR + len++, (uint8_t)*line++);
+	eeprom_update_byte((uint8_t*)EEPROM_SCRIPT_ADDR + len++, '\r');
+	eeprom_update_byte((uint8_t*)EEPROM_SCRIPT_ADDR + len, '\0');
+}
 
-    default: return false;
-  }
-  return true;
+// Services timed by the loop profiler, names in PROGMEM for console command ?PROF.
+enum {
+	LOOP_PROF_CONSOLE,
+	LOOP_PROF_DRIVER,
+	LOOP_PROF_REGS_STREAM,
+	LOOP_PROF_RUN_EVERY_100,
+	LOOP_PROF_APP,
+	COUNT_LOOP_PROF
+};
+UTILS_STATIC_ASSERT(COUNT_LOOP_PROF == CFG_LOOP_PROF_SERVICE_COUNT);
+static const char LOOP_PROF_NAME_CONSOLE[] PROGMEM = "console";
+static const char LOOP_PROF_NAME_DRIVER[] PROGMEM = "driver";
+static const char LOOP_PROF_NAME_REGS_STREAM[] PROGMEM = "regs-stream";
+static const char LOOP_PROF_NAME_RUN_EVERY_100[] PROGMEM = "100ms";
+static const char LOOP_PROF_NAME_APP[] PROGMEM = "app";
+static const char* const LOOP_PROF_NAMES[] PROGMEM = {
+	LOOP_PROF_NAME_CONSOLE, LOOP_PROF_NAME_DRIVER, LOOP_PROF_NAME_REGS_STREAM, LOOP_PROF_NAME_RUN_EVERY_100, LOOP_PROF_NAME_APP,
+};
+static void loop_prof_print_stat(const char* name, const loop_prof_stat_t* s) {
+	consolePrint(CFMT_STR_P, (console_cell_t)name);
+	consolePrint(CFMT_U, s->count ? s->min : 0U);
+	consolePrint(CFMT_U, s->max);
+	consolePrint(CFMT_U, loopProfMean(s));
+	consolePrint(CFMT_NL, 0);
+}
+static void loop_prof_print() {
+	consolePrint(CFMT_NL, 0);
+	fori (COUNT_LOOP_PROF)
+		loop_prof_print_stat((const char*)pgm_read_word(&LOOP_PROF_NAMES[i]), loopProfStat(i));
+	loop_prof_print_stat(PSTR("loop"), loopProfStat(COUNT_LOOP_PROF));
+	consolePrint(CFMT_STR_P, (console_cell_t)PSTR("worst"));
+	consolePrint(CFMT_U, loopProfWorst()->loop);
+	fori (COUNT_LOOP_PROF)
+		consolePrint(CFMT_U, loopProfWorst()->services[i]);
 }
+static void wdog_stats_print() {
+	dev_watchdog_stats_t stats;
+	devWatchdogStatsGet(&stats);
+	consolePrint(CFMT_NL, 0);
+	consolePrint(CFMT_STR_P, (console_cell_t)PSTR("hist"));
+	fori (DEV_WATCHDOG_LOOP_HIST_BUCKETS)
+		consolePrint(CFMT_U, stats.loop_hist[i]);
+	consolePrint(CFMT_NL, 0);
+	consolePrint(CFMT_STR_P, (console_cell_t)PSTR("margin"));
+	fori (DEV_WATCHDOG_MASK_COUNT)
+		consolePrint(CFMT_D, devWatchdogStatsMarginMs(&stats, i));
+}
+
+// Commands are defined in console_cmds.src, run `mk_console.py console_cmds.src -o console_cmds.h' to regenerate the lookup table.
+#include "console_cmds.h"
 
-#if (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR) || (CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY)
+// The Sensor console is on the Timer1 capture & compare pins, so it can use a timer driven software UART that does not block interrupts.
+#if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SENSOR
+#include "timer_serial.h"
+UTILS_STATIC_ASSERT((GPIO_PIN_CONS_RX == TIMER_SERIAL_PIN_RX) && (GPIO_PIN_CONS_TX == TIMER_SERIAL_PIN_TX));
+static TimerSerial GPIO_SERIAL_CONSOLE;
+#elif CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_RELAY
 #include <SoftwareSerial.h>
 static SoftwareSerial GPIO_SERIAL_CONSOLE(GPIO_PIN_CONS_RX, GPIO_PIN_CONS_TX); // RX, TX
 #endif
@@ -193,6 +183,19 @@ static void console_init() {
 	consolePrompt();
 
 }
+static void service_regs_stream() {
+	if (f_regs_stream.period) {
+		const uint16_t now = (uint16_t)millis();
+		if ((uint16_t)(now - f_regs_stream.then) >= f_regs_stream.period) {
+			f_regs_stream.then = now;
+			uint8_t mask[REGS_STREAM_MASK_SIZE];
+			uint8_t pkt[REGS_STREAM_PACKET_SIZE_MAX];
+			const uint8_t sz = regsStreamMakePacket(pkt, regs_stream_get_mask(mask), f_regs_stream.seq++, millis());
+			GPIO_SERIAL_CONSOLE.write(pkt, sz);
+		}
+	}
+}
+
 static void service_regs_dump() {
     static uint8_t s_ticker;
     if (REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_DUMP_REGS) {
@@ -235,8 +238,15 @@ static const BlinkyLedWarningDef BLINKY_LED_WARNING_DEFS[] PROGMEM = {
 #endif
 
 };
+// Only looks for a new pattern when the flags register has changed, or when the blinky LED is enabled. Relies on the flags only being written
+//  with regsWriteMaskFlags() & regsUpdateMaskFlags() so that the change is seen.
 static void service_blinky_led_warnings() {
-	if (!(REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_DISABLE_BLINKY_LED)) {
+	static bool s_enabled;
+	const bool changed = regsChangeTestAndClear(REGS_IDX_FLAGS);
+	const bool enabled = !(REGS[REGS_IDX_ENABLES] & REGS_ENABLES_MASK_DISABLE_BLINKY_LED);
+	const bool update = enabled && (changed || !s_enabled);
+	s_enabled = enabled;
+	if (update) {
 		fori (UTILS_ELEMENT_COUNT(BLINKY_LED_WARNING_DEFS)) {
 			const uint16_t m = pgm_read_word(&BLINKY_LED_WARNING_DEFS[i].flags_mask);
 			if (m & regsFlags()) {
@@ -254,6 +264,27 @@ static void appService() {}
 static void appService10hz() {}
 #endif
 
+static void loop_prof_update_regs() {
+	REGS[REGS_IDX_LOOP_TIME_MAX] = loopProfWorst()->loop;
+	REGS[REGS_IDX_LOOP_WORST_SERVICE] = loopProfWorstService();
+}
+
+// Update free RAM registers and warn if the minimum ever free is low. The Sargood flags register is full so it gets an event instead.
+static void ram_monitor_update() {
+	const uint16_t free_min = devRamFreeMin();
+	REGS[REGS_IDX_RAM_FREE] = devRamFree();
+	REGS[REGS_IDX_RAM_FREE_MIN] = free_min;
+	const bool low = (free_min < CFG_RAM_FREE_WARN_THRESHOLD);
+#if CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_SARGOOD
+	static bool warned;
+	if (low && !warned)
+		eventPublish(EV_RAM_LOW, 0, free_min);
+	warned = low;
+#else
+	regsWriteMaskFlags(REGS_FLAGS_MASK_RAM_LOW, low);
+#endif
+}
+
 void setup() {
 	const uint16_t restart_rc = devWatchdogInit();
 	regsSetDefaultRange(0, REGS_START_NV_IDX);		// Set volatile registers.
@@ -261,18 +292,28 @@ void setup() {
 	REGS[REGS_IDX_RESTART] = restart_rc;
 	console_init();
 	appInit();
+	loopProfReset();
 }
 
 void loop() {
+	loopProfStart();
 	devWatchdogPat(DEV_WATCHDOG_MASK_MAINLOOP);
 	consoleService();
+	loopProfMark(LOOP_PROF_CONSOLE);
 	driverService();
+	loopProfMark(LOOP_PROF_DRIVER);
+	service_regs_stream();
+	loopProfMark(LOOP_PROF_REGS_STREAM);
 	utilsRunEvery(100) {				// Basic 100ms timebase.
 		service_regs_dump();
 		service_blinky_led_warnings();
 		appService10hz();
+		loop_prof_update_regs();
+		ram_monitor_update();
 	}
+	loopProfMark(LOOP_PROF_RUN_EVERY_100);
 	appService();
+	loopProfMark(LOOP_PROF_APP);
 }
 
 void debugRuntimeError(int fileno, int lineno, int errorno) {
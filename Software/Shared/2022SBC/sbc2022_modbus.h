@@ -7,6 +7,12 @@ enum {
 	SBC2022_MODBUS_REGISTER_SENSOR_TILT = 100,
 	SBC2022_MODBUS_REGISTER_SENSOR_STATUS = 101,
 	SBC2022_MODBUS_REGISTER_SENSOR_SAMPLE_COUNT = 102,
+	SBC2022_MODBUS_REGISTER_SENSOR_SAMPLE_AGE = 103,	// Age of tilt in ms when read, including filter delay, 65535 if unknown.
+	SBC2022_MODBUS_REGISTER_SENSOR_RBE = 110,			// Read tilt, status, sample count & age by exception, see modbus_rbe.h.
+
+	// Read only block of watchdog stats on Relay & Sensor, the loop period histogram buckets, then the longest period between pats for each watchdog mask in ms.
+	SBC2022_MODBUS_REGISTER_WDOG_STATS = 200,
+	SBC2022_MODBUS_REGISTER_WDOG_STATS_MAX_GAP = 216,
 };
 
 // Status codes from Relay & Sensor modules.
@@ -25,7 +31,8 @@ static inline bool isSlaveStatusFault(uint8_t status) { return status < SBC2022_
 
 // Slave IDs (addresses).
 enum {
-	SBC2022_MODBUS_SLAVE_ID_RELAY = 16,
+	SBC2022_MODBUS_SLAVE_ID_RELAY = 16,			// First Relay, others follow on from here.
+	SBC2022_MODBUS_SLAVE_COUNT_RELAY = 4,
 	SBC2022_MODBUS_SLAVE_ID_SENSOR_0 = 1,		// First tilt sensor, others follow on from here.
 	SBC2022_MODBUS_SLAVE_COUNT_SENSOR = 4,
 };
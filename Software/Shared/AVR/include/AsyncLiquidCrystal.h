@@ -6,6 +6,15 @@
 #include <inttypes.h>
 #include "Print.h"
 
+// On AVR the pins are written directly to the port registers rather than with digitalWrite(), which is much faster. Define as 0 to disable.
+#ifndef ASYNC_LCD_DIRECT_PORT
+#if defined(AVR)
+#define ASYNC_LCD_DIRECT_PORT 1
+#else
+#define ASYNC_LCD_DIRECT_PORT 0
+#endif
+#endif
+
 // commands
 #define LCD_CLEARDISPLAY 0x01
 #define LCD_RETURNHOME 0x02
@@ -104,6 +113,10 @@ public:
   
   using Print::write;
 private:
+  void writeRs(uint8_t value);
+  void writeNibble(uint8_t value);
+  void pulseEnable();
+
   unsigned long wait_until;
   uint8_t state;
   LoopbackStream queue;
@@ -121,6 +134,17 @@ private:
 
   uint8_t _numlines;
   uint8_t _row_offsets[4];
+
+#if ASYNC_LCD_DIRECT_PORT
+  // Pins resolved to port registers and bit masks in begin(). If the 4 data pins are on one port then each nibble is written in one operation.
+  volatile uint8_t* _rs_port;
+  uint8_t _rs_mask;
+  volatile uint8_t* _enable_port;
+  uint8_t _enable_mask;
+  volatile uint8_t* _data_port;   // NULL if data pins are not all on the same port, or in 8 bit mode.
+  uint8_t _data_mask;             // Mask of all 4 data pins.
+  uint8_t _nibble_masks[16];      // Port bits to set for each nibble value.
+#endif
 };
 
 #endif
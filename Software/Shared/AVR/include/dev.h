@@ -82,11 +82,20 @@ enum {
  #error Unknown processor!	    
 #endif
 
+// Oversampling, a channel may be converted 2^n times in a row in the ISR and the average written to the result. Max n is 6 so that the sum fits in 16 bits.
+enum { DEV_ADC_OVERSAMPLE_MAX = 6 };
+
+// Maximum number of channels in the list that have a sample counter, including the terminating entry.
+#ifndef CFG_DEV_ADC_CHANNEL_COUNT_MAX
+#define CFG_DEV_ADC_CHANNEL_COUNT_MAX 4
+#endif
+
 // Struct containing definition for a single channel. Note that bit 5 of mux ireplaces ADLAR bit for MEGA2560, which is always cleared, as MUX5 is written to ADCSRB register.
 typedef struct {
     uint8_t admux;			// Value loaded in ADMUX register prior to conversion. 
     uint16_t* result;	    // Pointer for result, set to DEV_ADC_RESULT_NONE to ignore value, e.g. if doing a dummy conversion to allow the ADC to settle, set to DEV_ADC_RESULT_END to terminate list.
     void* setup_arg;		// Argument for setup function. 
+	uint8_t oversample;		// Log2 of number of samples averaged for the result, 0 for a single sample.
 } DevAdcChannelDef;
 
 // Initialise the driver with the desired clock prescale value. 
@@ -104,9 +113,12 @@ void devAdcStartConversions();
 // Returns true if conversion still running. 
 bool devAdcIsRunning();
 
-// Returns true ONCE when all conversion complete. 
+// Returns true ONCE when all conversion complete, so there is a new sample set in the results. The flag is set by the ISR and cleared by this call.
 bool devAdcIsConversionDone();
 
+// Returns count of results written for a channel, by index into g_adc_def_list. Wraps at 255.
+uint8_t devAdcSampleCount(uint8_t idx);
+
 /* Generic EEPROM driver, manages a block of user data in EEPROM, and does it's best to keep it uncorrupted and verified.
     The user data is managed as an opaque block of RAM, the EEPROM driver doesn't care what is in it.
     A struct contains the definition of the managed data, there is a function for filling this RAM with default data.
@@ -168,4 +180,44 @@ void devWatchdogPat(uint8_t m);
 // Check if restart was due to watchdog.
 static inline bool devWatchdogIsRestartWatchdog(uint16_t rst) { return !!(rst & _BV(WDRF)); }
 
+/* Watchdog stats, to show how close each mask comes to the watchdog timeout, and how the main loop period is distributed. They are kept in
+	.noinit RAM so they survive a watchdog restart and can be read afterwards. They are cleared on a power on or brownout restart, or if corrupt.
+	Periods are timed with micros(). The first main loop pat after devWatchdogInit() is not added to the histogram as it includes setup().
+	Pats from the timer ISR are not timed as they happen every ms, so the margin for DEV_WATCHDOG_MASK_TIMER_ISR always reads as the full timeout. */
+enum {
+	DEV_WATCHDOG_MASK_COUNT = CFG_WATCHDOG_MODULE_COUNT + 2,
+	DEV_WATCHDOG_LOOP_HIST_BUCKETS = 14,
+	DEV_WATCHDOG_LOOP_HIST_BUCKET_0_SHIFT = 7,			// Bucket 0 is for periods < 128us.
+};
+#define DEV_WATCHDOG_TIMEOUT_MS (16UL << CFG_WATCHDOG_TIMEOUT)		// Nominal, the watchdog oscillator is not accurate.
+typedef struct {
+	uint16_t loop_hist[DEV_WATCHDOG_LOOP_HIST_BUCKETS];	// Count of main loop periods, bucket n for periods < 128us * 2^n, the last bucket for any longer. Saturates.
+	uint32_t max_gap_us[DEV_WATCHDOG_MASK_COUNT];		// Longest period between pats for each mask.
+} dev_watchdog_stats_t;
+
+// Copy the stats, done with interrupts off as the timer ISR updates them.
+void devWatchdogStatsGet(dev_watchdog_stats_t* stats);
+void devWatchdogStatsClear();
+
+// Closest approach to the watchdog timeout for a mask in ms, negative if the timeout was exceeded.
+int16_t devWatchdogStatsMarginMs(const dev_watchdog_stats_t* stats, uint8_t idx);
+
+// 
+// Free RAM monitor.
+//
+
+/* RAM between the top of the heap and the stack is painted with a fixed value at startup, before the C runtime initialises. Then the lowest
+	point that the stack has reached can be found by scanning up from the heap for the first byte that has been overwritten. Note that a
+	function with a large local array that it does not completely write may leave paint bytes unchanged, so the result is optimistic. */
+#ifndef CFG_RAM_FREE_WARN_THRESHOLD
+#define CFG_RAM_FREE_WARN_THRESHOLD 128
+#endif
+enum { DEV_RAM_PAINT = 0xc5 };
+
+// Current free RAM between top of heap and stack pointer in bytes.
+uint16_t devRamFree();
+
+// Free RAM that has never been touched by the stack or heap in bytes. Takes a few hundred us as it scans the free RAM.
+uint16_t devRamFreeMin();
+
 #endif // DEV_H__
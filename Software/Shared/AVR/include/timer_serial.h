@@ -0,0 +1,47 @@
+#ifndef TIMER_SERIAL_H__
+#define TIMER_SERIAL_H__
+
+/* Software UART driven by Timer1 on the ATmega328, a drop-in replacement for SoftwareSerial that does not disable interrupts for a character time
+	on every byte sent or received, which blocks the ADC ISR & the MODBUS USART.
+	The pins are fixed by the timer hardware, RX on ICP1 (D8) and TX on OC1A (D9).
+	TX: each bit is output on the pin by the timer compare unit at exactly the right time, the compare ISR then sets up the level for the next
+	bit, so latency in servicing the ISR of up to a bit time does not cause jitter.
+	RX: the input capture unit timestamps each edge, and the capture ISR works out the bits since the last edge from the time between them. A
+	compare ISR a quarter of the way into the stop bit finishes off a character that ends with 1 bits, as these have no edge.
+	TX & RX run at the same time from ring buffers, so the console can echo. Write blocks if the TX buffer is full.
+	Timer1 is taken over by begin(), so PWM on D9 & D10 and the Servo library cannot be used. OC1B (D10) is left as a normal pin.
+	At 16MHz baudrates up to 57600 are OK, faster than this the ISRs for a character received while one is sent may overrun.
+	There can only be one instance as the ISRs use shared state. */
+
+#include <Arduino.h>
+#include "project_config.h"		// cppcheck-suppress [missingInclude]
+
+#ifndef CFG_TIMER_SERIAL_RX_BUFFER_SIZE
+#define CFG_TIMER_SERIAL_RX_BUFFER_SIZE 32		// Must be a power of 2 and no more than 128.
+#endif
+#ifndef CFG_TIMER_SERIAL_TX_BUFFER_SIZE
+#define CFG_TIMER_SERIAL_TX_BUFFER_SIZE 64		// Must be a power of 2 and no more than 128.
+#endif
+
+// Pins are fixed by Timer1, input capture & compare output A.
+enum { TIMER_SERIAL_PIN_RX = 8, TIMER_SERIAL_PIN_TX = 9 };
+
+class TimerSerial : public Stream {
+public:
+	TimerSerial() { /* empty */ }
+	void begin(uint32_t baud);
+	void end();
+
+	virtual int available();
+	virtual int read();
+	virtual int peek();
+	virtual size_t write(uint8_t c);
+	using Print::write;
+	virtual void flush();			// Wait for all buffered characters to be sent.
+	operator bool() { return true; }
+
+	// Count of characters received with the RX buffer full & lost, saturates at 255.
+	uint8_t overruns();
+};
+
+#endif // TIMER_SERIAL_H__
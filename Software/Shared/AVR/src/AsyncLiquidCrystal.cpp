@@ -137,6 +137,38 @@ void AsyncLiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
     pinMode(_data_pins[i], OUTPUT);
     digitalWrite(_data_pins[i], LOW);
   }
+
+#if ASYNC_LCD_DIRECT_PORT
+  // Resolve pins to ports once, the pins have been written with digitalWrite() above, which also turns off any PWM output on them.
+  _rs_port = portOutputRegister(digitalPinToPort(_rs_pin));
+  _rs_mask = digitalPinToBitMask(_rs_pin);
+  _enable_port = portOutputRegister(digitalPinToPort(_enable_pin));
+  _enable_mask = digitalPinToBitMask(_enable_pin);
+  _data_port = NULL;
+  if (!(_displayfunction & LCD_8BITMODE)) {
+    volatile uint8_t* port = portOutputRegister(digitalPinToPort(_data_pins[4]));
+    bool same_port = true;
+    _data_mask = 0;
+    for (int i=4; i<8; ++i) {
+      if (portOutputRegister(digitalPinToPort(_data_pins[i])) != port) {
+        same_port = false;
+      }
+      _data_mask |= digitalPinToBitMask(_data_pins[i]);
+    }
+    if (same_port) {
+      for (uint8_t n=0; n<16; ++n) {
+        uint8_t m = 0;
+        for (uint8_t b=0; b<4; ++b) {
+          if (n & (1<<b)) {
+            m |= digitalPinToBitMask(_data_pins[4+b]);
+          }
+        }
+        _nibble_masks[n] = m;
+      }
+      _data_port = port;
+    }
+  }
+#endif
   
   //Enqueue reset commands
   WITHOUT_INTERRUPTION({
@@ -392,17 +424,9 @@ long AsyncLiquidCrystal::processQueue() {
     case LCD_QUEUE_INIT_0x30_SLOW: 
     case LCD_QUEUE_INIT_0x30 : 
     case LCD_QUEUE_INIT_0x20: {
-      digitalWrite(_rs_pin, LOW);
-      
-      digitalWrite(_data_pins[7], LOW);
-      digitalWrite(_data_pins[6], LOW);
-      digitalWrite(_data_pins[5], HIGH);
-      digitalWrite(_data_pins[4], (cmd == LCD_QUEUE_INIT_0x20) ? LOW : HIGH);
-      
-      delayMicroseconds(1);
-      digitalWrite(_enable_pin, HIGH);
-      delayMicroseconds(1);
-      digitalWrite(_enable_pin, LOW);
+      writeRs(LOW);
+      writeNibble((cmd == LCD_QUEUE_INIT_0x20) ? 0x2 : 0x3);
+      pulseEnable();
       
       delay = (cmd == LCD_QUEUE_INIT_0x30_SLOW ? 4100 : 100);
       state = LCD_STATE_WAIT_EXECUTION;
@@ -410,7 +434,7 @@ long AsyncLiquidCrystal::processQueue() {
     }
     case LCD_QUEUE_CMD:
     case LCD_QUEUE_WRITE: {
-      digitalWrite(_rs_pin, cmd == LCD_QUEUE_CMD ? LOW : HIGH);
+      writeRs(cmd == LCD_QUEUE_CMD ? LOW : HIGH);
       if (_displayfunction & LCD_8BITMODE) {
         digitalWrite(_data_pins[0], cmd_data & (1<<0));
         digitalWrite(_data_pins[1], cmd_data & (1<<1));
@@ -420,31 +444,12 @@ long AsyncLiquidCrystal::processQueue() {
         digitalWrite(_data_pins[5], cmd_data & (1<<5));
         digitalWrite(_data_pins[6], cmd_data & (1<<6));
         digitalWrite(_data_pins[7], cmd_data & (1<<7));
-        
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, HIGH);
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, LOW);
+        pulseEnable();
       } else {
-        digitalWrite(_data_pins[4], cmd_data & (1<<4));
-        digitalWrite(_data_pins[5], cmd_data & (1<<5));
-        digitalWrite(_data_pins[6], cmd_data & (1<<6));
-        digitalWrite(_data_pins[7], cmd_data & (1<<7));
-        
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, HIGH);
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, LOW);
-        
-        digitalWrite(_data_pins[4], cmd_data & (1<<0));
-        digitalWrite(_data_pins[5], cmd_data & (1<<1));
-        digitalWrite(_data_pins[6], cmd_data & (1<<2));
-        digitalWrite(_data_pins[7], cmd_data & (1<<3));
-        
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, HIGH);
-        delayMicroseconds(1);
-        digitalWrite(_enable_pin, LOW);
+        writeNibble(cmd_data >> 4);
+        pulseEnable();
+        writeNibble(cmd_data & 0x0f);
+        pulseEnable();
       }
       
       if (cmd == LCD_QUEUE_WRITE) {
@@ -468,6 +473,56 @@ long AsyncLiquidCrystal::processQueue() {
   return delay;
 }
 
+/*********** low level pin access */
+
+void AsyncLiquidCrystal::writeRs(uint8_t value) {
+#if ASYNC_LCD_DIRECT_PORT
+  WITHOUT_INTERRUPTION({    // Other pins on the port might be written by an ISR.
+    if (value) {
+      *_rs_port |= _rs_mask;
+    } else {
+      *_rs_port &= ~_rs_mask;
+    }
+  })
+#else
+  digitalWrite(_rs_pin, value);
+#endif
+}
+
+// Write the lower 4 bits of value to data pins D4..D7.
+void AsyncLiquidCrystal::writeNibble(uint8_t value) {
+#if ASYNC_LCD_DIRECT_PORT
+  if (_data_port) {
+    const uint8_t bits = _nibble_masks[value & 0x0f];
+    WITHOUT_INTERRUPTION({
+      *_data_port = (*_data_port & ~_data_mask) | bits;
+    })
+    return;
+  }
+#endif
+  digitalWrite(_data_pins[4], value & (1<<0));
+  digitalWrite(_data_pins[5], value & (1<<1));
+  digitalWrite(_data_pins[6], value & (1<<2));
+  digitalWrite(_data_pins[7], value & (1<<3));
+}
+
+void AsyncLiquidCrystal::pulseEnable() {
+  delayMicroseconds(1);
+#if ASYNC_LCD_DIRECT_PORT
+  WITHOUT_INTERRUPTION({
+    *_enable_port |= _enable_mask;
+  })
+  delayMicroseconds(1);
+  WITHOUT_INTERRUPTION({
+    *_enable_port &= ~_enable_mask;
+  })
+#else
+  digitalWrite(_enable_pin, HIGH);
+  delayMicroseconds(1);
+  digitalWrite(_enable_pin, LOW);
+#endif
+}
+
 void AsyncLiquidCrystal::flush() { 
   while (true) {
     if (processQueue() < 0) {
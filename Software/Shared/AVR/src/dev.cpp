@@ -9,13 +9,19 @@
 static struct {
     const DevAdcChannelDef* current_adc_def;
     uint16_t* result;
-    bool seen_done;
+	uint16_t accum;										// Sum of samples for current channel.
+	uint8_t samples_left;								// Samples still to take for current channel.
+	uint8_t oversample;									// Log2 of samples for current channel.
+	uint8_t chan_idx;									// Index of current channel in list.
+	uint8_t sample_counts[CFG_DEV_ADC_CHANNEL_COUNT_MAX];
+    volatile bool new_set;								// Set by ISR at end of list.
 } f_adc_driver_locals;
 
 // Check size of members of DevAdcChannelDef
 UTILS_STATIC_ASSERT(sizeof(f_adc_driver_locals.current_adc_def->admux) == 1);
 UTILS_STATIC_ASSERT(sizeof(f_adc_driver_locals.current_adc_def->result) == 2);
 UTILS_STATIC_ASSERT(sizeof(f_adc_driver_locals.current_adc_def->setup_arg) == 2);
+UTILS_STATIC_ASSERT(sizeof(f_adc_driver_locals.current_adc_def->oversample) == 1);
 
 void devAdcInit(uint8_t ps) {
     ADCSRA = ps | _BV(ADEN) | _BV(ADIF) | _BV(ADIE);  // Enable ADC and set prescaler. 
@@ -27,8 +33,10 @@ void devAdcSetupFunc(void* setup_arg) { }
 static void start_adc_conversion() { 
     devAdcSetupFunc((void*)pgm_read_word(&f_adc_driver_locals.current_adc_def->setup_arg));     // Call user's setup function with argument from channel list.
     f_adc_driver_locals.result = (uint16_t*)pgm_read_word(&f_adc_driver_locals.current_adc_def->result);             // Read register index for result. 
-    if (DEV_ADC_RESULT_END == f_adc_driver_locals.result)                // Check for end of list
+    if (DEV_ADC_RESULT_END == f_adc_driver_locals.result) {              // Check for end of list
         f_adc_driver_locals.current_adc_def = NULL;                       // Indicate conversion done. 
+		f_adc_driver_locals.new_set = true;
+	}
     else {
         // Get mux selection. 
         uint8_t mux = pgm_read_byte(&f_adc_driver_locals.current_adc_def->admux);
@@ -43,20 +51,32 @@ static void start_adc_conversion() {
  #error Unknown processor!	    
 #endif
 		
+		f_adc_driver_locals.oversample = utilsLimitMax<uint8_t>(pgm_read_byte(&f_adc_driver_locals.current_adc_def->oversample), DEV_ADC_OVERSAMPLE_MAX);
+		f_adc_driver_locals.samples_left = (uint8_t)(1U << f_adc_driver_locals.oversample);
+		f_adc_driver_locals.accum = 0;
         ADCSRA |= _BV(ADSC);                                // Start conversion.
     }
 }
 
 ISR(ADC_vect) {
-    const uint16_t result = ADC;
+	f_adc_driver_locals.accum += ADC;
+	if (--f_adc_driver_locals.samples_left > 0) {		// More samples for this channel, mux is unchanged so just start another conversion.
+		ADCSRA |= _BV(ADSC);
+		return;
+	}
+
     if (DEV_ADC_RESULT_NONE != f_adc_driver_locals.result)
-        *f_adc_driver_locals.result = result;
+        *f_adc_driver_locals.result = f_adc_driver_locals.accum >> f_adc_driver_locals.oversample;
+	if (f_adc_driver_locals.chan_idx < CFG_DEV_ADC_CHANNEL_COUNT_MAX)
+		f_adc_driver_locals.sample_counts[f_adc_driver_locals.chan_idx] += 1;
+	f_adc_driver_locals.chan_idx += 1;
     f_adc_driver_locals.current_adc_def += 1;
     start_adc_conversion();
 }
 void devAdcStartConversions() {
     f_adc_driver_locals.current_adc_def = &g_adc_def_list[0];
-    f_adc_driver_locals.seen_done = false;
+	f_adc_driver_locals.chan_idx = 0;
+    f_adc_driver_locals.new_set = false;
     start_adc_conversion();
 }
 bool devAdcIsRunning() {
@@ -64,15 +84,17 @@ bool devAdcIsRunning() {
 }
 
 bool devAdcIsConversionDone() {
-    if (!devAdcIsRunning()) {
-        if (!f_adc_driver_locals.seen_done) {
-            f_adc_driver_locals.seen_done = true;
-            return true; 
-        }
-    }
+	if (f_adc_driver_locals.new_set) {			// Only set by ISR when not running, so no race with clearing it here.
+		f_adc_driver_locals.new_set = false;
+		return true; 
+	}
     return false;
 }
 
+uint8_t devAdcSampleCount(uint8_t idx) {
+	return (idx < CFG_DEV_ADC_CHANNEL_COUNT_MAX) ? f_adc_driver_locals.sample_counts[idx] : 0U;
+}
+
 
 // Data is stored in EEPROM as checksum then <user data>
 // Data is stored in RAM as:  <user data>
@@ -164,13 +186,52 @@ void devEepromWrite(const DevEepromBlock* block) {
 // Place in section that is not zeroed by startup code. Then after a wd restart we can read this, any set bits are the masks of modules that did NOT refresh in time.
 static uint8_t f_wdacc __attribute__ ((section (".noinit")));   
 
+// Stats also survive a restart, the magic number is checked to see if they are valid.
+static const uint16_t WATCHDOG_STATS_MAGIC = 0xa55a;
+static struct {
+	uint16_t magic;
+	dev_watchdog_stats_t stats;
+} f_wd_stats __attribute__ ((section (".noinit")));
+static uint32_t f_wd_last_pat[DEV_WATCHDOG_MASK_COUNT];		// Time of last pat for each mask.
+static bool f_wd_loop_started;								// Set after first main loop pat.
+
 ISR(TIMER0_COMPA_vect) {				// Kick watchdog with timer mask.
     devWatchdogPat(DEV_WATCHDOG_MASK_TIMER_ISR);
 }
 
+static void watchdog_stats_update(uint8_t m) {
+	if (DEV_WATCHDOG_MASK_TIMER_ISR == m)		// Every ms from the timer ISR, the gap is just the ISR period so not worth the ISR load.
+		return;
+
+	const uint32_t now = micros();
+	fori (DEV_WATCHDOG_MASK_COUNT) {
+		if (m & _BV(i)) {
+			const uint32_t gap = now - f_wd_last_pat[i];
+			f_wd_last_pat[i] = now;
+			if (gap > f_wd_stats.stats.max_gap_us[i])
+				f_wd_stats.stats.max_gap_us[i] = gap;
+
+			if (DEV_WATCHDOG_MASK_MAINLOOP == _BV(i)) {
+				if (f_wd_loop_started) {
+					uint32_t g = gap >> DEV_WATCHDOG_LOOP_HIST_BUCKET_0_SHIFT;		// Log2 bucket by shifting, no divide.
+					uint8_t bucket = 0;
+					while ((0 != g) && (bucket < (DEV_WATCHDOG_LOOP_HIST_BUCKETS - 1))) {
+						g >>= 1;
+						bucket += 1;
+					}
+					if (f_wd_stats.stats.loop_hist[bucket] < UINT16_MAX)
+						f_wd_stats.stats.loop_hist[bucket] += 1;
+				}
+				f_wd_loop_started = true;
+			}
+		}
+	}
+}
+
 // Mask for all used modules that have watchdog masks. 
 #define WATCHDOG_MASK_ALL (_BV(CFG_WATCHDOG_MODULE_COUNT+2) - 1)
 void devWatchdogPat(uint8_t m) {
+	watchdog_stats_update(m);
     f_wdacc &= ~m;
     if (0 == f_wdacc) {
         wdt_reset();
@@ -178,11 +239,28 @@ void devWatchdogPat(uint8_t m) {
     }
 }
 
+void devWatchdogStatsGet(dev_watchdog_stats_t* stats) {
+	CRITICAL(memcpy(stats, &f_wd_stats.stats, sizeof(*stats)));
+}
+void devWatchdogStatsClear() {
+	CRITICAL(memset(&f_wd_stats.stats, 0, sizeof(f_wd_stats.stats)));
+}
+int16_t devWatchdogStatsMarginMs(const dev_watchdog_stats_t* stats, uint8_t idx) {
+	return (int16_t)((int32_t)DEV_WATCHDOG_TIMEOUT_MS - (int32_t)(stats->max_gap_us[idx] / 1000UL));
+}
 
 uint16_t devWatchdogInit() {
 	const uint16_t restart = ((uint16_t)f_wdacc << 8) | MCUSR;		// (JTRF) WDRF BORF EXTRF PORF , JTRF only on JTAG parts
     MCUSR = 0;														// Necessary to disable watchdog on some processors. 
 
+	// Keep stats over a watchdog or external reset, but not a power cycle as RAM contents are random.
+	if ((WATCHDOG_STATS_MAGIC != f_wd_stats.magic) || (restart & (_BV(PORF) | _BV(BORF)))) {
+		f_wd_stats.magic = WATCHDOG_STATS_MAGIC;
+		devWatchdogStatsClear();
+	}
+	fori (DEV_WATCHDOG_MASK_COUNT)
+		f_wd_last_pat[i] = micros();
+
 #if CFG_WATCHDOG_ENABLE											
 	wdt_enable(CFG_WATCHDOG_TIMEOUT);
 #else
@@ -197,3 +275,35 @@ uint16_t devWatchdogInit() {
 	return restart;
 }
 
+
+// Free RAM monitor.
+
+extern "C" {
+	extern uint8_t _end;			// Set by linker to end of .bss & .noinit, which is the start of the heap.
+	extern uint8_t __stack;			// Top of RAM.
+	extern char* __brkval;			// Top of heap, set by malloc(), zero if it has never been called.
+}
+
+// Paint RAM before stack is used. Placed in init section so it runs before main(), it is naked and inlined into the startup code so it must
+//  not use any stack. Painting up to the top of RAM is safe as nothing is on the stack yet.
+void dev_ram_paint() __attribute__ ((naked, used, section (".init3")));
+void dev_ram_paint() {
+	for (uint8_t* p = &_end; p <= &__stack; ++p)
+		*p = DEV_RAM_PAINT;
+}
+
+static const uint8_t* heap_top() { return (0 != __brkval) ? (const uint8_t*)__brkval : &_end; }
+
+uint16_t devRamFree() {
+	const uint8_t* sp = (const uint8_t*)SP;
+	const uint8_t* top = heap_top();
+	return (sp > top) ? (uint16_t)(sp - top) : 0U;
+}
+
+uint16_t devRamFreeMin() {
+	const uint8_t* p = heap_top();
+	const uint8_t* sp = (const uint8_t*)SP;
+	while ((p < sp) && (DEV_RAM_PAINT == *p))
+		++p;
+	return (uint16_t)(p - heap_top());
+}
@@ -0,0 +1,222 @@
+#include <Arduino.h>
+
+#include "project_config.h"
+#include "utils.h"
+#include "timer_serial.h"
+
+#if !defined(__AVR_ATmega328P__)
+ #error TimerSerial only supports the ATmega328.
+#endif
+
+DECLARE_QUEUE_TYPE(TimerSerialRx, uint8_t, CFG_TIMER_SERIAL_RX_BUFFER_SIZE)
+DECLARE_QUEUE_TYPE(TimerSerialTx, uint8_t, CFG_TIMER_SERIAL_TX_BUFFER_SIZE)
+
+// TX state is the bit that the compare unit has just started sending.
+enum {
+	TX_STATE_START = 0,
+	TX_STATE_LAST_DATA = 8,			// States 1..8 send data bits 0..7.
+	TX_STATE_STOP = 9,
+	TX_STATE_STOP_END = 10,			// Stop bit has been sent, waiting for another character.
+	TX_STATE_IDLE = 11,				// Compare interrupt disabled.
+};
+
+// RX state is the count of data bits received.
+enum {
+	RX_STATE_DATA_BITS = 8,
+	RX_STATE_IDLE = 0xff,			// Waiting for falling edge of start bit.
+};
+
+// Limit bit time so that a whole character fits in a signed 16 bit count of timer ticks.
+static const uint32_t TICKS_PER_BIT_MAX = 3000U;
+
+// TX starts this many ticks after write(), long enough that the timer cannot get past the compare value before it is written.
+static const uint16_t TX_START_DELAY_TICKS = 16U;
+
+static struct {
+	QueueTimerSerialRx rx_q;
+	QueueTimerSerialTx tx_q;
+	uint16_t ticks_per_bit;
+	uint16_t rx_stop_ticks;				// Time from the start bit edge to a quarter way into the stop bit.
+	volatile uint8_t tx_state;
+	uint8_t tx_byte;					// Shifted right as it is sent.
+	uint8_t rx_state;
+	uint8_t rx_byte;					// Bits are shifted in at the top.
+	uint16_t rx_target;					// Timer count at the middle of the next bit to receive.
+	volatile uint8_t overruns;
+} f_timer_serial;
+
+// TX line level at the next compare match.
+static inline void tx_set_level(uint8_t level) { TCCR1A = level ? (_BV(COM1A1) | _BV(COM1A0)) : _BV(COM1A1); }
+
+static void tx_start(uint8_t c) {
+	f_timer_serial.tx_byte = c;
+	f_timer_serial.tx_state = TX_STATE_START;
+	tx_set_level(0);
+	OCR1A = (uint16_t)(TCNT1 + TX_START_DELAY_TICKS);
+	TIFR1 = _BV(OCF1A);
+	TIMSK1 |= _BV(OCIE1A);
+}
+
+// The level set for the last compare match has just been output, so set the level for the next match one bit time on.
+static void tx_service() {
+	uint8_t state = f_timer_serial.tx_state;
+	OCR1A += f_timer_serial.ticks_per_bit;
+	if (state < TX_STATE_LAST_DATA) {
+		tx_set_level(f_timer_serial.tx_byte & 1U);
+		f_timer_serial.tx_byte >>= 1;
+		state += 1;
+	}
+	else if (TX_STATE_LAST_DATA == state) {
+		tx_set_level(1);
+		state = TX_STATE_STOP;
+	}
+	else if (queueTimerSerialTxGet(&f_timer_serial.tx_q, &f_timer_serial.tx_byte)) {	// Start bit follows the stop bit.
+		tx_set_level(0);
+		state = TX_STATE_START;
+	}
+	else if (TX_STATE_STOP == state)						// Line stays high, interrupt at the end of the stop bit.
+		state = TX_STATE_STOP_END;
+	else {
+		TIMSK1 &= (uint8_t)~_BV(OCIE1A);
+		state = TX_STATE_IDLE;
+	}
+	f_timer_serial.tx_state = state;
+}
+ISR(TIMER1_COMPA_vect) { tx_service(); }
+
+// If interrupts are disabled, say if a debug message is printed from an ISR, the TX interrupt has to be polled to make room in the buffer.
+static void tx_poll() {
+	if (!(SREG & _BV(SREG_I)) && (TIFR1 & _BV(OCF1A))) {
+		TIFR1 = _BV(OCF1A);
+		tx_service();
+	}
+}
+
+// Line level now as bit 7, which is the level before the edge that the capture unit is waiting for.
+static inline uint8_t rx_level() { return (TCCR1B & _BV(ICES1)) ? 0U : 0x80U; }
+
+static void rx_wait_start() {
+	TCCR1B &= (uint8_t)~_BV(ICES1);
+	TIFR1 = _BV(ICF1);					// Changing the edge can set the capture flag.
+	f_timer_serial.rx_state = RX_STATE_IDLE;
+}
+
+/* The capture edge is left alone as it follows the line, and the capture flag is not cleared as the start bit of the next char may already
+	have been captured. */
+static void rx_done() {
+	TIMSK1 &= (uint8_t)~_BV(OCIE1B);
+	if (!queueTimerSerialRxPut(&f_timer_serial.rx_q, &f_timer_serial.rx_byte) && (f_timer_serial.overruns < UINT8_MAX))
+		f_timer_serial.overruns += 1;
+	f_timer_serial.rx_state = RX_STATE_IDLE;
+}
+
+// Shift in a data bit, returns true when the character is complete.
+static bool rx_shift(uint8_t level) {
+	f_timer_serial.rx_byte = (uint8_t)((f_timer_serial.rx_byte >> 1) | level);
+	f_timer_serial.rx_target += f_timer_serial.ticks_per_bit;
+	return (++f_timer_serial.rx_state >= RX_STATE_DATA_BITS);
+}
+
+// The capture edge is toggled on every edge so that it always follows the line level.
+ISR(TIMER1_CAPT_vect) {
+	const uint16_t capture = ICR1;
+	const uint8_t level = rx_level();
+	TCCR1B ^= _BV(ICES1);
+	TIFR1 = _BV(ICF1);
+
+	if (RX_STATE_IDLE != f_timer_serial.rx_state) {		// All bits with their middle before this edge had the level before it.
+		while ((int16_t)(capture - f_timer_serial.rx_target) >= 0) {
+			if (rx_shift(level)) {
+				rx_done();
+				break;
+			}
+		}
+	}
+
+	/* Falling edge of start bit. This may follow finishing a char above, if it ended in 1 bits and the compare ISR in its stop bit was held off
+		past this edge, as then both are pending and this ISR has priority. Rising edges when idle are from the end of a break & are ignored. */
+	if ((RX_STATE_IDLE == f_timer_serial.rx_state) && level) {
+		f_timer_serial.rx_target = (uint16_t)(capture + f_timer_serial.ticks_per_bit + f_timer_serial.ticks_per_bit / 2U);
+		f_timer_serial.rx_state = 0;
+		OCR1B = (uint16_t)(capture + f_timer_serial.rx_stop_ticks);
+		TIFR1 = _BV(OCF1B);
+		TIMSK1 |= _BV(OCIE1B);
+	}
+}
+
+// In the stop bit, any data bits since the last edge have the current line level.
+ISR(TIMER1_COMPB_vect) {
+	const uint8_t level = rx_level();
+	while (!rx_shift(level))
+		/* empty */ ;
+	rx_done();
+}
+
+void TimerSerial::begin(uint32_t baud) {
+	uint32_t ticks = ((uint32_t)F_CPU + baud / 2U) / baud;
+	uint8_t clock_select = _BV(CS10);
+	if (ticks > TICKS_PER_BIT_MAX) {
+		ticks = ((uint32_t)F_CPU / 8U + baud / 2U) / baud;
+		clock_select = _BV(CS11);
+	}
+
+	const uint8_t sreg = SREG;
+	cli();
+	f_timer_serial.ticks_per_bit = (uint16_t)ticks;
+	f_timer_serial.rx_stop_ticks = (uint16_t)(ticks * 37U / 4U);
+	queueTimerSerialRxInit(&f_timer_serial.rx_q);
+	queueTimerSerialTxInit(&f_timer_serial.tx_q);
+	f_timer_serial.tx_state = TX_STATE_IDLE;
+	f_timer_serial.overruns = 0;
+
+	TIMSK1 = 0;
+	TCCR1A = _BV(COM1A1) | _BV(COM1A0);		// Normal mode, force OC1A high before it drives the pin so that TX idles high.
+	TCCR1B = _BV(ICNC1) | clock_select;		// Noise canceller delays capture by 4 clocks, same for all edges.
+	TCCR1C = _BV(FOC1A);
+	pinMode(TIMER_SERIAL_PIN_TX, OUTPUT);
+	pinMode(TIMER_SERIAL_PIN_RX, INPUT_PULLUP);
+	rx_wait_start();
+	TIMSK1 = _BV(ICIE1);
+	SREG = sreg;
+}
+
+void TimerSerial::end() {
+	flush();
+	TIMSK1 = 0;
+	TCCR1A = 0;
+	digitalWrite(TIMER_SERIAL_PIN_TX, HIGH);
+}
+
+int TimerSerial::available() { return queueTimerSerialRxLen(&f_timer_serial.rx_q); }
+int TimerSerial::read() {
+	uint8_t c;
+	return queueTimerSerialRxGet(&f_timer_serial.rx_q, &c) ? c : -1;
+}
+int TimerSerial::peek() {
+	return queueTimerSerialRxEmpty(&f_timer_serial.rx_q) ? -1 :
+	  f_timer_serial.rx_q.fifo[f_timer_serial.rx_q.head & queueTimerSerialRxMask()];
+}
+
+size_t TimerSerial::write(uint8_t c) {
+	while (1) {
+		const uint8_t sreg = SREG;
+		cli();
+		bool done = true;
+		if (TX_STATE_IDLE == f_timer_serial.tx_state)
+			tx_start(c);
+		else
+			done = queueTimerSerialTxPut(&f_timer_serial.tx_q, &c);
+		SREG = sreg;
+		if (done)
+			break;
+		tx_poll();								// Buffer full, wait for the ISR to send a character.
+	}
+	return 1;
+}
+
+void TimerSerial::flush() {
+	while (TX_STATE_IDLE != f_timer_serial.tx_state)
+		tx_poll();
+}
+
+uint8_t TimerSerial::overruns() { return f_timer_serial.overruns; }
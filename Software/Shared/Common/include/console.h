@@ -14,6 +14,9 @@ Define to allow different types for the 'cell'. console_cell_t must be a signed
 #if defined(AVR)
  typedef int16_t  console_cell_t;
  typedef uint16_t console_ucell_t;
+#elif defined(TEST)		// Host build for testing, a cell must be able to hold a pointer.
+ typedef intptr_t  console_cell_t;
+ typedef uintptr_t console_ucell_t;
 #else
  typedef int32_t  console_cell_t;
  typedef uint32_t console_ucell_t;
@@ -30,6 +33,21 @@ typedef bool (*console_recogniser_func)(char* cmd);
 // Hash function for implementing command lookup in recogniser functions. 
 uint16_t console_hash(const char* str);
 
+/* Commands may be looked up in a minimal perfect hash table generated by Tools/mk_console.py, rather than a switch on the hash value. The
+	generated header defines a handler function for each command, a displacement table and a command table, both in PROGMEM, and a recogniser
+	function that calls consoleCmdsLookup(). The table index for a command is found from the hash `h' as
+	`(uint16_t)((h ^ disp[h % disp_size]) * CONSOLE_CMDS_PHASH_MULT) % defs_size'. The script must agree with this. */
+#define CONSOLE_CMDS_PHASH_MULT 0x9e37U
+typedef void (*console_cmd_func)();
+typedef struct {
+	uint16_t hash;				// Hash of command name, verifies that a command matches.
+	console_cmd_func handler;	// Called when the command is matched.
+} console_cmd_def_t;
+
+/* Lookup a command in tables generated by mk_console.py, and if found call the handler and return true. Else return false. Lookup is
+	constant time regardless of the number of commands. */
+bool consoleCmdsLookup(const char* cmd, const uint8_t* disp, uint8_t disp_size, const console_cmd_def_t* defs, uint8_t defs_size);
+
 /* Initialise the console with a local recogniser for the special commands needed by the application.  
 	The Stream is the stream used for IO, and flags control echo, prompt, etc. 
 	Does not print anything to the stream, so you need to at least call consolePrompt() to give the user something to type at. 
@@ -55,6 +73,7 @@ enum {
 	CONSOLE_RC_ERROR_UNKNOWN_COMMAND =			4,	// A command or value was not recognised.
 	CONSOLE_RC_ERROR_ACCEPT_BUFFER_OVERFLOW =	5,	// Accept input buffer has been sent more characters than it can hold. Only returned by consoleAccept().
 	CONSOLE_RC_ERROR_INDEX_OUT_OF_RANGE =		6,	// Index out of range.
+	CONSOLE_RC_ERROR_SCRIPT_NESTED =			7,	// Scripts nested too deeply, only returned by consoleScriptRun().
 	CONSOLE_RC_ERROR_USER,							// Error codes available for the user.
 
 	// Status...
@@ -70,6 +89,17 @@ typedef int8_t console_rc_t;
 	positive error code. If no EOL, then it returns CONSOLE_RC_STATUS_ACCEPT_PENDING. */
 console_rc_t consoleService();
 
+/* Scripts are lines of commands separated by newlines, either `\r' or `\n', and terminated with a nul. Each line is run as if it had been typed,
+	but with no echo or prompt. The script stops on the first error, and the line number and the failing token are printed, e.g.
+	`Script line 2 at `FOO' '. The error code is returned and it is up to the caller to print it, usually by calling consoleRaise() if run from
+	a command. Scripts may be run from a command, and may nest up to CONSOLE_SCRIPT_NEST_MAX deep.
+	The read function returns the character at the given address, so scripts can be in RAM, PROGMEM or EEPROM. */
+#define CONSOLE_SCRIPT_NEST_MAX 2
+typedef char (*console_script_read_func)(const char* p);
+char consoleScriptReadRam(const char* p);
+char consoleScriptReadProgmem(const char* p);
+console_rc_t consoleScriptRun(const char* script, console_script_read_func rd);
+
 // Newline on output.
 #define CONSOLE_OUTPUT_NEWLINE_STR "\n"
 
@@ -0,0 +1,57 @@
+#ifndef LCD_FB_H__
+#define LCD_FB_H__
+
+/* Shadow framebuffer for a character LCD. Text is written to the framebuffer rather than the LCD, then lcdFbUpdate() compares it with what the
+	LCD is showing, and only sends runs of changed characters, each with a single cursor move. So redrawing a line with just one changed digit
+	sends one cursor move and one character, rather than a cursor move and a character for every column.
+	The LCD is written with two functions, so any driver can be used. Each returns false if the driver's queue is full, in which case the update
+	stops and the remaining changes are sent on the next update.
+	The framebuffer size is set by CFG_LCD_FB_COLS & CFG_LCD_FB_ROWS in project_config.h. */
+
+#include "project_config.h"		// cppcheck-suppress [missingInclude]
+
+#ifndef CFG_LCD_FB_COLS
+#define CFG_LCD_FB_COLS 16
+#endif
+#ifndef CFG_LCD_FB_ROWS
+#define CFG_LCD_FB_ROWS 2
+#endif
+
+// Bytes in the driver queue for a cursor move and for a character. These match AsyncLiquidCrystal, which queues an opcode and a data byte.
+enum {
+	LCD_FB_QUEUE_BYTES_CURSOR = 2,
+	LCD_FB_QUEUE_BYTES_CHAR = 2,
+};
+
+// Functions to write to the LCD, return false if the write could not be queued.
+typedef bool (*lcd_fb_set_cursor_func)(uint8_t col, uint8_t row);
+typedef bool (*lcd_fb_write_func)(uint8_t c);
+
+// Initialise with functions to write to the LCD. The LCD is assumed to have just been cleared, as it is after initialisation.
+void lcdFbInit(lcd_fb_set_cursor_func set_cursor, lcd_fb_write_func write);
+
+// Force the next update to redraw the whole display, call if the LCD might have been written or cleared by something else.
+void lcdFbInvalidate();
+
+// Set the position for the next write to the framebuffer.
+void lcdFbSetCursor(uint8_t col, uint8_t row);
+
+// Write a character to the framebuffer and advance the position. Characters past the end of the row are ignored.
+void lcdFbWrite(char c);
+
+// Write spaces from the current position to the end of the row.
+void lcdFbClearToEol();
+
+// Send changes in the framebuffer to the LCD. Returns true if the LCD is now up to date, false if the driver queue was full.
+bool lcdFbUpdate();
+
+/* Counts of bytes written to the driver queue, and bytes that would have been written if every lcdFbSetCursor() & lcdFbWrite() call had gone
+	directly to the driver. The bytes saved is the difference. */
+typedef struct {
+	uint32_t queued;
+	uint32_t direct;
+} lcd_fb_stats_t;
+const lcd_fb_stats_t* lcdFbStats();
+static inline int32_t lcdFbBytesSaved() { return (int32_t)(lcdFbStats()->direct - lcdFbStats()->queued); }
+
+#endif // LCD_FB_H__
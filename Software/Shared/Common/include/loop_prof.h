@@ -0,0 +1,54 @@
+#ifndef LOOP_PROF_H__
+#define LOOP_PROF_H__
+
+/* Main loop profiler. Call loopProfStart() at the top of the loop, then loopProfMark(idx) after each service call, which charges the time since
+	the last mark to service idx. The time source is micros(), which on AVR reads the free running timer 0, so the resolution is 4us.
+	Min, max & mean times are kept for each service and for the whole loop, along with the service times for the slowest loop seen, so that the
+	service that blew the loop budget can be found. Times are in us, saturating at 65535.
+	Enabled by CFG_WANT_LOOP_PROF in project_config.h, else the start & mark functions do nothing. */
+
+#include "project_config.h"		// cppcheck-suppress [missingInclude]
+
+#ifndef CFG_WANT_LOOP_PROF
+#define CFG_WANT_LOOP_PROF 0
+#endif
+
+#ifndef CFG_LOOP_PROF_SERVICE_COUNT
+#define CFG_LOOP_PROF_SERVICE_COUNT 5
+#endif
+
+typedef struct {
+	uint16_t min, max;
+	uint32_t total;				// Sum of times for the mean.
+	uint16_t count;				// Number of times, total & count are halved when the count would overflow so the mean is still valid.
+} loop_prof_stat_t;
+
+// Service times for the slowest loop.
+typedef struct {
+	uint16_t loop;
+	uint16_t services[CFG_LOOP_PROF_SERVICE_COUNT];
+} loop_prof_worst_t;
+
+// Clear all stats, call at startup.
+void loopProfReset();
+
+#if CFG_WANT_LOOP_PROF
+// Start timing a loop, this ends timing the previous loop.
+void loopProfStart();
+
+// Charge time since the last call to loopProfStart() or loopProfMark() to service idx.
+void loopProfMark(uint8_t idx);
+#else
+static inline void loopProfStart() { /* empty */ }
+static inline void loopProfMark(uint8_t idx) { (void)idx; }
+#endif
+
+// Stats for a service, or for the whole loop with idx CFG_LOOP_PROF_SERVICE_COUNT.
+const loop_prof_stat_t* loopProfStat(uint8_t idx);
+static inline uint16_t loopProfMean(const loop_prof_stat_t* s) { return s->count ? (uint16_t)(s->total / s->count) : 0U; }
+
+// Service times for the slowest loop, and the index of the service that took longest in that loop.
+const loop_prof_worst_t* loopProfWorst();
+uint8_t loopProfWorstService();
+
+#endif // LOOP_PROF_H__
@@ -0,0 +1,40 @@
+#ifndef MODBUS_RBE_H__
+#define MODBUS_RBE_H__
+
+#include "buffer.h"
+
+/* Report by exception for a block of holding registers, so that a slave whose values rarely change sends a short response to a poll.
+	The master sends a normal read holding registers request for the block at an address that the slave has set aside for it. The slave
+	responds with a mask of the registers that have changed since they were last reported, then only the values of those registers:
+
+	REQ: [ID FC=3 addr:16 count:16] RESP: [ID FC=3 byte-count mask:16 value:16 for each bit set in mask, lsb first]
+
+	A register has changed if it differs from the last value reported by more than its deadband, the difference is taken as signed so that
+	signed & unsigned values both work. A deadband of zero reports any change, and UINT16_MAX never reports a change. If max_silence_ms has
+	passed since all registers were last reported then all are reported, so that the master can never be out by more than the deadband for
+	long, even if a response is lost. The first response after init reports all registers. */
+
+enum { MODBUS_RBE_REGS_MAX = 16 };		// One bit each in the mask.
+
+typedef struct {
+	uint16_t reported[MODBUS_RBE_REGS_MAX];		// Values last reported.
+	uint32_t reported_all_ms;					// millis() when all registers were last reported.
+	bool report_all;							// Set to report all registers in the next response.
+} modbus_rbe_t;
+
+// Slave. Initialise so that the next response reports all registers.
+void modbusRbeInit(modbus_rbe_t* rbe);
+
+// Slave. Return a mask of registers that have changed from the values last reported, or all if they are due for reporting.
+uint16_t modbusRbeChanges(const modbus_rbe_t* rbe, const uint16_t* values, const uint16_t* deadbands, uint8_t count, uint16_t max_silence_ms);
+
+/* Slave. Build a response, without the CRC, with the ID & function code from the request, for the registers in the mask, and record them as
+	reported. Returns false if the response does not fit the buffer. */
+bool modbusRbeBuildResponse(modbus_rbe_t* rbe, BufferDynamic& response, const BufferDynamic& request, const uint16_t* values, uint8_t count,
+  uint16_t mask);
+
+/* Master. Check a response with the CRC to a request for count registers, returns false if it is invalid. Else sets the mask and writes the
+	values of the registers in the mask, leaving the others. */
+bool modbusRbeParseResponse(const BufferDynamic& response, uint8_t count, uint16_t* values, uint16_t* mask);
+
+#endif // MODBUS_RBE_H__
@@ -0,0 +1,36 @@
+#ifndef POLL_BACKOFF_H__
+#define POLL_BACKOFF_H__
+
+/* Back-off for polling a device that may stop responding, like a MODBUS slave, on a schedule made of passes. Each device has a context that
+	counts polls sent since the last response. A device that misses more than a threshold of polls in a row is backed off, and is then only
+	due for a poll after 1, 2, 4... passes, up to 2^backoff_max passes. The first response puts it back to a poll on every pass.
+	The threshold & limit are arguments rather than stored, so that they can live in registers and be changed at any time. */
+
+#include <stdint.h>
+
+// Largest value for backoff_max, so that the wait fits in a byte.
+static constexpr uint8_t POLL_BACKOFF_MAX = 7;
+
+typedef struct {
+	uint8_t misses;				// Polls sent with no response since the last response, saturates at 255.
+	uint8_t backoff;			// Log2 of passes between polls for the next poll when backed off.
+	uint8_t wait;				// Passes left to skip before a backed off device is due.
+} poll_backoff_t;
+
+// Set to not backed off with no misses.
+void pollBackoffInit(poll_backoff_t* b);
+
+// Returns true if the device has missed more than threshold polls in a row, so it is faulty and backed off.
+static inline bool pollBackoffIsBackedOff(const poll_backoff_t* b, uint8_t threshold) { return b->misses > threshold; }
+
+/* Call once on each pass for a backed off device, returns true if it is due for a poll. Counts down the wait, and a device that is due stays
+	due until it is polled, so that the caller may poll only one device per pass. */
+bool pollBackoffIsDue(poll_backoff_t* b);
+
+// Call when a poll is sent. If the device is backed off then the wait to the next poll is doubled up to the limit.
+void pollBackoffSent(poll_backoff_t* b, uint8_t threshold, uint8_t backoff_max);
+
+// Call when a response is received, returns true if the device was backed off.
+bool pollBackoffResponse(poll_backoff_t* b, uint8_t threshold);
+
+#endif // POLL_BACKOFF_H__
@@ -27,9 +27,41 @@ bool regsWriteMaskFlags(regs_t mask, bool s);
 // Update bits in flags register with set bits in mask m with mask value. Return true if value has changed.
 bool regsUpdateMaskFlags(regs_t mask, regs_t val);
 
+// Write a register, return true if value has changed. Only needed if change notification is required, else just write REGS[idx].
+bool regsWrite(uint8_t idx, regs_t val);
+
+/* Change notification. Writes by regsWrite(), regsWriteMask() & regsUpdateMask() that change a value set a dirty bit for the register, and call
+	the change callback if the register has been subscribed. Writes directly to REGS[] are not seen, so registers that nobody subscribes to
+	can still be written directly. The callback may be called from an ISR if the register is written in one. */
+#define REGS_MASK_SIZE ((COUNT_REGS + 7) / 8)
+typedef void (*regs_change_func)(uint8_t idx, regs_t val);
+
+// Set the function called on change of subscribed registers, NULL to disable.
+void regsChangeSetCallback(regs_change_func cb);
+
+// Subscribe or unsubscribe to changes for a register.
+void regsChangeSubscribe(uint8_t idx, bool s);
+
+// Return true if the register has changed since the last call, and clear the dirty bit.
+bool regsChangeTestAndClear(uint8_t idx);
+
+// Clear all dirty bits, subscriptions and the callback.
+void regsChangeReset();
+
 // Print register value to console
 void regsPrintValue(uint8_t reg_idx);
 
+/* Binary register stream, much cheaper than printing registers as text. A packet is:
+	sync: A5 5A, len:u8, seq:u8, timestamp:u32, mask-size:u8, mask:u8[mask-size], values:u16[n], crc:u16
+	The mask has bit (idx % 8) in byte (idx / 8) set for each register included, n is the number of set bits. The len byte counts the bytes from
+	seq to the end of the values. The CRC is the MODBUS CRC of len through the values. All multibyte values are little endian. */
+enum { REGS_STREAM_SYNC_0 = 0xa5, REGS_STREAM_SYNC_1 = 0x5a };
+#define REGS_STREAM_MASK_SIZE REGS_MASK_SIZE
+#define REGS_STREAM_PACKET_SIZE_MAX (2 + 1 + 1 + 4 + 1 + REGS_STREAM_MASK_SIZE + 2 * COUNT_REGS + 2)
+
+// Write a packet for the registers selected by the mask to the buffer, which must be at least REGS_STREAM_PACKET_SIZE_MAX bytes. Returns size.
+uint8_t regsStreamMakePacket(uint8_t* buf, const uint8_t* mask, uint8_t seq, uint32_t timestamp);
+
 // Set all regs to default values.
 void regsSetDefaultAll();
 
@@ -23,6 +23,8 @@ typedef struct {
 	uint8_t repeat_timer;
 	uint8_t hold:7;       				// Hold timer, counts up, limited to 7 bits. 
     uint8_t pstate:1;      				// Flag holds previous state of switch at last scan. 
+	uint8_t port_idx;					// Port scan mode only, index into ports.
+	uint8_t port_mask;					// Port scan mode only, bit in port.
 } sw_scan_context_t;
 #define SW_SCAN_TIMER_MAX 0x7f
 
@@ -30,4 +32,37 @@ void swScanReset(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t
 void swScanInit(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count);
 void swScanSample(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count);
 
+/* Port scan mode, use instead of swScanInit() & swScanSample(). The switches are grouped by port at init, then each scan reads each port input
+	register once and debounces all switches on the port in parallel with a vertical counter, so a switch must read the same for 4 scans to
+	change state. The debounced state drives the same click, hold, long-hold & repeat logic as swScanSample(), and the action delay still
+	applies after debouncing. */
+#ifndef SW_SCAN_PORTS_MAX
+#define SW_SCAN_PORTS_MAX 3
+#endif
+typedef struct {
+	volatile uint8_t* pin_reg;			// Port input register.
+	uint8_t mask;						// Bits used by switches.
+	uint8_t invert;						// Bits for active low switches.
+	uint8_t cnt0, cnt1;					// Vertical counter, bit n of cnt1:cnt0 is the count for bit n.
+	uint8_t state;						// Debounced state, bit set if switch active.
+} sw_scan_port_t;
+typedef struct {
+	sw_scan_port_t ports[SW_SCAN_PORTS_MAX];
+	uint8_t port_count;
+} sw_scan_ports_t;
+
+void swScanInitPorts(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count, sw_scan_ports_t* ports);
+void swScanSamplePorts(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count, sw_scan_ports_t* ports);
+
+/* Debounce all bits in sample with a 2 bit vertical counter. A bit in state changes only when the sample has been different for 4 calls, any
+	sample the same as the state resets the count. Returns the new state. */
+static inline uint8_t swScanDebounce(sw_scan_port_t* p, uint8_t sample) {
+	uint8_t changed = p->state ^ sample;
+	p->cnt0 = (uint8_t)~(p->cnt0 & changed);			// Reset or count bit 0.
+	p->cnt1 = (uint8_t)(p->cnt0 ^ (p->cnt1 & changed));	// Reset or count bit 1.
+	changed &= (uint8_t)(p->cnt0 & p->cnt1);				// Count rolled over?
+	p->state ^= changed;
+	return p->state;
+}
+
 #endif // SW_SCANNER_H__
@@ -142,4 +142,71 @@ static inline int8_t threadRun(thread_control_t* tcb, thread_t thread, void* arg
 	return thread(arg);
 }
 
+/* Scheduler. Rather than calling each thread every loop with threadRun(), threads may be registered with the scheduler, which only runs threads
+	that are ready. A thread is taken off the ready list by sleeping for a number of ticks with THREAD_SLEEP(), or by blocking with THREAD_BLOCK()
+	until woken by threadSchedWake(). Sleeping threads are kept on a list sorted by wake time, so the scheduler only checks the head of the list.
+	A thread that waits with THREAD_WAIT_UNTIL() or yields stays ready and is run on every call to threadSchedService(), as with threadRun().
+	A thread that exits is removed.
+	Sleep times must be less than half the range of thread_ticks_t. */
+
+enum {
+	THREAD_SCHED_STATE_READY,
+	THREAD_SCHED_STATE_SLEEPING,
+	THREAD_SCHED_STATE_BLOCKED,
+	THREAD_SCHED_STATE_DONE,
+};
+
+/* Each scheduled thread has one of these, the scheduler links them into its lists so no memory is allocated. */
+typedef struct _thread_sched_tcb_t {
+	thread_control_t tc;
+	thread_t thread;
+	void* arg;
+	struct _thread_sched_tcb_t* next;	/* Link in ready or sleep list. */
+	thread_ticks_t wake;				/* Tick time to wake when sleeping. */
+	uint8_t state;
+	int8_t rc;							/* Return code when done. */
+} thread_sched_tcb_t;
+
+/* Remove all threads from the scheduler. */
+void threadSchedInit();
+
+/* Initialise a thread and add it to the ready list. */
+void threadSchedAdd(thread_sched_tcb_t* tcb, thread_t thread, void* arg);
+
+/* Wake any sleeping threads whose time is up, then run each ready thread once. Threads woken while running run on the next call.
+	Returns the number of threads run. */
+uint8_t threadSchedService();
+
+/* Make a sleeping or blocked thread ready. No effect on a ready or done thread. */
+void threadSchedWake(thread_sched_tcb_t* tcb);
+
+/* Called from a scheduled thread before yielding to sleep or block, use the macros below. */
+void threadSchedSleep(thread_ticks_t ticks);
+void threadSchedBlock();
+
+/* Sleep for a number of ticks. */
+#define THREAD_SLEEP(ticks_) do {											\
+	threadSchedSleep(ticks_);												\
+	THREAD_YIELD();															\
+  } while (0)
+
+/* Sleep until a delay started with THREAD_START_DELAY() is done. Unlike THREAD_WAIT_UNTIL(THREAD_IS_DELAY_DONE(delay_)) this does not wait
+	for the delay if the thread is woken by threadSchedWake(), it returns early with the delay not done. So a thread can wait for an event
+	with a timeout, check THREAD_IS_DELAY_DONE() after to see which. */
+#define THREAD_SLEEP_UNTIL_DELAY_DONE(delay_) do {							\
+	if (!THREAD_IS_DELAY_DONE(delay_))										\
+		THREAD_SLEEP((thread_ticks_t)((thread_ticks_t)(delay_) + 1U - (threadGetTicks() - g_currentThread->then)));	\
+  } while (0)
+
+/* Block until woken by threadSchedWake(). */
+#define THREAD_BLOCK() do {													\
+	threadSchedBlock();														\
+	THREAD_YIELD();															\
+  } while (0)
+
+/* Block until a condition is true, the condition is tested again each time the thread is woken. */
+#define THREAD_BLOCK_UNTIL(cond_)											\
+	while (!(cond_))														\
+		THREAD_BLOCK()
+
 #endif
@@ -338,17 +338,98 @@ T utilsRescale(T input_value, T max_input, T max_output) {
 
    After executing `multiThreshold(THRESHOLDS,  ELEMENT_COUNT(THRESHOLDS),	HYSTERESIS, &level, x)', as x ranges from 0 .. 600 .. 0, level changes so,
     with the function returning true if level has changed.
-	0..49	  0
-	50.. 99   1
-	100..499  2
-	500..600  3
-	600.. 480 3
-	479.. 80  2
-	79..30    1
-	29..0     0
+	0..50	  0
+	51..100   1
+	101..500  2
+	501..600  3
+	600..481  3
+	480..81   2
+	80..31    1
+	30..0     0
 */
 bool utilsMultiThreshold(const uint16_t* thresholds, uint8_t count, uint16_t hysteresis, uint8_t* level, uint16_t val);
 
+// Read a value of any type from PROGMEM.
+template <typename T>
+T utilsReadProgmem(const T* p) { T x; memcpy_P(&x, p, sizeof(T)); return x; }
+
+/* Multiple threshold comparator for larger tables, as utilsMultiThreshold() but for any integral type and with a hysteresis value for each
+	threshold. The current level is checked first, and as the value usually stays in the same band most calls are done with two compares. Else
+	the new level is found with a binary search of the thresholds on the side of the current band that the value has moved to.
+	Thresholds is a PROGMEM table sorted ascending, hysteresis is a PROGMEM table of the same size, or NULL for no hysteresis. The thresholds less
+	their hysteresis must also be ascending, so a band may not be narrower than the hysteresis on its lower threshold, and for signed types the
+	subtraction must not underflow. For unsigned types a hysteresis larger than the threshold lowers it to zero.
+	Returns true if level has changed. */
+template <typename T>
+T utils_multi_threshold_get(const T* thresholds, const T* hysteresis, T hysteresis_all, uint8_t level, uint8_t i) {
+	const T t = utilsReadProgmem(&thresholds[i]);
+	if (i >= level)
+		return t;
+	const T h = (NULL != hysteresis) ? utilsReadProgmem(&hysteresis[i]) : hysteresis_all;
+	return (!utilsIsTypeSigned(T) && (h > t)) ? (T)0 : (T)(t - h);
+}
+template <typename T>
+uint8_t utils_multi_threshold_search(const T* thresholds, const T* hysteresis, T hysteresis_all, uint8_t count, uint8_t level, T val) {
+	if (level > count)
+		level = count;
+
+	// New level is in lo..hi inclusive, and is the index of the first threshold that val is not above, or count if none.
+	uint8_t lo, hi;
+	if ((level > 0) && !(val > utils_multi_threshold_get(thresholds, hysteresis, hysteresis_all, level, (uint8_t)(level - 1U)))) {
+		lo = 0;
+		hi = (uint8_t)(level - 1U);
+	}
+	else if ((level < count) && (val > utils_multi_threshold_get(thresholds, hysteresis, hysteresis_all, level, level))) {
+		lo = (uint8_t)(level + 1U);
+		hi = count;
+	}
+	else
+		return level;
+
+	while (lo < hi) {
+		const uint8_t mid = (uint8_t)(lo + (hi - lo) / 2U);
+		if (val > utils_multi_threshold_get(thresholds, hysteresis, hysteresis_all, level, mid))
+			lo = (uint8_t)(mid + 1U);
+		else
+			hi = mid;
+	}
+	return lo;
+}
+template <typename T>
+bool utilsMultiThresholdTable(const T* thresholds, const T* hysteresis, uint8_t count, uint8_t* level, T val) {
+	const uint8_t new_level = utils_multi_threshold_search<T>(thresholds, hysteresis, (T)0, count, *level, val);
+	const bool changed = (*level != new_level);
+	*level = new_level;
+	return changed;
+}
+#define utilsMultiThresholdTableU16 utilsMultiThresholdTable<uint16_t>
+#define utilsMultiThresholdTableI16 utilsMultiThresholdTable<int16_t>
+
+/* Piecewise linear scaler, an array of segments in PROGMEM made by mk_tables.py from a list of points. A segment applies from x0 up to x0 of
+	the next one, the output is y0 + (x - x0) * slope / 2^16, rounded. The last segment has zero slope so the output is held at the last point for
+	larger inputs, and the output is held at the first point for inputs below it. No division is done, so this is much faster than
+	utilsRescaleU16() on the AVR. */
+typedef struct {
+	uint16_t x0;
+	uint16_t y0;
+	int32_t slope;
+} UtilsScalerSegment;
+uint16_t utilsScale(const UtilsScalerSegment* segs, uint8_t count, uint16_t x);
+
+/* Lookup in a PROGMEM table with linear interpolation between entries, the top bits of x index the table & the low `shift' bits interpolate
+	between entry & the next. So a table for inputs 0..2^n needs 2^(n-shift)+1 entries, e.g. 17 entries with a shift of 6 covers a 10 bit ADC.
+	The difference between adjacent entries times 2^shift must fit in an int32_t. */
+template <typename T>
+T utilsTableInterpolate(const T* table, uint8_t shift, uint16_t x) {
+	const uint16_t idx = (uint16_t)(x >> shift);
+	const int32_t frac = (int32_t)(x & ((1U << shift) - 1U));
+	const T y0 = utilsReadProgmem(&table[idx]);
+	if (0 == frac)
+		return y0;
+	const int32_t dy = (int32_t)utilsReadProgmem(&table[idx + 1U]) - (int32_t)y0;
+	return (T)((int32_t)y0 + ((dy * frac + (1L << (shift - 1U))) >> shift));
+}
+
 /* Simple filter code, y[n] = (1-a).y[n-1] + a.x[n]. Replacing the last term by a.(x[n]+x[n-1])/2 makes it look like a first order RC.
 	Rewrite:   y[n]	= y[n-1] - a.y[n-1] + a.x[n]
 					= y[n-1] - a.(y[n-1] + x[n])
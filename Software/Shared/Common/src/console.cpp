@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <setjmp.h>		// Need this for implementing exceptions.
 
 #include "console.h"
@@ -28,6 +29,10 @@ STATIC_ASSERT(!isTypeSigned(console_ucell_t));
 #else
  #define PSTR(str_) (str_)
  #define CONSOLE_READ_FUNC_PTR(x_) (*(x_))					// Generic target.
+ #ifndef pgm_read_byte
+  #define pgm_read_byte(x_) (*(x_))
+  #define pgm_read_word(x_) (*(x_))
+ #endif
 #endif
 
 // Stack size, we don't need much.
@@ -61,6 +66,7 @@ static struct {
 	uint8_t flags;									// Modify behaviour of console, prompt, echo...
 	char inbuf[CONSOLE_INPUT_BUFFER_SIZE + 1];		// Input buffer.
 	uint8_t inbidx;									// Next free location in input buffer.
+	uint8_t script_depth;							// Nesting depth of running scripts.
 } f_ctx;
 
 // Make input buffer ready to accept new data.
@@ -107,6 +113,16 @@ uint16_t console_hash(const char* str) {
 	return h;
 }
 
+bool consoleCmdsLookup(const char* cmd, const uint8_t* disp, uint8_t disp_size, const console_cmd_def_t* defs, uint8_t defs_size) {
+	const uint16_t h = console_hash(cmd);
+	const uint8_t d = pgm_read_byte(&disp[h % disp_size]);
+	const console_cmd_def_t* def = &defs[(uint16_t)((h ^ d) * CONSOLE_CMDS_PHASH_MULT) % defs_size];
+	if (pgm_read_word(&def->hash) != h)		// Every hash maps to some command, so verify it.
+		return false;
+	((console_cmd_func)CONSOLE_READ_FUNC_PTR(&def->handler))();
+	return true;
+}
+
 // Convert a single character in range [0-9a-zA-Z] to a number up to 35. A large value (255) is returned on error.
 static uint8_t convert_digit(char c) {
 	if ((c >= '0') && (c <= '9'))
@@ -131,7 +147,7 @@ static bool convert_number(console_ucell_t* number, console_cell_t base, const c
 			return false;		   /* Cannot convert with current base. */
 
 		const console_ucell_t old_number = *number;
-		*number = *number * base + digit;
+		*number = *number * (console_ucell_t)base + digit;
 		if (old_number > *number)		// Magnitude change signals overflow.
 			consoleRaise(CONSOLE_RC_ERROR_NUMBER_OVERFLOW);
 	}
@@ -167,6 +183,7 @@ static const char* get_error_desc(console_rc_t err) {
 		case CONSOLE_RC_ERROR_UNKNOWN_COMMAND: return PSTR("unknown command");
 		case CONSOLE_RC_ERROR_INDEX_OUT_OF_RANGE: return PSTR("index out of range");
 		case CONSOLE_RC_ERROR_ACCEPT_BUFFER_OVERFLOW: return PSTR("input buffer overflow");
+		case CONSOLE_RC_ERROR_SCRIPT_NESTED: return PSTR("scripts nested too deep");
 		default: return PSTR("???");
 	}
 }
@@ -210,7 +227,7 @@ bool console_r_number_decimal(char* cmd) {
 	}
 
 	// Success.
-	consoleStackPush(result);
+	consoleStackPush((console_cell_t)result);
 	return true;
 }
 
@@ -225,7 +242,7 @@ bool console_r_number_hex(char* cmd) {
 		return false;
 
 	// Success.
-	consoleStackPush(result);
+	consoleStackPush((console_cell_t)result);
 	return true;
 }
 
@@ -322,7 +339,7 @@ static const console_recogniser_func RECOGNISERS[] PROGMEM = {
 };
 
 /* Execute a single command from a string. Sets up a handler for exceptions and will pass error code back to caller. */
-static uint8_t execute(char* cmd) {
+static console_rc_t execute(char* cmd) {
 	// Establish a point where consoleRaise will go to if called.
 	console_rc_t command_rc = (console_rc_t)setjmp(f_ctx.jmpbuf); 	// When called in normal execution it returns zero.
 	if (CONSOLE_RC_OK != command_rc)								// We got an error, back to caller. 
@@ -338,11 +355,14 @@ static uint8_t execute(char* cmd) {
 	return CONSOLE_RC_ERROR_UNKNOWN_COMMAND;
 }
 
-static console_rc_t console_process(char* str) {
+/* Process all tokens in a line. On error the failing token is written to err_token. Uses strtok_r() as a script might be run from a command, which
+	processes another line before this one is finished. */
+static console_rc_t console_process(char* str, const char** err_token) {
 	const char wsp[] = " \t";		// These chars separate tokens in input.
+	char* save_ptr;
 	
 	// Start off getting first token (if any) from input buffer, separated by characters in second arg. 
-	char* cmd_or_arg = strtok(str, wsp);
+	char* cmd_or_arg = strtok_r(str, wsp, &save_ptr);
 	
 	while (NULL != cmd_or_arg) {
 		// Execute parsed command and exit on any abort, so that we do not execute any more commands.
@@ -353,11 +373,13 @@ static console_rc_t console_process(char* str) {
 			 return CONSOLE_RC_OK;
 			
 		// Exit on abort code.
-		if (command_rc > (console_rc_t)CONSOLE_RC_OK)	
-			 return command_rc;
+		if (command_rc > (console_rc_t)CONSOLE_RC_OK) {
+			*err_token = cmd_or_arg;
+			return command_rc;
+		}
 		
 		// Get next command or argument from input buffer, note that pointer arg is NULL.
-		cmd_or_arg = strtok(NULL, wsp);
+		cmd_or_arg = strtok_r(NULL, wsp, &save_ptr);
 	}
 	return CONSOLE_RC_OK;
 }
@@ -369,6 +391,7 @@ void consoleInit(console_recogniser_func r, Stream& s, uint8_t flags) {
 	f_ctx.local_r = r;
 	f_ctx.s = &s;
 	f_ctx.flags = flags;
+	f_ctx.script_depth = 0;
 	consoleStackClear();
 	console_accept_clear();
 	// We do not set f_ctx.jmpbuf, there is no safe value.
@@ -394,8 +417,10 @@ console_rc_t consoleService() {
 				f_ctx.s->print(f_ctx.inbuf);					// Echo input line back to terminal.
 				f_ctx.s->print(F(" -> ")); 						// Seperator string for output.
 			}
-			if (CONSOLE_RC_OK == rc)							// If accept has _NOT_ returned an error (probably overflow)...
-				rc = console_process(f_ctx.inbuf);				// Process input string from input buffer filled by accept and record error code.
+			if (CONSOLE_RC_OK == rc) {							// If accept has _NOT_ returned an error (probably overflow)...
+				const char* err_token;
+				rc = console_process(f_ctx.inbuf, &err_token);	// Process input string from input buffer filled by accept and record error code.
+			}
 			if (CONSOLE_RC_OK != rc) {							// If all went well then we get an OK status code
 				f_ctx.s->print(F("Error: ")); 					// Print error code:(
 				f_ctx.s->print((const __FlashStringHelper *)get_error_desc(rc)); // Print error description.
@@ -409,6 +434,56 @@ console_rc_t consoleService() {
 	return CONSOLE_RC_STATUS_ACCEPT_PENDING;
 }
 
+char consoleScriptReadRam(const char* p) { return *p; }
+char consoleScriptReadProgmem(const char* p) { return (char)pgm_read_byte(p); }
+
+console_rc_t consoleScriptRun(const char* script, console_script_read_func rd) {
+	if (f_ctx.script_depth >= CONSOLE_SCRIPT_NEST_MAX)
+		return CONSOLE_RC_ERROR_SCRIPT_NESTED;
+	f_ctx.script_depth += 1;
+	jmp_buf saved_jmpbuf;						// We might have been called from a command, so save the abort point for the command's line.
+	memcpy(saved_jmpbuf, f_ctx.jmpbuf, sizeof(jmp_buf));
+
+	char line[CONSOLE_INPUT_BUFFER_SIZE + 1];	// Own buffer as the input buffer may be in use by the line that ran us.
+	uint8_t lidx = 0;
+	uint16_t lineno = 1;
+	console_rc_t rc = CONSOLE_RC_OK;
+	char c;
+	do {
+		c = rd(script++);
+		if (('\r' == c) || ('\n' == c) || ('\0' == c)) {		// On end of line run it...
+			const char* err_token = line;
+			if (lidx >= sizeof(line))
+				rc = CONSOLE_RC_ERROR_ACCEPT_BUFFER_OVERFLOW;
+			else {
+				line[lidx] = '\0';
+				rc = console_process(line, &err_token);
+			}
+			if (CONSOLE_RC_OK != rc) {
+				line[sizeof(line) - 1] = '\0';						// Line might not be terminated on overflow.
+				consolePrint(CFMT_STR_P, (console_cell_t)PSTR("Script line"));
+				consolePrint(CFMT_U|CFMT_M_NO_LEAD, (console_cell_t)lineno);
+				consolePrint(CFMT_STR_P|CFMT_M_NO_SEP, (console_cell_t)PSTR("at `"));
+				consolePrint(CFMT_STR|CFMT_M_NO_SEP, (console_cell_t)err_token);
+				consolePrint(CFMT_STR_P, (console_cell_t)PSTR("'"));
+				break;
+			}
+			lidx = 0;
+			lineno += 1;
+		}
+		else if ((c >= ' ') && (c < (char)0x7f)) {			// Printable chars are added to the line, as consoleAccept().
+			if (lidx < sizeof(line))
+				line[lidx] = c;
+			if (lidx < 255)
+				lidx += 1;
+		}
+	} while ('\0' != c);
+
+	memcpy(f_ctx.jmpbuf, saved_jmpbuf, sizeof(jmp_buf));
+	f_ctx.script_depth -= 1;
+	return rc;
+}
+
 void consolePrint(uint8_t opt, console_cell_t x) {
 	switch (opt & 0x3f) {
 		case CFMT_NL:		f_ctx.s->print(F(CONSOLE_OUTPUT_NEWLINE_STR)); (void)x; return; 	// Newline with no separator.
@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "lcd_fb.h"
+
+static struct {
+	lcd_fb_set_cursor_func set_cursor;
+	lcd_fb_write_func write;
+	char shown[CFG_LCD_FB_ROWS][CFG_LCD_FB_COLS];	// What the LCD is showing.
+	char next[CFG_LCD_FB_ROWS][CFG_LCD_FB_COLS];	// What we want it to show.
+	uint8_t col, row;								// Write position in next.
+	bool redraw;									// Redraw all on next update as LCD contents unknown.
+	lcd_fb_stats_t stats;
+} f_lcd_fb;
+
+void lcdFbInit(lcd_fb_set_cursor_func set_cursor, lcd_fb_write_func write) {
+	memset(&f_lcd_fb, 0, sizeof(f_lcd_fb));
+	f_lcd_fb.set_cursor = set_cursor;
+	f_lcd_fb.write = write;
+	memset(f_lcd_fb.shown, ' ', sizeof(f_lcd_fb.shown));
+	memset(f_lcd_fb.next, ' ', sizeof(f_lcd_fb.next));
+}
+
+void lcdFbInvalidate() { f_lcd_fb.redraw = true; }
+
+void lcdFbSetCursor(uint8_t col, uint8_t row) {
+	f_lcd_fb.col = col;
+	f_lcd_fb.row = utilsLimitMax<uint8_t>(row, CFG_LCD_FB_ROWS - 1);
+	f_lcd_fb.stats.direct += LCD_FB_QUEUE_BYTES_CURSOR;
+}
+
+void lcdFbWrite(char c) {
+	if (f_lcd_fb.col < CFG_LCD_FB_COLS)
+		f_lcd_fb.next[f_lcd_fb.row][f_lcd_fb.col++] = c;
+	f_lcd_fb.stats.direct += LCD_FB_QUEUE_BYTES_CHAR;
+}
+
+void lcdFbClearToEol() {
+	while (f_lcd_fb.col < CFG_LCD_FB_COLS)
+		lcdFbWrite(' ');
+}
+
+bool lcdFbUpdate() {
+	if (f_lcd_fb.redraw) {				// Make every character look different, so if the update stops part way it carries on next time.
+		f_lcd_fb.redraw = false;
+		fori (CFG_LCD_FB_ROWS) {
+			forj (CFG_LCD_FB_COLS)
+				f_lcd_fb.shown[i][j] = (char)~f_lcd_fb.next[i][j];
+		}
+	}
+
+	fori (CFG_LCD_FB_ROWS) {
+		const char* next = f_lcd_fb.next[i];
+		char* shown = f_lcd_fb.shown[i];
+		uint8_t col = 0;
+		while (col < CFG_LCD_FB_COLS) {
+			if (next[col] == shown[col]) {
+				col += 1;
+				continue;
+			}
+
+			// Start of a run of changed characters, the LCD advances the cursor after each character.
+			if (!f_lcd_fb.set_cursor(col, i))
+				return false;
+			f_lcd_fb.stats.queued += LCD_FB_QUEUE_BYTES_CURSOR;
+			do {
+				if (!f_lcd_fb.write((uint8_t)next[col]))
+					return false;				// Characters not sent are still different so will be sent next time.
+				f_lcd_fb.stats.queued += LCD_FB_QUEUE_BYTES_CHAR;
+				shown[col] = next[col];
+				col += 1;
+			} while ((col < CFG_LCD_FB_COLS) && (next[col] != shown[col]));
+		}
+	}
+	return true;
+}
+
+const lcd_fb_stats_t* lcdFbStats() { return &f_lcd_fb.stats; }
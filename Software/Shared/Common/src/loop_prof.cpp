@@ -0,0 +1,83 @@
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utils.h"
+#include "loop_prof.h"
+
+FILENUM(213);
+
+static struct {
+	loop_prof_stat_t stats[CFG_LOOP_PROF_SERVICE_COUNT + 1];	// Last is for whole loop.
+	loop_prof_worst_t worst;
+	uint16_t current[CFG_LOOP_PROF_SERVICE_COUNT];				// Service times for this loop.
+	uint32_t loop_start, mark;									// Timestamps from micros().
+	bool running;												// Set when a loop has been started.
+} f_loop_prof;
+
+static void stat_reset(loop_prof_stat_t* s) {
+	memset(s, 0, sizeof(*s));
+	s->min = UINT16_MAX;
+}
+
+void loopProfReset() {
+	memset(&f_loop_prof, 0, sizeof(f_loop_prof));
+	fori (CFG_LOOP_PROF_SERVICE_COUNT + 1)
+		stat_reset(&f_loop_prof.stats[i]);
+}
+
+static uint16_t elapsed(uint32_t now, uint32_t then) { return (uint16_t)utilsLimitMaxU32(now - then, UINT16_MAX); }
+
+static void stat_add(loop_prof_stat_t* s, uint16_t t) {
+	if (t < s->min) s->min = t;
+	if (t > s->max) s->max = t;
+	if (UINT16_MAX == s->count) {
+		s->count /= 2;
+		s->total /= 2;
+	}
+	s->count += 1;
+	s->total += t;
+}
+
+#if CFG_WANT_LOOP_PROF
+void loopProfStart() {
+	const uint32_t now = micros();
+	if (f_loop_prof.running) {
+		const uint16_t t = elapsed(now, f_loop_prof.loop_start);
+		stat_add(&f_loop_prof.stats[CFG_LOOP_PROF_SERVICE_COUNT], t);
+		if (t > f_loop_prof.worst.loop) {
+			f_loop_prof.worst.loop = t;
+			memcpy(f_loop_prof.worst.services, f_loop_prof.current, sizeof(f_loop_prof.worst.services));
+		}
+	}
+	memset(f_loop_prof.current, 0, sizeof(f_loop_prof.current));
+	f_loop_prof.loop_start = f_loop_prof.mark = now;
+	f_loop_prof.running = true;
+}
+
+void loopProfMark(uint8_t idx) {
+	ASSERT(idx < CFG_LOOP_PROF_SERVICE_COUNT);
+	const uint32_t now = micros();
+	const uint16_t t = elapsed(now, f_loop_prof.mark);
+	f_loop_prof.mark = now;
+	stat_add(&f_loop_prof.stats[idx], t);
+	f_loop_prof.current[idx] = (uint16_t)utilsLimitMaxU32((uint32_t)f_loop_prof.current[idx] + t, UINT16_MAX);
+}
+#endif
+
+const loop_prof_stat_t* loopProfStat(uint8_t idx) {
+	ASSERT(idx <= CFG_LOOP_PROF_SERVICE_COUNT);
+	return &f_loop_prof.stats[idx];
+}
+
+const loop_prof_worst_t* loopProfWorst() { return &f_loop_prof.worst; }
+
+uint8_t loopProfWorstService() {
+	uint8_t worst_idx = 0;
+	fori (CFG_LOOP_PROF_SERVICE_COUNT) {
+		if (f_loop_prof.worst.services[i] > f_loop_prof.worst.services[worst_idx])
+			worst_idx = i;
+	}
+	return worst_idx;
+}
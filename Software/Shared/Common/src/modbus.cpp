@@ -17,6 +17,8 @@
 /* Customisation for AVR target. */
 #if defined(__AVR__)
  #include <avr/pgmspace.h>
+#elif defined(ESP32)
+ #include <pgmspace.h>
 #else
  #define pgm_read_word(ptr_) (*(ptr_))
  #define PROGMEM /*empty */
@@ -0,0 +1,84 @@
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils.h"
+#include "modbus.h"
+#include "modbus_rbe.h"
+
+FILENUM(215);
+
+static uint16_t all_mask(uint8_t count) { return (uint16_t)((1UL << count) - 1U); }
+static uint8_t count_bits(uint16_t mask) {
+	uint8_t n = 0U;
+	for (; mask; mask &= (uint16_t)(mask - 1U))		// Clear lowest set bit.
+		n += 1;
+	return n;
+}
+
+void modbusRbeInit(modbus_rbe_t* rbe) {
+	memset(rbe, 0, sizeof(*rbe));
+	rbe->report_all = true;
+}
+
+uint16_t modbusRbeChanges(const modbus_rbe_t* rbe, const uint16_t* values, const uint16_t* deadbands, uint8_t count, uint16_t max_silence_ms) {
+	ASSERT(count <= MODBUS_RBE_REGS_MAX);
+	if (rbe->report_all || ((millis() - rbe->reported_all_ms) >= max_silence_ms))
+		return all_mask(count);
+
+	uint16_t mask = 0U;
+	fori (count) {
+		const int32_t delta = (int16_t)(uint16_t)(values[i] - rbe->reported[i]);
+		if (utilsAbs<int32_t>(delta) > (int32_t)deadbands[i])
+			mask |= (uint16_t)(1U << i);
+	}
+	return mask;
+}
+
+bool modbusRbeBuildResponse(modbus_rbe_t* rbe, BufferDynamic& response, const BufferDynamic& request, const uint16_t* values, uint8_t count,
+  uint16_t mask) {
+	ASSERT(count <= MODBUS_RBE_REGS_MAX);
+	mask &= all_mask(count);
+	response.assignMem(request, 2);			// Copy ID & Function Code from request frame.
+	response.add((uint8_t)(2U + 2U * count_bits(mask)));
+	response.addU16_be(mask);
+	fori (count) {
+		if (mask & (1U << i))
+			response.addU16_be(values[i]);
+	}
+	if (response.ovf() || (response.free() < 2U))				// No room for CRC.
+		return false;
+
+	fori (count) {
+		if (mask & (1U << i))
+			rbe->reported[i] = values[i];
+	}
+	if (mask == all_mask(count)) {
+		rbe->report_all = false;
+		rbe->reported_all_ms = millis();
+	}
+	return true;
+}
+
+bool modbusRbeParseResponse(const BufferDynamic& response, uint8_t count, uint16_t* values, uint16_t* mask) {
+	if ((count > MODBUS_RBE_REGS_MAX) || (response.len() < 7U) || (MODBUS_FC_READ_HOLDING_REGISTERS != response[MODBUS_FRAME_IDX_FUNCTION]))
+		return false;
+	const uint8_t byte_count = response[MODBUS_FRAME_IDX_DATA];
+	if (response.len() != byte_count + 5U)
+		return false;
+	const uint16_t m = response.getU16_be(MODBUS_FRAME_IDX_DATA + 1);
+	if (m & ~all_mask(count))
+		return false;
+	if (byte_count != 2U + 2U * count_bits(m))
+		return false;
+
+	uint8_t idx = MODBUS_FRAME_IDX_DATA + 3;
+	fori (count) {
+		if (m & (1U << i)) {
+			values[i] = response.getU16_be(idx);
+			idx += 2;
+		}
+	}
+	*mask = m;
+	return true;
+}
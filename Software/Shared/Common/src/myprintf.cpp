@@ -124,6 +124,25 @@ char myprintf_snprintf(char* buf, size_t len, const char* fmt, ...) {
 	return rc;
 }
 
+/* Fast integer formatting. Division of a long by a variable base is very slow on a small processor, so decimal is converted in chunks of 4
+	digits with one long division by 10000 per chunk, and the digits of each chunk are found with a 16 bit divide by 10, done as a multiply &
+	shift. Hex & binary just need a mask & shift. */
+
+// Divide by 10 for any 16 bit value, 0xcccd/2^19 is close enough to 1/10 to be exact over the range.
+static inline uint16_t div10_u16(uint16_t x) { return (uint16_t)(((uint32_t)x * 0xcccdU) >> 19); }
+
+// Write decimal digits of x to the buffer backwards from p, at least ndigits with leading zeros. Returns pointer to the first digit.
+static char* format_dec_u16(char* p, uint16_t x, uint_least8_t ndigits) {
+	uint_least8_t n = 0;
+	do {
+		const uint16_t q = div10_u16(x);
+		*--p = (char)('0' + (x - q * 10U));
+		x = q;
+		n += 1;
+	} while ((x > 0) || (n < ndigits));
+	return p;
+}
+
 /* This has to be a macro, some weirdness with va_args. It expands to not much machine code.
  * You can pass them as arguments to functions and call va_arg() on them, but not in two separate functions it seems. 
  * Anyway I had a failure on AVR with a format like "%ld %d", added a test, found the same error on the x86 run test.
@@ -162,6 +181,7 @@ void myprintf(myprintf_putchar putfunc, void* arg, const char* fmt, va_list ap)
 		char* m;
 	} str;
 	char c;
+	int len;						// Length of string to print.
 
 	for (; '\0' != (c = MYPRINTF_PGM_STR_DEREF_FMT(fmt)); fmt += 1) {	// Iterate over all chars in format.
 		if (flags & FLAG_FORMAT) {
@@ -244,11 +264,23 @@ do_unsigned:	num.u = (flags & FLAG_LONG) ?
 			*str.m = '\0';
 
 			// Format digits LSD first in selected base.
-			do {
-				const uint_least8_t digit = num.u % base;
-				*--str.m = digit + ((digit < 10) ? '0' : (((flags & FLAG_UPPER) ? 'A' : 'a') - 10));
-				num.u /= base;
-			} while (num.u > 0);
+			if (10 == base) {
+				while (num.u >= 10000U) {
+					const CFG_MYPRINTF_T_L_UINT q = num.u / 10000U;
+					str.m = format_dec_u16(str.m, (uint16_t)(num.u - q * 10000U), 4);
+					num.u = q;
+				}
+				str.m = format_dec_u16(str.m, (uint16_t)num.u, 1);
+			}
+			else {
+				const uint_least8_t shift = (16 == base) ? 4 : 1;
+				const char alpha = (char)(((flags & FLAG_UPPER) ? 'A' : 'a') - 10);
+				do {
+					const uint_least8_t digit = (uint_least8_t)(num.u & (base - 1U));
+					*--str.m = (char)(digit + ((digit < 10) ? '0' : alpha));
+					num.u >>= shift;
+				} while (num.u > 0);
+			}
 
 			// Take care of leading '-'.
 			if (signchar) {
@@ -260,21 +292,24 @@ do_unsigned:	num.u = (flags & FLAG_LONG) ?
 					*--str.m = signchar;
 			}
 
+			len = (int)(buf + BUF_LEN - 1 - str.c);	// Length of a number is known so no need to scan it.
+			goto p_pad;
+
 p_str:		/* Print string `str' justified in `width' with padding char `pad'. */
+			len = 0;
 			if (width > 0) { 	// Get length of string only if required.
-				int len;
 				const char* p = str.c;
 				while ('\0' != MYPRINTF_PGM_STR_DEREF_PTR(p))
 					p += 1;
-				len = p - str.c;
-
-				// Get length of padding required.
-				if (len >= width)
-					width = 0;
-				else
-					width -= len;
+				len = (int)(p - str.c);
 			}
 
+p_pad:		// Get length of padding required.
+			if (len >= width)
+				width = 0;
+			else
+				width -= len;
+
 			// Print padding to left.
 			if (!(flags & FLAG_PAD_RIGHT)) {
 				while (width > 0) {
@@ -0,0 +1,38 @@
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils.h"
+#include "poll_backoff.h"
+
+FILENUM(214);
+
+void pollBackoffInit(poll_backoff_t* b) {
+	b->misses = b->backoff = b->wait = 0U;
+}
+
+bool pollBackoffIsDue(poll_backoff_t* b) {
+	if (b->wait > 0U) {
+		b->wait -= 1;
+		return false;
+	}
+	return true;
+}
+
+/* The back-off is only applied to polls sent once backed off, so the first poll after backing off is sent on the next pass, then after 2,
+	4... passes. */
+void pollBackoffSent(poll_backoff_t* b, uint8_t threshold, uint8_t backoff_max) {
+	if (pollBackoffIsBackedOff(b, threshold)) {
+		b->wait = (uint8_t)((1U << b->backoff) - 1U);
+		if (b->backoff < utilsLimitMax<uint8_t>(backoff_max, POLL_BACKOFF_MAX))
+			b->backoff += 1;
+	}
+	if (b->misses < UINT8_MAX)
+		b->misses += 1;
+}
+
+bool pollBackoffResponse(poll_backoff_t* b, uint8_t threshold) {
+	const bool backed_off = pollBackoffIsBackedOff(b, threshold);
+	pollBackoffInit(b);
+	return backed_off;
+}
@@ -1,17 +1,55 @@
 #include <Arduino.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "utils.h"
 #include "console.h"
 #include "regs.h"
+#include "modbus.h"
 
 
-bool regsWriteMask(uint8_t idx, regs_t mask, bool s) { return utilsWriteFlags<regs_t>(&REGS[idx], mask, s); }
-bool regsUpdateMask(uint8_t idx, regs_t mask, regs_t value) { return utilsUpdateFlags<regs_t>(&REGS[idx], mask, value); }
+static uint8_t f_regs_dirty[REGS_MASK_SIZE];
+static uint8_t f_regs_subscribed[REGS_MASK_SIZE];
+static regs_change_func f_regs_change_cb;
+
+// Set dirty bit & notify subscriber if the register has changed. Returns changed argument.
+static bool regs_changed(uint8_t idx, bool changed) {
+	if (changed) {
+		const uint8_t m = (uint8_t)(1U << (idx % 8));
+		CRITICAL( f_regs_dirty[idx / 8] |= m );
+		if ((f_regs_subscribed[idx / 8] & m) && (NULL != f_regs_change_cb))
+			f_regs_change_cb(idx, REGS[idx]);
+	}
+	return changed;
+}
+
+bool regsWrite(uint8_t idx, regs_t val) {
+	bool changed;
+	CRITICAL( changed = (REGS[idx] != val); REGS[idx] = val );
+	return regs_changed(idx, changed);
+}
+bool regsWriteMask(uint8_t idx, regs_t mask, bool s) { return regs_changed(idx, utilsWriteFlags<regs_t>(&REGS[idx], mask, s)); }
+bool regsUpdateMask(uint8_t idx, regs_t mask, regs_t value) { return regs_changed(idx, utilsUpdateFlags<regs_t>(&REGS[idx], mask, value)); }
 bool regsWriteMaskFlags(regs_t mask, bool s) { return regsWriteMask(REGS_IDX_FLAGS, mask, s); }
 bool regsUpdateMaskFlags(regs_t mask, regs_t value) { return regsUpdateMask(REGS_IDX_FLAGS, mask, value); }
 
+void regsChangeSetCallback(regs_change_func cb) { CRITICAL( f_regs_change_cb = cb ); }
+void regsChangeSubscribe(uint8_t idx, bool s) { CRITICAL( utilsWriteFlags<uint8_t>(&f_regs_subscribed[idx / 8], (uint8_t)(1U << (idx % 8)), s) ); }
+bool regsChangeTestAndClear(uint8_t idx) {
+	const uint8_t m = (uint8_t)(1U << (idx % 8));
+	bool dirty;
+	CRITICAL( dirty = !!(f_regs_dirty[idx / 8] & m); f_regs_dirty[idx / 8] &= (uint8_t)~m );
+	return dirty;
+}
+void regsChangeReset() {
+	CRITICAL(
+		memset(f_regs_dirty, 0, sizeof(f_regs_dirty));
+		memset(f_regs_subscribed, 0, sizeof(f_regs_subscribed));
+		f_regs_change_cb = NULL;
+	);
+}
+
 void regsPrintValue(uint8_t reg_idx) {
 	static const uint8_t FORMATS[] PROGMEM = { REGS_FORMAT_DEF };
 	regs_t v; 
@@ -19,6 +57,35 @@ void regsPrintValue(uint8_t reg_idx) {
 	consolePrint(pgm_read_byte(&FORMATS[reg_idx]), (console_cell_t)v);	
 }
 
+UTILS_STATIC_ASSERT(REGS_STREAM_PACKET_SIZE_MAX <= 255);	// Size is returned as a uint8_t & the length field must fit in a byte.
+uint8_t regsStreamMakePacket(uint8_t* buf, const uint8_t* mask, uint8_t seq, uint32_t timestamp) {
+	uint8_t* p = buf;
+	*p++ = REGS_STREAM_SYNC_0;
+	*p++ = REGS_STREAM_SYNC_1;
+	uint8_t* len = p++;				// Filled in when we know the length.
+	*p++ = seq;
+	fori (4) {
+		*p++ = (uint8_t)timestamp;
+		timestamp >>= 8;
+	}
+	*p++ = REGS_STREAM_MASK_SIZE;
+	fori (REGS_STREAM_MASK_SIZE)
+		*p++ = mask[i];
+	fori (COUNT_REGS) {
+		if (mask[i / 8] & (1U << (i % 8))) {
+			regs_t v;
+			CRITICAL( v = REGS[i] ); 	// Might be written by an ISR.
+			*p++ = (uint8_t)v;
+			*p++ = (uint8_t)(v >> 8);
+		}
+	}
+	*len = (uint8_t)(p - len - 1);
+	const uint16_t crc = modbusCrc(len, (uint8_t)(p - len));
+	*p++ = (uint8_t)crc;
+	*p++ = (uint8_t)(crc >> 8);
+	return (uint8_t)(p - buf);
+}
+
 void regsSetDefaultAll() { regsSetDefaultRange(0, COUNT_REGS); }
 
 void regsSetDefaultRange(uint8_t start, uint8_t end) {
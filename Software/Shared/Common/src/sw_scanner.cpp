@@ -43,65 +43,117 @@ void swScanInit(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t
 	swScanReset(defs, contexts, count);
 }
 
-void swScanSample(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count) {
-	uint16_t flags = regsFlags();
-	uint16_t all_flags_mask = 0;
+// Run the state machine for one switch, updating flags if the switch changes state.
+static void process_sw(const sw_scan_def_t* def, sw_scan_context_t* context, bool sw_active, uint16_t* flags) {
+	const uint16_t mask = pgm_read_word(&def->flag_mask);     				// Output flags mask bit set when switch enabled and decoded.
+	const uint8_t sw_evt = pgm_read_byte(&def->event);						// Event sent on state changes. 
 	
-	fori (count) {
-		const bool sw_active = is_sw_active(&defs[i]);
-		const uint16_t mask = pgm_read_word(&defs[i].flag_mask);     			// Output flags mask bit set when switch enabled and decoded.
-		const uint8_t sw_evt = pgm_read_byte(&defs[i].event);					// Event sent on state changes. 
-		all_flags_mask |= mask;													// Record all masks seen. 
-		
-		if (sw_active && (!(contexts[i].pstate))) { 							// Is sw just ACTIVE...
-			contexts[i].pstate = true;
-			const sw_scan_action_delay_func_t get_delay = (sw_scan_action_delay_func_t)pgm_read_word(&defs[i].delay);
-			contexts[i].action = (NULL != get_delay) ? get_delay() : 0U;
-		}
-		
-		else if (!sw_active) { 													// Is sw just INACTIVE...
-			if (contexts[i].pstate) {
-				if (flags & mask) {												// Only post release if past action delay.
-					eventPublish(sw_evt, EV_P8_SW_RELEASE); 
-					flags &= ~mask;
-				}
-				contexts[i].pstate = false;
+	if (sw_active && (!(context->pstate))) { 								// Is sw just ACTIVE...
+		context->pstate = true;
+		const sw_scan_action_delay_func_t get_delay = (sw_scan_action_delay_func_t)pgm_read_word(&def->delay);
+		context->action = (NULL != get_delay) ? get_delay() : 0U;
+	}
+	
+	else if (!sw_active) { 													// Is sw just INACTIVE...
+		if (context->pstate) {
+			if (*flags & mask) {											// Only post release if past action delay.
+				eventPublish(sw_evt, EV_P8_SW_RELEASE); 
+				*flags &= (uint16_t)~mask;
 			}
+			context->pstate = false;
 		}
-		
-		if (contexts[i].pstate) {												// Is sw currectly active...
-			if (!(flags & mask)) {
-				if (0 == contexts[i].action) {
-					eventPublish(sw_evt, EV_P8_SW_CLICK);  						// Publish initial click event.
-					flags |= mask;  											// Set state to driver register. 
-					contexts[i].hold = 0;  										// Zero hold timer to start counting up. 
-					contexts[i].repeat_timer = 0U;								// Zero repeat timer. 
-				}
-				else
-					contexts[i].action -= 1;
+	}
+	
+	if (context->pstate) {													// Is sw currectly active...
+		if (!(*flags & mask)) {
+			if (0 == context->action) {
+				eventPublish(sw_evt, EV_P8_SW_CLICK);  						// Publish initial click event.
+				*flags |= mask;  											// Set state to driver register. 
+				context->hold = 0;  										// Zero hold timer to start counting up. 
+				context->repeat_timer = 0U;									// Zero repeat timer. 
 			}
+			else
+				context->action -= 1;
+		}
 
-			// Sw held down.		
-			else {
-				// Check hold timer...
-				if (contexts[i].hold < SW_SCAN_TIMER_MAX) {
-					if (SW_HOLD_TIME == contexts[i].hold) {
-						eventPublish(sw_evt, EV_P8_SW_HOLD); 
-						contexts[i].repeat_timer = SW_REPEAT_DELAY;
-					}
-					else if (SW_LONG_HOLD_TIME == contexts[i].hold)
-						eventPublish(sw_evt, EV_P8_SW_LONG_HOLD); 
-					contexts[i].hold += 1;
-				}
-				
-				// Do auto-repeat.
-				if ((contexts[i].repeat_timer > 0) && (0 == --contexts[i].repeat_timer)) {
-					eventPublish(sw_evt, EV_P8_SW_REPEAT); 
-					contexts[i].repeat_timer = SW_REPEAT_DELAY;
+		// Sw held down.		
+		else {
+			// Check hold timer...
+			if (context->hold < SW_SCAN_TIMER_MAX) {
+				if (SW_HOLD_TIME == context->hold) {
+					eventPublish(sw_evt, EV_P8_SW_HOLD); 
+					context->repeat_timer = SW_REPEAT_DELAY;
 				}
+				else if (SW_LONG_HOLD_TIME == context->hold)
+					eventPublish(sw_evt, EV_P8_SW_LONG_HOLD); 
+				context->hold = (uint8_t)(context->hold + 1U) & SW_SCAN_TIMER_MAX;
 			}
+			
+			// Do auto-repeat.
+			if ((context->repeat_timer > 0) && (0 == --context->repeat_timer)) {
+				eventPublish(sw_evt, EV_P8_SW_REPEAT); 
+				context->repeat_timer = SW_REPEAT_DELAY;
+			}
+		}
+	}
+}
+
+static uint16_t get_all_flags_mask(const sw_scan_def_t* defs, uint8_t count) {
+	uint16_t all_flags_mask = 0;
+	fori (count)
+		all_flags_mask |= pgm_read_word(&defs[i].flag_mask);
+	return all_flags_mask;
+}
+
+void swScanSample(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count) {
+	uint16_t flags = regsFlags();
+	fori (count)
+		process_sw(&defs[i], &contexts[i], is_sw_active(&defs[i]), &flags);
+	regsUpdateMaskFlags(get_all_flags_mask(defs, count), flags);
+}
+
+// Port scan mode.
+
+void swScanInitPorts(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count, sw_scan_ports_t* ports) {
+	swScanInit(defs, contexts, count);
+	memset(ports, 0, sizeof(*ports));
+
+	// Group switches by port.
+	fori (count) {
+		const uint8_t pin = pgm_read_byte(&defs[i].pin);
+		volatile uint8_t* pin_reg = portInputRegister(digitalPinToPort(pin));
+		uint8_t pidx = 0;
+		while ((pidx < ports->port_count) && (ports->ports[pidx].pin_reg != pin_reg))
+			pidx += 1;
+		if (pidx == ports->port_count) {
+			ASSERT(ports->port_count < SW_SCAN_PORTS_MAX);
+			ports->port_count += 1;
+			ports->ports[pidx].pin_reg = pin_reg;
 		}
+		sw_scan_port_t* p = &ports->ports[pidx];
+		contexts[i].port_idx = pidx;
+		contexts[i].port_mask = digitalPinToBitMask(pin);
+		p->mask |= contexts[i].port_mask;
+		if (pgm_read_byte(&defs[i].active_low))
+			p->invert |= contexts[i].port_mask;
+	}
+
+	// Start with debounced state as current state so switches held at startup do not need to wait for the debounce.
+	fori (ports->port_count) {
+		sw_scan_port_t* p = &ports->ports[i];
+		p->cnt0 = p->cnt1 = 0xff;
+		p->state = (uint8_t)((*p->pin_reg ^ p->invert) & p->mask);
 	}
-	regsUpdateMaskFlags(all_flags_mask, flags);
 }
 
+void swScanSamplePorts(const sw_scan_def_t* defs, sw_scan_context_t* contexts, uint8_t count, sw_scan_ports_t* ports) {
+	fori (ports->port_count) {
+		sw_scan_port_t* p = &ports->ports[i];
+		swScanDebounce(p, (uint8_t)((*p->pin_reg ^ p->invert) & p->mask));
+	}
+
+	uint16_t flags = regsFlags();
+	fori (count)
+		process_sw(&defs[i], &contexts[i], !!(ports->ports[contexts[i].port_idx].state & contexts[i].port_mask), &flags);
+	regsUpdateMaskFlags(get_all_flags_mask(defs, count), flags);
+}
@@ -1,15 +1,122 @@
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "project_config.h"		// cppcheck-suppress [missingInclude]
 #include "thread.h"
+#include "utils.h"
 
-// No point having this as no debug facilities used. 
-// FILENUM(212);
+FILENUM(212);
 
 /* This is the pointer to the current running tcb. This is used by the various macros to access the current tcb without 
     requiring it as a parameter, which would be ugly. */
 thread_control_t* g_currentThread;
 
-    
+// Scheduler.
+static struct {
+	thread_sched_tcb_t* ready;			// Ready list, run in order.
+	thread_sched_tcb_t* ready_tail;
+	thread_sched_tcb_t* sleeping;		// Sleep list sorted by wake time.
+	thread_sched_tcb_t* current;		// Thread being run by the scheduler.
+} f_sched;
+
+void threadSchedInit() {
+	memset(&f_sched, 0, sizeof(f_sched));
+}
+
+static void ready_append(thread_sched_tcb_t* tcb) {
+	tcb->state = THREAD_SCHED_STATE_READY;
+	tcb->next = NULL;
+	if (NULL == f_sched.ready)
+		f_sched.ready = tcb;
+	else
+		f_sched.ready_tail->next = tcb;
+	f_sched.ready_tail = tcb;
+}
+
+// Insert into sleep list after any threads with the same wake time, so threads sleeping for the same time wake in order.
+static void sleep_insert(thread_sched_tcb_t* tcb, thread_ticks_t now) {
+	const thread_ticks_t delay = (thread_ticks_t)(tcb->wake - now);
+	thread_sched_tcb_t** p = &f_sched.sleeping;
+	while ((NULL != *p) && ((thread_ticks_t)((*p)->wake - now) <= delay))
+		p = &(*p)->next;
+	tcb->next = *p;
+	*p = tcb;
+}
+
+static void sleep_remove(thread_sched_tcb_t* tcb) {
+	thread_sched_tcb_t** p = &f_sched.sleeping;
+	while ((NULL != *p) && (*p != tcb))
+		p = &(*p)->next;
+	if (NULL != *p)
+		*p = tcb->next;
+}
+
+void threadSchedAdd(thread_sched_tcb_t* tcb, thread_t thread, void* arg) {
+	threadInit(&tcb->tc);
+	tcb->thread = thread;
+	tcb->arg = arg;
+	tcb->rc = THREAD_STATE_RUNNING;
+	ready_append(tcb);
+}
+
+uint8_t threadSchedService() {
+	const thread_ticks_t now = threadGetTicks();
+
+	// Wake sleeping threads, as the list is sorted we can stop at the first that is still sleeping.
+	while ((NULL != f_sched.sleeping) && ((int16_t)(now - f_sched.sleeping->wake) >= 0)) {
+		thread_sched_tcb_t* tcb = f_sched.sleeping;
+		f_sched.sleeping = tcb->next;
+		ready_append(tcb);
+	}
+
+	// Take the ready list, so that threads made ready while we are running them are not run until next time.
+	thread_sched_tcb_t* tcb = f_sched.ready;
+	f_sched.ready = f_sched.ready_tail = NULL;
+	uint8_t count = 0;
+	while (NULL != tcb) {
+		thread_sched_tcb_t* next = tcb->next;
+		f_sched.current = tcb;
+		const int8_t rc = threadRun(&tcb->tc, tcb->thread, tcb->arg);
+		f_sched.current = NULL;
+		count += 1;
+
+		if (threadIsFinished(rc)) {
+			tcb->state = THREAD_SCHED_STATE_DONE;
+			tcb->rc = rc;
+		}
+		else if (THREAD_SCHED_STATE_SLEEPING == tcb->state)
+			sleep_insert(tcb, now);
+		else if (THREAD_SCHED_STATE_READY == tcb->state)
+			ready_append(tcb);
+		// Else blocked, so not on any list.
+		tcb = next;
+	}
+	return count;
+}
+
+void threadSchedWake(thread_sched_tcb_t* tcb) {
+	if (f_sched.current == tcb) {			// Woken while running, it is on no list so just leave it ready.
+		if (THREAD_SCHED_STATE_DONE != tcb->state)
+			tcb->state = THREAD_SCHED_STATE_READY;
+	}
+	else if (THREAD_SCHED_STATE_SLEEPING == tcb->state) {
+		sleep_remove(tcb);
+		ready_append(tcb);
+	}
+	else if (THREAD_SCHED_STATE_BLOCKED == tcb->state)
+		ready_append(tcb);
+}
+
+void threadSchedSleep(thread_ticks_t ticks) {
+	ASSERT(NULL != f_sched.current);
+	f_sched.current->wake = (thread_ticks_t)(threadGetTicks() + ticks);
+	f_sched.current->state = THREAD_SCHED_STATE_SLEEPING;
+}
+
+void threadSchedBlock() {
+	ASSERT(NULL != f_sched.current);
+	f_sched.current->state = THREAD_SCHED_STATE_BLOCKED;
+}
+
 /* eof */
@@ -13,6 +13,7 @@
  #define pgm_read_word(_a) (*(uint16_t*)(_a))
  #define pgm_read_ptr(x_) (*(x_))					// Generic target.
  #define strchr_P strchr
+ #define memcpy_P memcpy
 #endif
 
 #include "utils.h"
@@ -65,20 +66,21 @@ uint16_t utilsChecksumEeprom(const void *data, size_t count) {
 }
 
 bool utilsMultiThreshold(const uint16_t* thresholds, uint8_t count, uint16_t hysteresis, uint8_t* level, uint16_t val) {
-    uint8_t i;
-    uint8_t new_level = 0;
-    bool changed;
-
-    for (i = 0; i < count; i += 1) {
-        uint16_t threshold = pgm_read_word(&thresholds[i]);
-        if (i < *level)
-            threshold -= hysteresis;
-        new_level += (val > threshold);
-    }
+	const uint8_t new_level = utils_multi_threshold_search<uint16_t>(thresholds, NULL, hysteresis, count, *level, val);
+	const bool changed = (*level != new_level);
+	*level = new_level;
+	return changed;
+}
 
-    changed = (*level != new_level);
-    *level = new_level;
-    return changed;
+uint16_t utilsScale(const UtilsScalerSegment* segs, uint8_t count, uint16_t x) {
+	uint8_t i = (uint8_t)(count - 1U);
+	while ((i > 0U) && (x < pgm_read_word(&segs[i].x0)))
+		i -= 1;
+	const UtilsScalerSegment seg = utilsReadProgmem(&segs[i]);
+	if (x < seg.x0)
+		return seg.y0;
+	const int32_t y = (int32_t)seg.y0 + (((int32_t)(x - seg.x0) * seg.slope + 0x8000L) >> 16);
+	return (uint16_t)utilsLimit<int32_t>(y, 0, UINT16_MAX);
 }
 
 // Utils Sequencer -- generic driver to run an arbitrary sequence by calling a user function every so often with a canned argument.
@@ -0,0 +1,57 @@
+#ifndef ARDUINO_H__
+#define ARDUINO_H__
+
+/* Just enough of the Arduino API to compile Common modules like console.cpp on the host for testing. Strings in PROGMEM are just in RAM. */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "support_test.h"
+
+#define PROGMEM /* empty */
+#define pgm_read_byte(x_) (*(x_))
+#define pgm_read_word(x_) (*(x_))
+#define memcpy_P memcpy
+class __FlashStringHelper;
+#define F(str_) (reinterpret_cast<const __FlashStringHelper*>(str_))
+
+enum { DEC = 10, HEX = 16 };
+
+// Fake GPIO, pins are grouped 8 to a port, port input registers are in g_test_ports[] so tests can set them.
+enum { LOW = 0, HIGH = 1 };
+enum { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2 };
+#define TEST_PORT_COUNT 4
+extern volatile uint8_t g_test_ports[TEST_PORT_COUNT];
+#define digitalPinToPort(p_) ((uint8_t)((p_) / 8U))
+#define digitalPinToBitMask(p_) ((uint8_t)(1U << ((p_) % 8U)))
+#define portInputRegister(port_) (&g_test_ports[port_])
+static inline int digitalRead(uint8_t pin) { return (g_test_ports[digitalPinToPort(pin)] & digitalPinToBitMask(pin)) ? HIGH : LOW; }
+static inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+
+	size_t print(const char* s) { size_t n = 0; while ('\0' != *s) n += write((uint8_t)*s++); return n; }
+	size_t print(const __FlashStringHelper* s) { return print(reinterpret_cast<const char*>(s)); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(int x, int base=DEC) { return print((long)x, base); }
+	size_t print(unsigned x, int base=DEC) { return print((unsigned long)x, base); }
+	size_t print(long x, int base=DEC) { return (x < 0) ? (print('-') + print((unsigned long)-x, base)) : print((unsigned long)x, base); }
+	size_t print(unsigned long x, int base=DEC) {
+		char buf[24];
+		snprintf(buf, sizeof(buf), (HEX == base) ? "%lX" : "%lu", x);
+		return print(buf);
+	}
+};
+
+class Stream : public Print {
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+};
+
+#endif	// ARDUINO_H__
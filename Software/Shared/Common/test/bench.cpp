@@ -0,0 +1,116 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+
+/* Usage: bench [-w warmup-batches] [-s samples] [name-filter...]
+	Only benchmarks whose name contains one of the filter strings are run, or all if none are given. */
+
+volatile uint32_t g_bench_sink;
+
+enum {
+	BENCH_COUNT_MAX = 64,
+	BENCH_SAMPLES_MAX = 1001,
+};
+static const uint64_t BENCH_BATCH_TARGET_NS = 20000U;
+
+static struct {
+	const char* name;
+	bench_func f;
+	uint16_t ops;
+} f_benches[BENCH_COUNT_MAX];
+static uint8_t f_bench_count;
+
+void benchRegister(const char* name, bench_func f, uint16_t ops) {
+	if (f_bench_count >= BENCH_COUNT_MAX) {
+		fprintf(stderr, "Too many benchmarks, increase BENCH_COUNT_MAX.\n");
+		exit(2);
+	}
+	f_benches[f_bench_count].name = name;
+	f_benches[f_bench_count].f = f;
+	f_benches[f_bench_count].ops = ops;
+	f_bench_count += 1;
+}
+
+static uint64_t now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t run_batch(bench_func f, uint32_t batch) {
+	const uint64_t start = now_ns();
+	for (uint32_t i = 0; i < batch; i += 1)
+		f();
+	return now_ns() - start;
+}
+
+// Double the batch size until a batch takes long enough to time accurately.
+static uint32_t calibrate(bench_func f) {
+	uint32_t batch = 1;
+	while ((run_batch(f, batch) < BENCH_BATCH_TARGET_NS) && (batch < (1UL << 24)))
+		batch *= 2;
+	return batch;
+}
+
+static int compare_double(const void* a, const void* b) {
+	const double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of sorted samples.
+static double percentile(const double* sorted, uint16_t count, uint8_t pc) {
+	const uint32_t rank = ((uint32_t)pc * count + 99U) / 100U;
+	return sorted[(rank > 0) ? (rank - 1) : 0];
+}
+
+static bool is_selected(const char* name, char** filters, int filter_count) {
+	if (0 == filter_count)
+		return true;
+	for (int i = 0; i < filter_count; i += 1) {
+		if (NULL != strstr(name, filters[i]))
+			return true;
+	}
+	return false;
+}
+
+int main(int argc, char** argv) {
+	uint16_t warmup = 10, samples = 101;
+	int argi = 1;
+	for (; (argi < argc) && ('-' == argv[argi][0]); argi += 1) {
+		if ((0 == strcmp(argv[argi], "-w")) && (argi + 1 < argc))
+			warmup = (uint16_t)atoi(argv[++argi]);
+		else if ((0 == strcmp(argv[argi], "-s")) && (argi + 1 < argc))
+			samples = (uint16_t)atoi(argv[++argi]);
+		else {
+			fprintf(stderr, "Usage: %s [-w warmup-batches] [-s samples] [name-filter...]\n", argv[0]);
+			return 2;
+		}
+	}
+	if ((samples < 1) || (samples > BENCH_SAMPLES_MAX)) {
+		fprintf(stderr, "Samples must be 1..%u.\n", BENCH_SAMPLES_MAX);
+		return 2;
+	}
+
+	printf("name,batch,samples,min_ns,median_ns,p90_ns,p99_ns,max_ns\n");
+	static double t[BENCH_SAMPLES_MAX];
+	for (uint8_t b = 0; b < f_bench_count; b += 1) {
+		if (!is_selected(f_benches[b].name, &argv[argi], argc - argi))
+			continue;
+		const uint32_t batch = calibrate(f_benches[b].f);
+		for (uint16_t i = 0; i < warmup; i += 1)
+			run_batch(f_benches[b].f, batch);
+		const double ops = (double)batch * f_benches[b].ops;
+		for (uint16_t i = 0; i < samples; i += 1)
+			t[i] = (double)run_batch(f_benches[b].f, batch) / ops;
+		qsort(t, samples, sizeof(t[0]), compare_double);
+		printf("%s,%lu,%u,%.2f,%.2f,%.2f,%.2f,%.2f\n", f_benches[b].name, (unsigned long)batch, samples, t[0], percentile(t, samples, 50),
+		  percentile(t, samples, 90), percentile(t, samples, 99), t[samples - 1]);
+		fflush(stdout);
+	}
+	return 0;
+}
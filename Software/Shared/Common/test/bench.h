@@ -0,0 +1,27 @@
+#ifndef BENCH_H__
+#define BENCH_H__
+
+/* Microbenchmark harness for library routines, built by `make -f t.mk bench'. A benchmark is a function that does one operation, declared with
+	BENCH(name) { ... }. The harness calls it in batches, sized so that a batch takes about BENCH_BATCH_TARGET_NS, then after some warmup batches
+	times a number of batches and reports the min, median, 90th & 99th percentile, and max time per operation in ns. The time includes an
+	indirect call, about 1ns, so very short operations should do several in the body and give the count to BENCH_N().
+	Output is CSV on stdout with a header line, so that results from two commits can be compared with bench_compare.py. */
+
+#include <stdint.h>
+
+typedef void (*bench_func)();
+
+// Register a benchmark, called by static constructors declared by BENCH(). Benchmarks are run in the order they are registered.
+void benchRegister(const char* name, bench_func f, uint16_t ops);
+
+#define BENCH_N(name_, ops_)																	\
+	static void bench_##name_();																\
+	static struct BenchReg_##name_ { BenchReg_##name_() { benchRegister(#name_, bench_##name_, (ops_)); } } f_bench_reg_##name_;	\
+	static void bench_##name_()
+#define BENCH(name_) BENCH_N(name_, 1)
+
+// Consume a result so that the compiler cannot optimise away the operation that computed it.
+extern volatile uint32_t g_bench_sink;
+static inline void benchSink(uint32_t x) { g_bench_sink = x; }
+
+#endif // BENCH_H__
@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+
+"""Compare two CSV files written by the benchmark runner, printing the median time for each benchmark in both and the change. Changes larger
+than the threshold are flagged, and the exit status is 1 if any benchmark got slower by more than the threshold."""
+
+import argparse
+import csv
+import sys
+
+def read(fn):
+	with open(fn, newline='') as f:
+		return {row['name']: float(row['median_ns']) for row in csv.DictReader(f)}
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('old', help='CSV file from baseline run')
+parser.add_argument('new', help='CSV file from new run')
+parser.add_argument('-t', '--threshold', type=float, default=10.0, help='percentage change to flag, default %(default)s')
+args = parser.parse_args()
+
+old, new = read(args.old), read(args.new)
+slower = False
+print(f"{'name':24} {'old_ns':>10} {'new_ns':>10} {'change':>8}")
+for name in list(old) + [n for n in new if n not in old]:
+	if name not in old or name not in new:
+		fmt = lambda d: f"{d[name]:10.2f}" if name in d else f"{'-':>10}"
+		print(f"{name:24} {fmt(old)} {fmt(new)}")
+		continue
+	change = 100.0 * (new[name] - old[name]) / old[name] if old[name] else 0.0
+	flag = ''
+	if abs(change) > args.threshold:
+		flag = ' slower' if change > 0 else ' faster'
+		slower = slower or (change > 0)
+	print(f"{name:24} {old[name]:10.2f} {new[name]:10.2f} {change:+7.1f}%{flag}")
+sys.exit(1 if slower else 0)
@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "Arduino.h"
+#include "console.h"
+#include "utils.h"
+
+// Commands from console_cmds_test.src, each pushes a number.
+#include "console_cmds_test.h"
+
+// The same commands as a switch, as they were before mk_console.py generated a table. Run console-mk.py on this file to update hashes.
+static bool console_cmds_test_switch(char* cmd) {
+	switch (console_hash(cmd)) {
+		case /** ?VER **/ 0xc33b: consoleStackPush(100); break;
+		case /** CMD **/ 0xd00f: consoleStackPush(101); break;
+		case /** LED **/ 0xdc88: consoleStackPush(102); break;
+		case /** ?LED **/ 0xdd37: consoleStackPush(103); break;
+		case /** RLY **/ 0x07a2: consoleStackPush(104); break;
+		case /** ?RLY **/ 0xb21d: consoleStackPush(105); break;
+		case /** ?S **/ 0x6889: consoleStackPush(106); break;
+		case /** ?PR **/ 0x7998: consoleStackPush(107); break;
+		case /** PR **/ 0x74c7: consoleStackPush(108); break;
+		case /** ?LIM **/ 0xdeb2: consoleStackPush(109); break;
+		case /** LIM **/ 0xdb0d: consoleStackPush(110); break;
+		case /** BL **/ 0x728b: consoleStackPush(111); break;
+		case /** EVENT **/ 0x8a29: consoleStackPush(112); break;
+		case /** EVENT-EX **/ 0x2f99: consoleStackPush(113); break;
+		case /** CTM **/ 0xd17f: consoleStackPush(114); break;
+		case /** DTM **/ 0xbcb8: consoleStackPush(115); break;
+		case /** ?TM **/ 0x7a03: consoleStackPush(116); break;
+		case /** ??TM **/ 0x3fbc: consoleStackPush(117); break;
+		case /** STM **/ 0x116f: consoleStackPush(118); break;
+		case /** M **/ 0xb5e8: consoleStackPush(119); break;
+		case /** ATN **/ 0xb87e: consoleStackPush(120); break;
+		case /** SL **/ 0x74fa: consoleStackPush(121); break;
+		case /** ?SL **/ 0x79e5: consoleStackPush(122); break;
+		case /** SEND-RAW **/ 0xf690: consoleStackPush(123); break;
+		case /** SEND **/ 0x76f9: consoleStackPush(124); break;
+		case /** WRITE **/ 0xa8f8: consoleStackPush(125); break;
+		case /** READ **/ 0xd8b7: consoleStackPush(126); break;
+		case /** ?V **/ 0x688c: consoleStackPush(127); break;
+		case /** V **/ 0xb5f3: consoleStackPush(128); break;
+		case /** ??V **/ 0x85d3: consoleStackPush(129); break;
+		case /** ???V **/ 0x3cac: consoleStackPush(130); break;
+		case /** DUMP **/ 0x4fe9: consoleStackPush(131); break;
+		case /** X **/ 0xb5fd: consoleStackPush(132); break;
+		case /** RESTART **/ 0x7092: consoleStackPush(133); break;
+		case /** CLI **/ 0xd063: consoleStackPush(134); break;
+		case /** ABORT **/ 0xfeaf: consoleStackPush(135); break;
+		case /** ASSERT **/ 0x5007: consoleStackPush(136); break;
+		case /** NV-DEFAULT **/ 0xfcdb: consoleStackPush(137); break;
+		case /** NV-W **/ 0xa8c7: consoleStackPush(138); break;
+		case /** NV-R **/ 0xa8c2: consoleStackPush(139); break;
+		case /** PIN **/ 0x1012: consoleStackPush(140); break;
+		case /** ?PIN **/ 0xa9ad: consoleStackPush(141); break;
+		case /** PMODE **/ 0x48d6: consoleStackPush(142); break;
+		case /** ?T **/ 0x688e: consoleStackPush(143); break;
+		default: return false;
+	}
+	return true;
+}
+
+// Console output is discarded.
+class StreamNull : public Stream {
+public:
+	virtual size_t write(uint8_t c) { benchSink(c); return 1; }
+	virtual int available() { return 0; }
+	virtual int read() { return -1; }
+};
+static StreamNull f_stream;
+static console_recogniser_func f_recogniser;
+
+static void run(console_recogniser_func r, const char* script) {
+	if (f_recogniser != r) {
+		consoleInit(r, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO);
+		f_recogniser = r;
+	}
+	if (CONSOLE_RC_OK != consoleScriptRun(script, consoleScriptReadRam)) {
+		fprintf(stderr, "Console benchmark script failed: %s\n", script);
+		exit(1);
+	}
+}
+
+// Lines are at most 40 characters. Parse numbers in each radix, then drop them.
+BENCH(console_numbers) { run(console_cmds_test, "123 -4567 $abcd +789\rDROP DROP DROP DROP"); }
+
+// Lookup commands in the generated table.
+BENCH(console_commands) { run(console_cmds_test, "?VER CMD RLY ?S NV-DEFAULT ?T\rDROP DROP DROP DROP DROP DROP"); }
+
+// As console_commands but with the switch, to compare with the generated table.
+BENCH(console_commands_switch) { run(console_cmds_test_switch, "?VER CMD RLY ?S NV-DEFAULT ?T\rDROP DROP DROP DROP DROP DROP"); }
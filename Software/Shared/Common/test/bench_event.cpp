@@ -0,0 +1,18 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bench.h"
+#include "project_config.h"
+#include "utils.h"
+#include "event.h"
+
+// Trace mask, normally in NV. All zero so nothing is traced.
+static uint8_t f_trace_mask[EVENT_TRACE_MASK_SIZE];
+uint8_t* eventGetTraceMask() { return f_trace_mask; }
+
+// Publish & get with tracing off, the queue is never full.
+BENCH_N(event_publish_get, 2) {
+	eventPublish(EV_SAMPLE_1, 1, 2);
+	benchSink(eventGet());
+}
@@ -0,0 +1,11 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bench.h"
+#include "modbus.h"
+
+static uint8_t f_frame[256];
+BENCH(modbus_crc_8) { benchSink(modbusCrc(f_frame, 8)); }
+BENCH(modbus_crc_64) { benchSink(modbusCrc(f_frame, 64)); }
+BENCH(modbus_crc_255) { benchSink(modbusCrc(f_frame, 255)); }
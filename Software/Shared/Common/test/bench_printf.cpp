@@ -0,0 +1,24 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "bench.h"
+#include "project_config.h"
+#include "myprintf.h"
+
+static char f_buf[64];
+static uint16_t f_n;
+
+BENCH(printf_d) { benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%d", (int)(f_n++ - 30000U))); }
+BENCH(printf_u) { benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%u", f_n++)); }
+BENCH(printf_x) { benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%x", f_n++)); }
+BENCH(printf_lu) { benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%lu", 3000000000UL + f_n++)); }
+BENCH(printf_ld) { benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%ld", -2000000000L + f_n++)); }
+BENCH(printf_mixed) {
+	benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "T%5d S%s %02x %c", f_n++, "ok", 0xa5, 'z'));
+}
+BENCH(printf_width) {
+	benchSink((uint32_t)myprintf_snprintf(f_buf, sizeof(f_buf), "%8ld|%08lx|%-6u|", 123456L + f_n, 0xbeefUL + f_n, f_n));
+	f_n += 1;
+}
@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bench.h"
+#include "project_config.h"
+#include "utils.h"
+#include "thread.h"
+
+// Each benchmark call is one tick.
+static thread_ticks_t f_ticks;
+thread_ticks_t threadGetTicks() { return f_ticks; }
+
+// 32 threads with periods from 10 to 80 ticks, the same work either polled every tick with threadRun() or scheduled.
+#define BENCH_THREAD_COUNT 32
+static thread_ticks_t period(void* arg) { return (thread_ticks_t)(10U * (((uintptr_t)arg % 8U) + 1U)); }
+
+static int8_t thread_delayer(void* arg) {
+	THREAD_BEGIN();
+	while (1) {
+		benchSink((uint32_t)(uintptr_t)arg);
+		THREAD_DELAY(period(arg) - 1U);		// THREAD_DELAY(n) waits for more than n ticks.
+	}
+	THREAD_END();
+}
+static int8_t thread_sleeper(void* arg) {
+	THREAD_BEGIN();
+	while (1) {
+		benchSink((uint32_t)(uintptr_t)arg);
+		THREAD_SLEEP(period(arg));
+	}
+	THREAD_END();
+}
+
+BENCH(thread_polled_tick) {
+	static thread_control_t tcs[BENCH_THREAD_COUNT];
+	static bool init;
+	if (!init) {
+		fori (BENCH_THREAD_COUNT)
+			threadInit(&tcs[i]);
+		init = true;
+	}
+	fori (BENCH_THREAD_COUNT)
+		threadRun(&tcs[i], thread_delayer, (void*)(uintptr_t)i);
+	f_ticks += 1;
+}
+
+BENCH(thread_sched_tick) {
+	static thread_sched_tcb_t tcbs[BENCH_THREAD_COUNT];
+	static bool init;
+	if (!init) {
+		threadSchedInit();
+		fori (BENCH_THREAD_COUNT)
+			threadSchedAdd(&tcbs[i], thread_sleeper, (void*)(uintptr_t)i);
+		init = true;
+	}
+	benchSink(threadSchedService());
+	f_ticks += 1;
+}
@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Arduino.h"
+#include "bench.h"
+#include "project_config.h"
+#include "utils.h"
+
+DECLARE_QUEUE_TYPE(Bench, uint8_t, 16)
+static QueueBench f_queue;
+
+// A put & a get on a queue that is kept half full.
+BENCH_N(queue_put_get, 2) {
+	uint8_t x = 0x5a;
+	queueBenchPut(&f_queue, &x);
+	if (queueBenchLen(&f_queue) > 8)
+		queueBenchGet(&f_queue, &x);
+	queueBenchGet(&f_queue, &x);
+	queueBenchPut(&f_queue, &x);
+	benchSink(x);
+}
+
+static uint16_t f_filter_input;
+BENCH(utils_filter_u16) {
+	static uint32_t accum;
+	benchSink(utilsFilter(&accum, f_filter_input++, 4, false));
+}
+BENCH(utils_filter_i16) {
+	static int32_t accum;
+	benchSink((uint32_t)utilsFilter(&accum, (int16_t)f_filter_input++, 4, false));
+}
+
+static uint8_t f_data[64];
+BENCH(checksum_fletcher16_64) { benchSink(utilsChecksumFletcher16(f_data, sizeof(f_data))); }
+
+BENCH(checksum_eeprom_64) {
+	UtilsChecksumEepromState s;
+	utilsChecksumEepromInit(&s);
+	utilsChecksumEepromUpdate(&s, f_data, sizeof(f_data));
+	benchSink(utilsChecksumEepromGet(&s));
+}
+
+BENCH(str_scan_int) {
+	unsigned n;
+	char* end;
+	benchSink((uint32_t)utilsStrtoui(&n, "12345 ", &end, 10) + n);
+}
+
+// Multiple threshold lookup on a 200 entry table, compared with a linear scan as utilsMultiThreshold() used to do. The input mostly stays in
+// the same band with an occasional jump, as for a filtered ADC reading.
+enum { BENCH_THRESHOLD_COUNT = 200 };
+static uint16_t f_thresholds[BENCH_THRESHOLD_COUNT], f_hysteresis[BENCH_THRESHOLD_COUNT];
+static uint16_t f_threshold_inputs[64];
+static uint8_t f_threshold_input_idx;
+static struct BenchThresholdInit {
+	BenchThresholdInit() {
+		fori (BENCH_THRESHOLD_COUNT) {
+			f_thresholds[i] = (uint16_t)(100U + i * 300U);
+			f_hysteresis[i] = 20;
+		}
+		fori (UTILS_ELEMENT_COUNT(f_threshold_inputs))
+			f_threshold_inputs[i] = (uint16_t)((i % 16) ? (30000U + (i % 5) * 7U) : (i * 900U));
+	}
+} f_bench_threshold_init;
+static uint16_t threshold_input() { return f_threshold_inputs[f_threshold_input_idx++ % UTILS_ELEMENT_COUNT(f_threshold_inputs)]; }
+
+BENCH(multi_threshold_table_200) {
+	static uint8_t level;
+	utilsMultiThresholdTableU16(f_thresholds, f_hysteresis, BENCH_THRESHOLD_COUNT, &level, threshold_input());
+	benchSink(level);
+}
+BENCH(multi_threshold_linear_200) {
+	static uint8_t level;
+	const uint16_t val = threshold_input();
+	uint8_t new_level = 0;
+	fori (BENCH_THRESHOLD_COUNT)
+		new_level = (uint8_t)(new_level + (val > ((i < level) ? (uint16_t)(f_thresholds[i] - f_hysteresis[i]) : f_thresholds[i])));
+	level = new_level;
+	benchSink(level);
+}
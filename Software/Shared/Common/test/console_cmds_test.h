@@ -0,0 +1,194 @@
+#ifndef CONSOLE_CMDS_TEST_H__
+#define CONSOLE_CMDS_TEST_H__
+
+// This file is autogenerated from `console_cmds_test.src'. Do not edit, your changes will be lost!
+
+
+// Test
+static void console_cmd_0() {		// ?VER
+	consoleStackPush(100);
+}
+static void console_cmd_1() {		// CMD
+	consoleStackPush(101);
+}
+static void console_cmd_2() {		// LED
+	consoleStackPush(102);
+}
+static void console_cmd_3() {		// ?LED
+	consoleStackPush(103);
+}
+static void console_cmd_4() {		// RLY
+	consoleStackPush(104);
+}
+static void console_cmd_5() {		// ?RLY
+	consoleStackPush(105);
+}
+static void console_cmd_6() {		// ?S
+	consoleStackPush(106);
+}
+static void console_cmd_7() {		// ?PR
+	consoleStackPush(107);
+}
+static void console_cmd_8() {		// PR
+	consoleStackPush(108);
+}
+static void console_cmd_9() {		// ?LIM
+	consoleStackPush(109);
+}
+static void console_cmd_10() {		// LIM
+	consoleStackPush(110);
+}
+static void console_cmd_11() {		// BL
+	consoleStackPush(111);
+}
+static void console_cmd_12() {		// EVENT
+	consoleStackPush(112);
+}
+static void console_cmd_13() {		// EVENT-EX
+	consoleStackPush(113);
+}
+static void console_cmd_14() {		// CTM
+	consoleStackPush(114);
+}
+static void console_cmd_15() {		// DTM
+	consoleStackPush(115);
+}
+static void console_cmd_16() {		// ?TM
+	consoleStackPush(116);
+}
+static void console_cmd_17() {		// ??TM
+	consoleStackPush(117);
+}
+static void console_cmd_18() {		// STM
+	consoleStackPush(118);
+}
+static void console_cmd_19() {		// M
+	consoleStackPush(119);
+}
+static void console_cmd_20() {		// ATN
+	consoleStackPush(120);
+}
+static void console_cmd_21() {		// SL
+	consoleStackPush(121);
+}
+static void console_cmd_22() {		// ?SL
+	consoleStackPush(122);
+}
+static void console_cmd_23() {		// SEND-RAW
+	consoleStackPush(123);
+}
+static void console_cmd_24() {		// SEND
+	consoleStackPush(124);
+}
+static void console_cmd_25() {		// WRITE
+	consoleStackPush(125);
+}
+static void console_cmd_26() {		// READ
+	consoleStackPush(126);
+}
+static void console_cmd_27() {		// ?V
+	consoleStackPush(127);
+}
+static void console_cmd_28() {		// V
+	consoleStackPush(128);
+}
+static void console_cmd_29() {		// ??V
+	consoleStackPush(129);
+}
+static void console_cmd_30() {		// ???V
+	consoleStackPush(130);
+}
+static void console_cmd_31() {		// DUMP
+	consoleStackPush(131);
+}
+static void console_cmd_32() {		// X
+	consoleStackPush(132);
+}
+static void console_cmd_33() {		// RESTART
+	consoleStackPush(133);
+}
+static void console_cmd_34() {		// CLI
+	consoleStackPush(134);
+}
+static void console_cmd_35() {		// ABORT
+	consoleStackPush(135);
+}
+static void console_cmd_36() {		// ASSERT
+	consoleStackPush(136);
+}
+static void console_cmd_37() {		// NV-DEFAULT
+	consoleStackPush(137);
+}
+static void console_cmd_38() {		// NV-W
+	consoleStackPush(138);
+}
+static void console_cmd_39() {		// NV-R
+	consoleStackPush(139);
+}
+static void console_cmd_40() {		// PIN
+	consoleStackPush(140);
+}
+static void console_cmd_41() {		// ?PIN
+	consoleStackPush(141);
+}
+static void console_cmd_42() {		// PMODE
+	consoleStackPush(142);
+}
+static void console_cmd_43() {		// ?T
+	consoleStackPush(143);
+}
+
+static const uint8_t CONSOLE_CMDS_DISP[13] PROGMEM = {
+	89, 0, 2, 10, 0, 30, 76, 7, 0, 63, 0, 64, 43
+};
+static const console_cmd_def_t CONSOLE_CMDS_DEFS[44] PROGMEM = {
+	{ 0x5007, console_cmd_36 },                   // ASSERT
+	{ 0xd063, console_cmd_34 },                   // CLI
+	{ 0x48d6, console_cmd_42 },                   // PMODE
+	{ 0x4fe9, console_cmd_31 },                   // DUMP
+	{ 0x688c, console_cmd_27 },                   // ?V
+	{ 0xd17f, console_cmd_14 },                   // CTM
+	{ 0xb5e8, console_cmd_19 },                   // M
+	{ 0xd00f, console_cmd_1 },                    // CMD
+	{ 0xbcb8, console_cmd_15 },                   // DTM
+	{ 0x74c7, console_cmd_8 },                    // PR
+	{ 0x6889, console_cmd_6 },                    // ?S
+	{ 0xdd37, console_cmd_3 },                    // ?LED
+	{ 0xa8c2, console_cmd_39 },                   // NV-R
+	{ 0x116f, console_cmd_18 },                   // STM
+	{ 0xa8f8, console_cmd_25 },                   // WRITE
+	{ 0xb21d, console_cmd_5 },                    // ?RLY
+	{ 0xdeb2, console_cmd_9 },                    // ?LIM
+	{ 0xd8b7, console_cmd_26 },                   // READ
+	{ 0x1012, console_cmd_40 },                   // PIN
+	{ 0xa9ad, console_cmd_41 },                   // ?PIN
+	{ 0x7998, console_cmd_7 },                    // ?PR
+	{ 0x85d3, console_cmd_29 },                   // ??V
+	{ 0x7092, console_cmd_33 },                   // RESTART
+	{ 0x76f9, console_cmd_24 },                   // SEND
+	{ 0xdc88, console_cmd_2 },                    // LED
+	{ 0xfcdb, console_cmd_37 },                   // NV-DEFAULT
+	{ 0xf690, console_cmd_23 },                   // SEND-RAW
+	{ 0xb5fd, console_cmd_32 },                   // X
+	{ 0x3fbc, console_cmd_17 },                   // ??TM
+	{ 0x728b, console_cmd_11 },                   // BL
+	{ 0xb87e, console_cmd_20 },                   // ATN
+	{ 0x2f99, console_cmd_13 },                   // EVENT-EX
+	{ 0x7a03, console_cmd_16 },                   // ?TM
+	{ 0xa8c7, console_cmd_38 },                   // NV-W
+	{ 0x07a2, console_cmd_4 },                    // RLY
+	{ 0xdb0d, console_cmd_10 },                   // LIM
+	{ 0x3cac, console_cmd_30 },                   // ???V
+	{ 0xfeaf, console_cmd_35 },                   // ABORT
+	{ 0xb5f3, console_cmd_28 },                   // V
+	{ 0x688e, console_cmd_43 },                   // ?T
+	{ 0xc33b, console_cmd_0 },                    // ?VER
+	{ 0x79e5, console_cmd_22 },                   // ?SL
+	{ 0x8a29, console_cmd_12 },                   // EVENT
+	{ 0x74fa, console_cmd_21 },                   // SL
+};
+static bool console_cmds_test(char* cmd) {
+	return consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, 13, CONSOLE_CMDS_DEFS, 44);
+}
+
+#endif   // CONSOLE_CMDS_TEST_H__
@@ -258,7 +258,7 @@ for fn in input_files:
 				fixture = None
 			elif macro == 'TT_TEST_CASE':
 				print(f"`{raw_args}`")
-				m = re.match(r'(.+)\((.*)\)\s*$', raw_args)
+				m = re.match(r'([^(]+)\((.*)\)\s*$', raw_args)
 				if not m:
 					exit(f"Macro at `{ln}' needs to be like {macro}(func(args))")
 				test_func, test_args = m.groups()
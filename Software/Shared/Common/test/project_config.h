@@ -6,6 +6,13 @@
 #define CFG_EVENT_TRACE_BUFFER_SIZE 4
 #define CFG_EVENT_TIMER_COUNT 2
 
+// For thread, use gcc computed goto.
+#define CFG_LC2_USE_SWITCH 0
+
+// For loop_prof.
+#define CFG_WANT_LOOP_PROF 1
+#define CFG_LOOP_PROF_SERVICE_COUNT 3
+
 // For myprintf.
 #if MYPRINTF_TEST_BINARY
  #define CFG_MYPRINTF_WANT_BINARY 1
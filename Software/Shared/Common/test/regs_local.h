@@ -0,0 +1,127 @@
+#ifndef REGS_LOCAL_H__
+#define REGS_LOCAL_H__
+
+// Registers for testing.
+const uint16_t REGS_DEF_VERSION = 1;
+
+/* [[[ Definition start...
+FLAGS [fmt=hex] "Various flags."
+- FAULT [bit=0] "A fault."
+- WARNING [bit=1] "A warning."
+VALUE_0 "Value 0."
+VALUE_1 [fmt=signed] "Value 1."
+VALUE_2 "Value 2."
+VALUE_3 "Value 3."
+VALUE_4 "Value 4."
+VALUE_5 "Value 5."
+VALUE_6 "Value 6."
+VALUE_7 "Value 7."
+ENABLES [nv fmt=hex] "Non-volatile enable flags."
+- DUMP_REGS [bit=1] "Enable regs dump to console."
+SETTING [nv default=123] "A setting."
+>>>  Definition end, declaration start... */
+
+// Declare the indices to the registers.
+enum {
+    REGS_IDX_FLAGS = 0,
+    REGS_IDX_VALUE_0 = 1,
+    REGS_IDX_VALUE_1 = 2,
+    REGS_IDX_VALUE_2 = 3,
+    REGS_IDX_VALUE_3 = 4,
+    REGS_IDX_VALUE_4 = 5,
+    REGS_IDX_VALUE_5 = 6,
+    REGS_IDX_VALUE_6 = 7,
+    REGS_IDX_VALUE_7 = 8,
+    REGS_IDX_ENABLES = 9,
+    REGS_IDX_SETTING = 10,
+    COUNT_REGS = 11
+};
+
+// Define the start of the NV regs. The region is from this index up to the end of the register array.
+#define REGS_START_NV_IDX REGS_IDX_ENABLES
+
+// Define default values for the NV segment.
+#define REGS_NV_DEFAULT_VALS 0, 123
+
+// Define how to format the reg when printing.
+#define REGS_FORMAT_DEF CFMT_X, CFMT_U, CFMT_D, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_U, CFMT_X, CFMT_U
+
+// Flags/masks for register FLAGS.
+enum {
+    	REGS_FLAGS_MASK_FAULT = (int)0x1,
+    	REGS_FLAGS_MASK_WARNING = (int)0x2,
+};
+
+// Flags/masks for register ENABLES.
+enum {
+    	REGS_ENABLES_MASK_DUMP_REGS = (int)0x2,
+};
+
+// Declare an array of names for each register.
+#define DECLARE_REGS_NAMES()                                                            \
+ static const char REGS_NAMES_0[] PROGMEM = "FLAGS";                                    \
+ static const char REGS_NAMES_1[] PROGMEM = "VALUE_0";                                  \
+ static const char REGS_NAMES_2[] PROGMEM = "VALUE_1";                                  \
+ static const char REGS_NAMES_3[] PROGMEM = "VALUE_2";                                  \
+ static const char REGS_NAMES_4[] PROGMEM = "VALUE_3";                                  \
+ static const char REGS_NAMES_5[] PROGMEM = "VALUE_4";                                  \
+ static const char REGS_NAMES_6[] PROGMEM = "VALUE_5";                                  \
+ static const char REGS_NAMES_7[] PROGMEM = "VALUE_6";                                  \
+ static const char REGS_NAMES_8[] PROGMEM = "VALUE_7";                                  \
+ static const char REGS_NAMES_9[] PROGMEM = "ENABLES";                                  \
+ static const char REGS_NAMES_10[] PROGMEM = "SETTING";                                 \
+                                                                                        \
+ static const char* const REGS_NAMES[] PROGMEM = {                                      \
+   REGS_NAMES_0,                                                                        \
+   REGS_NAMES_1,                                                                        \
+   REGS_NAMES_2,                                                                        \
+   REGS_NAMES_3,                                                                        \
+   REGS_NAMES_4,                                                                        \
+   REGS_NAMES_5,                                                                        \
+   REGS_NAMES_6,                                                                        \
+   REGS_NAMES_7,                                                                        \
+   REGS_NAMES_8,                                                                        \
+   REGS_NAMES_9,                                                                        \
+   REGS_NAMES_10,                                                                       \
+ }
+
+// Declare an array of description text for each register.
+#define DECLARE_REGS_DESCRS()                                                           \
+ static const char REGS_DESCRS_0[] PROGMEM = "Various flags.";                          \
+ static const char REGS_DESCRS_1[] PROGMEM = "Value 0.";                                \
+ static const char REGS_DESCRS_2[] PROGMEM = "Value 1.";                                \
+ static const char REGS_DESCRS_3[] PROGMEM = "Value 2.";                                \
+ static const char REGS_DESCRS_4[] PROGMEM = "Value 3.";                                \
+ static const char REGS_DESCRS_5[] PROGMEM = "Value 4.";                                \
+ static const char REGS_DESCRS_6[] PROGMEM = "Value 5.";                                \
+ static const char REGS_DESCRS_7[] PROGMEM = "Value 6.";                                \
+ static const char REGS_DESCRS_8[] PROGMEM = "Value 7.";                                \
+ static const char REGS_DESCRS_9[] PROGMEM = "Non-volatile enable flags.";              \
+ static const char REGS_DESCRS_10[] PROGMEM = "A setting.";                             \
+                                                                                        \
+ static const char* const REGS_DESCRS[] PROGMEM = {                                     \
+   REGS_DESCRS_0,                                                                       \
+   REGS_DESCRS_1,                                                                       \
+   REGS_DESCRS_2,                                                                       \
+   REGS_DESCRS_3,                                                                       \
+   REGS_DESCRS_4,                                                                       \
+   REGS_DESCRS_5,                                                                       \
+   REGS_DESCRS_6,                                                                       \
+   REGS_DESCRS_7,                                                                       \
+   REGS_DESCRS_8,                                                                       \
+   REGS_DESCRS_9,                                                                       \
+   REGS_DESCRS_10,                                                                      \
+ }
+
+// Declare a multiline string description of the fields.
+#define DECLARE_REGS_HELPS()                                                            \
+ static const char REGS_HELPS[] PROGMEM =                                               \
+    "\nFlags:"                                                                          \
+    "\n FAULT: 0 (A fault.)"                                                            \
+    "\n WARNING: 1 (A warning.)"                                                        \
+    "\nEnables:"                                                                        \
+    "\n DUMP_REGS: 1 (Enable regs dump to console.)"                                    \
+
+// ]]] Declarations end
+
+#endif // REGS_LOCAL_H__
@@ -1,4 +1,10 @@
+#include <stdlib.h>
+
+#include "Arduino.h"
 #include "support_test.h"
+#include "utils.h"
+
+volatile uint8_t g_test_ports[TEST_PORT_COUNT];
 
 // We keep a fake count of micros in 32 bits, range about 70 mins. From this we compute millis.
 static uint32_t l_fake_micros;
@@ -18,3 +24,9 @@ void support_test_add_micros(uint32_t inc) {
 	if (l_fake_micros < old_fake_micros)
 		micros_ovf += 1;
 }
+
+// Runtime errors from ASSERT() in the code under test just abort.
+void debugRuntimeError(int fileno, int lineno, int errorno) {
+	fprintf(stderr, "Runtime error: file %d, line %d, error %d\n", fileno, lineno, errorno);
+	abort();
+}
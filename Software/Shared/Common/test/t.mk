@@ -14,8 +14,8 @@ OTHER_SRCS_myprintf = ../src/myprintf.cpp
 OTHER_SRCS_buffer =
 OTHER_SRCS_utils = ../src/utils.cpp
 OTHER_SRCS_all = ../src/myprintf.cpp ../src/event.cpp ../src/modbus.cpp \
-				../src/utils.cpp support_test.cpp
-#console.cpp regs.cpp  sw_scanner.cpp  thread.cpp ../src/buffer.cpp
+				../src/utils.cpp ../src/console.cpp ../src/regs.cpp ../src/lcd_fb.cpp ../src/sw_scanner.cpp ../src/thread.cpp ../src/loop_prof.cpp ../src/poll_backoff.cpp \
+				../src/modbus_rbe.cpp support_test.cpp
 
 # Select source files, maybe use use local symbols instead.
 TEST_SRCS = $(TEST_SRCS_$(TARGET))
@@ -34,7 +34,7 @@ EXTRAS =
 DEFINES = -DUNITY_INCLUDE_CONFIG_H -DTEST -DNO_CRITICAL_SECTIONS -DUSE_PROJECT_CONFIG_H \
 		    -DMYPRINTF_TEST_BINARY=1
 LINK_FLAGS =
-INCLUDES = -I. -I../include
+INCLUDES = -I. -I../include -I../../AVR/include
 LIBS = -lgcov
 LIB_PATH =
 
@@ -66,7 +66,7 @@ _dummy := $(shell $(MKDIR) $(BUILD_DIR))
 EXE = $(BUILD_DIR)/$(TEST_MAIN_SRC)
 OBJS = $(addprefix $(BUILD_DIR)/, $(addsuffix .o, $(basename $(notdir $(SRCS)))))
 
-.PHONY : clean all clean-all verify test-quiet
+.PHONY : clean all clean-all verify test-quiet bench
 
 # Main target.
 all : $(EXE)
@@ -84,6 +84,10 @@ $(EXE) : $(OBJS)
 $(TEST_MAIN_SRC).cpp : $(TEST_SRCS)
 	./grm.py -v -o $@ $^
 
+# Console command table for test_console.cpp.
+console_cmds_test.h : console_cmds_test.src
+	../../../Tools/mk_console.py $< -o $@ --no-builds --name console_cmds_test
+
 clean :
 	$(RM) $(BUILD_DIR) $(TEST_MAIN_SRC).cpp
 
@@ -100,7 +104,7 @@ $(BUILD_DIR)/%.o : %.c
 	$(CC) -c $< $(CFLAGS) -o $@ $(INCLUDES)
 	@$(CC) $(CFLAGS) $(INCLUDES) -E -o $(addsuffix .i, $(basename $@)) $<
 
--include $(BUILD_DIR)/*.d
+-include $(BUILD_DIR)/*.d $(BENCH_DIR)/*.d
 
 test-quiet : $(EXE)
 	$(RM) $(BUILD_DIR)/*.gcda
@@ -113,3 +117,22 @@ test : $(EXE)
 coverage : test-quiet
 	lcov --capture --directory . --output-file $(BUILD_DIR)/coverage.info
 	genhtml $(BUILD_DIR)/coverage.info --output-directory $(BUILD_DIR)
+
+# Microbenchmarks, see bench.h. They are built optimised without coverage in their own build dir. Results are written as CSV to stdout and
+#  to $(BENCH_DIR)/bench.csv, compare two runs with `bench_compare.py old.csv new.csv'. Set BENCH_ARGS to pass options & name filters.
+BENCH_DIR = $(BUILD_PREFIX)-bench
+BENCH_EXE = $(BENCH_DIR)/bench
+BENCH_SRCS = $(wildcard bench*.cpp) ../src/myprintf.cpp ../src/event.cpp ../src/modbus.cpp ../src/utils.cpp ../src/console.cpp ../src/thread.cpp support_test.cpp
+BENCH_OBJS = $(addprefix $(BENCH_DIR)/, $(addsuffix .o, $(basename $(notdir $(BENCH_SRCS)))))
+BENCH_CXXFLAGS := -g -O2 $(WARN_FLAGS) $(DEFINES) $(EXTRAS)
+BENCH_ARGS =
+
+bench : $(BENCH_EXE)
+	$(BENCH_EXE) $(BENCH_ARGS) | tee $(BENCH_DIR)/bench.csv
+
+$(BENCH_EXE) : $(BENCH_OBJS)
+	$(LINK) -o $@ $^ $(LIB_PATH) $(LINK_FLAGS)
+
+$(BENCH_DIR)/%.o : %.cpp
+	@$(MKDIR) $(BENCH_DIR)
+	$(CXX) -c $< $(BENCH_CXXFLAGS) $(INCLUDES) -MMD -MP -o $@
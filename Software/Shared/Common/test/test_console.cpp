@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "console.h"
+TT_END_INCLUDE()
+
+#include "utils.h"
+
+// Commands from console_cmds_test.src, run `mk_console.py console_cmds_test.src -o console_cmds_test.h --no-builds --name console_cmds_test'.
+#include "console_cmds_test.h"
+
+static const char* const CMD_NAMES[] = {
+	"?VER", "CMD", "LED", "?LED", "RLY", "?RLY", "?S", "?PR", "PR", "?LIM", "LIM", "BL", "EVENT", "EVENT-EX", "CTM", "DTM", "?TM", "??TM", "STM",
+	"M", "ATN", "SL", "?SL", "SEND-RAW", "SEND", "WRITE", "READ", "?V", "V", "??V", "???V", "DUMP", "X", "RESTART", "CLI", "ABORT", "ASSERT",
+	"NV-DEFAULT", "NV-W", "NV-R", "PIN", "?PIN", "PMODE", "?T",
+};
+
+// Stream that reads from a string and writes to a buffer.
+class StreamTest : public Stream {
+public:
+	const char* in;
+	char out[200];
+	size_t out_idx;
+
+	void reset(const char* s) { in = s; out_idx = 0; out[0] = '\0'; }
+	virtual size_t write(uint8_t c) {
+		if (out_idx < (sizeof(out) - 1)) {
+			out[out_idx++] = (char)c;
+			out[out_idx] = '\0';
+		}
+		return 1;
+	}
+	virtual int available() { return ('\0' != *in); }
+	virtual int read() { return *in++; }
+};
+static StreamTest f_stream;
+
+// Run a line, which must end in a `\r', through the console and return the status.
+static console_rc_t run(const char* line) {
+	f_stream.reset(line);
+	return consoleService();
+}
+
+void testConsoleSetup() { consoleInit(console_cmds_test, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO); }
+TT_BEGIN_FIXTURE(testConsoleSetup, NULL, NULL);
+
+void testConsoleCmdsLookupAll() {
+	fori (UTILS_ELEMENT_COUNT(CMD_NAMES)) {
+		char line[20], expected[10];
+		snprintf(line, sizeof(line), "%s .\r", CMD_NAMES[i]);
+		snprintf(expected, sizeof(expected), "%d ", 100 + i);
+		TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run(line));
+		TEST_ASSERT_EQUAL_STRING(expected, f_stream.out);
+	}
+}
+void testConsoleCmdsLookupLowerCase() {
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run("nv-default .\r"));
+	TEST_ASSERT_EQUAL_STRING("137 ", f_stream.out);
+}
+void testConsoleCmdsLookupUnknown() {
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_UNKNOWN_COMMAND, run("LEDS\r"));
+	TEST_ASSERT_EQUAL_STRING("Error: unknown command : 4", f_stream.out);
+}
+void testConsoleCmdsLookupNumbersAndBuiltins() {
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run("123 $ff ?T DROP . .\r"));
+	TEST_ASSERT_EQUAL_STRING("255 123 ", f_stream.out);
+}
+void testConsoleCmdsLookupStopsOnError() {
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_UNKNOWN_COMMAND, run("1 . FOO 2 .\r"));
+	TEST_ASSERT_EQUAL(0, strncmp("1 Error:", f_stream.out, 8));
+}
+
+// Scripts.
+static const char SCRIPT_OK[] PROGMEM = "1 2 .\r?VER .\n\n  3 .\r4 .";
+static const char SCRIPT_FAIL[] PROGMEM = "1 .\r2 FOO 3 .\r4 .";
+static console_rc_t script_rc;
+
+// Recogniser for testing scripts run from a command, `RUN' runs the string at TOS as a script and raises any error.
+static bool console_cmds_script_test(char* cmd) {
+	if (0 == strcmp(cmd, "RUN")) {
+		script_rc = consoleScriptRun((const char*)consoleStackPop(), consoleScriptReadRam);
+		if (CONSOLE_RC_OK != script_rc)
+			consoleRaise(script_rc);
+		return true;
+	}
+	return console_cmds_test(cmd);
+}
+
+void testConsoleScriptOk() {
+	f_stream.reset("");
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, consoleScriptRun(SCRIPT_OK, consoleScriptReadProgmem));
+	TEST_ASSERT_EQUAL_STRING("2 100 3 4 ", f_stream.out);
+}
+void testConsoleScriptEmpty() {
+	f_stream.reset("");
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, consoleScriptRun("", consoleScriptReadRam));
+	TEST_ASSERT_EQUAL_STRING("", f_stream.out);
+}
+void testConsoleScriptStopsOnError() {
+	f_stream.reset("");
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_UNKNOWN_COMMAND, consoleScriptRun(SCRIPT_FAIL, consoleScriptReadProgmem));
+	TEST_ASSERT_EQUAL_STRING("1 Script line 2 at `FOO' ", f_stream.out);
+}
+void testConsoleScriptLineOverflow() {
+	f_stream.reset("");
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_ACCEPT_BUFFER_OVERFLOW, consoleScriptRun("1 .\r1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18\r", consoleScriptReadRam));
+	TEST_ASSERT_EQUAL(0, strncmp("1 Script line 2 at `1 2 3", f_stream.out, 25));
+}
+void testConsoleScriptFromCommand() {
+	consoleInit(console_cmds_script_test, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run("\"1\\20.\\0d2\\20. RUN 3 .\r"));		// Script is `1 .\r2 .'.
+	TEST_ASSERT_EQUAL_STRING("1 2 3 ", f_stream.out);
+}
+void testConsoleScriptErrorFromCommand() {
+	consoleInit(console_cmds_script_test, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_DSTACK_UNDERFLOW, run("\"DROP RUN 3 .\r"));
+	TEST_ASSERT_EQUAL_STRING("Script line 1 at `DROP' Error: stack underflow : 2", f_stream.out);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run("4 .\r"));		// Still works after error.
+	TEST_ASSERT_EQUAL_STRING("4 ", f_stream.out);
+}
+void testConsoleScriptNested() {
+	consoleInit(console_cmds_script_test, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO);
+	static char inner[] = "\"5\\20. RUN";		// Script that runs another script.
+	char outer[40];
+	snprintf(outer, sizeof(outer), "$%lx RUN\r", (unsigned long)(uintptr_t)inner);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run(outer));
+	TEST_ASSERT_EQUAL_STRING("5 ", f_stream.out);
+}
+void testConsoleScriptNestedTooDeep() {
+	consoleInit(console_cmds_script_test, f_stream, CONSOLE_FLAG_NO_PROMPT | CONSOLE_FLAG_NO_ECHO);
+	static char self[40];		// Script that runs itself.
+	snprintf(self, sizeof(self), "$%lx RUN", (unsigned long)(uintptr_t)self);
+	char line[sizeof(self) + 1];
+	snprintf(line, sizeof(line), "%s\r", self);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_SCRIPT_NESTED, run(line));
+	TEST_ASSERT_EQUAL(CONSOLE_RC_ERROR_SCRIPT_NESTED, script_rc);
+	TEST_ASSERT_EQUAL(CONSOLE_RC_OK, run("4 .\r"));
+	TEST_ASSERT_EQUAL_STRING("4 ", f_stream.out);
+}
@@ -0,0 +1,153 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+#include "lcd_fb.h"
+TT_END_INCLUDE()
+
+// Mock LCD that has a queue of limited size, and a display that is written when the queue is flushed.
+static struct {
+	char display[CFG_LCD_FB_ROWS][CFG_LCD_FB_COLS];
+	uint8_t col, row;
+	uint16_t queue_free;			// Bytes free in queue.
+	uint8_t cursor_count, write_count;
+} f_mock;
+
+static bool mock_set_cursor(uint8_t col, uint8_t row) {
+	if (f_mock.queue_free < LCD_FB_QUEUE_BYTES_CURSOR) return false;
+	f_mock.queue_free = (uint16_t)(f_mock.queue_free - LCD_FB_QUEUE_BYTES_CURSOR);
+	f_mock.col = col; f_mock.row = row;
+	f_mock.cursor_count += 1;
+	return true;
+}
+static bool mock_write(uint8_t c) {
+	if (f_mock.queue_free < LCD_FB_QUEUE_BYTES_CHAR) return false;
+	f_mock.queue_free = (uint16_t)(f_mock.queue_free - LCD_FB_QUEUE_BYTES_CHAR);
+	TEST_ASSERT(f_mock.col < CFG_LCD_FB_COLS);		// The framebuffer should never rely on the cursor moving off the end of a row.
+	f_mock.display[f_mock.row][f_mock.col++] = (char)c;
+	f_mock.write_count += 1;
+	return true;
+}
+static void mock_reset_counts(uint16_t queue_free=1000) {
+	f_mock.queue_free = queue_free;
+	f_mock.cursor_count = f_mock.write_count = 0;
+}
+
+// Write a row as lcd_printf() in gui.cpp does.
+static void print_row(uint8_t row, const char* s) {
+	lcdFbSetCursor(0, row);
+	while ('\0' != *s)
+		lcdFbWrite(*s++);
+	lcdFbClearToEol();
+}
+static void assert_display_row(uint8_t row, const char* s) {
+	char expected[CFG_LCD_FB_COLS + 1];
+	snprintf(expected, sizeof(expected), "%-*s", CFG_LCD_FB_COLS, s);
+	TEST_ASSERT_EQUAL_CHAR_ARRAY(expected, f_mock.display[row], CFG_LCD_FB_COLS);
+}
+
+void testLcdFbSetup() {
+	memset(f_mock.display, ' ', sizeof(f_mock.display));		// LCD is clear after initialisation.
+	mock_reset_counts();
+	lcdFbInit(mock_set_cursor, mock_write);
+}
+TT_BEGIN_FIXTURE(testLcdFbSetup, NULL, NULL);
+
+void testLcdFbNoChangeSendsNothing() {
+	TEST_ASSERT(lcdFbUpdate());
+	print_row(0, "");
+	TEST_ASSERT(lcdFbUpdate());
+	TEST_ASSERT_EQUAL_UINT8(0, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(0, f_mock.write_count);
+	TEST_ASSERT_EQUAL_UINT32(0, lcdFbStats()->queued);
+	TEST_ASSERT_EQUAL_UINT32(LCD_FB_QUEUE_BYTES_CURSOR + CFG_LCD_FB_COLS * LCD_FB_QUEUE_BYTES_CHAR, lcdFbStats()->direct);
+}
+void testLcdFbWriteRows() {
+	print_row(0, "Hello");
+	print_row(1, "World!");
+	TEST_ASSERT(lcdFbUpdate());
+	assert_display_row(0, "Hello");
+	assert_display_row(1, "World!");
+	TEST_ASSERT_EQUAL_UINT8(2, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(5 + 6, f_mock.write_count);
+}
+void testLcdFbOneDigitChange() {
+	print_row(1, "H+123    T-45");
+	TEST_ASSERT(lcdFbUpdate());
+	mock_reset_counts();
+	const uint32_t queued = lcdFbStats()->queued;
+	print_row(1, "H+124    T-45");
+	TEST_ASSERT(lcdFbUpdate());
+	assert_display_row(1, "H+124    T-45");
+	TEST_ASSERT_EQUAL_UINT8(1, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(1, f_mock.write_count);
+	TEST_ASSERT_EQUAL_UINT32(queued + LCD_FB_QUEUE_BYTES_CURSOR + LCD_FB_QUEUE_BYTES_CHAR, lcdFbStats()->queued);
+}
+void testLcdFbSeparateRuns() {
+	print_row(0, "abcdefgh");
+	TEST_ASSERT(lcdFbUpdate());
+	mock_reset_counts();
+	print_row(0, "aBCdefGh");
+	TEST_ASSERT(lcdFbUpdate());
+	assert_display_row(0, "aBCdefGh");
+	TEST_ASSERT_EQUAL_UINT8(2, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(3, f_mock.write_count);
+}
+void testLcdFbClipRow() {
+	print_row(0, "0123456789abcdefXYZ");
+	TEST_ASSERT(lcdFbUpdate());
+	assert_display_row(0, "0123456789abcdef");
+	assert_display_row(1, "");
+}
+void testLcdFbQueueFull() {
+	print_row(0, "0123456789");
+	mock_reset_counts(LCD_FB_QUEUE_BYTES_CURSOR + 4 * LCD_FB_QUEUE_BYTES_CHAR);
+	TEST_ASSERT_FALSE(lcdFbUpdate());
+	assert_display_row(0, "0123");
+	mock_reset_counts();
+	TEST_ASSERT(lcdFbUpdate());						// Remainder sent on next update.
+	assert_display_row(0, "0123456789");
+	TEST_ASSERT_EQUAL_UINT8(1, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(6, f_mock.write_count);
+}
+void testLcdFbInvalidate() {
+	print_row(0, "abc");
+	TEST_ASSERT(lcdFbUpdate());
+	memset(f_mock.display, '?', sizeof(f_mock.display));		// Something else wrote the LCD.
+	lcdFbInvalidate();
+	mock_reset_counts(LCD_FB_QUEUE_BYTES_CURSOR + 4 * LCD_FB_QUEUE_BYTES_CHAR);
+	TEST_ASSERT_FALSE(lcdFbUpdate());
+	mock_reset_counts();
+	TEST_ASSERT(lcdFbUpdate());
+	assert_display_row(0, "abc");
+	assert_display_row(1, "");
+	TEST_ASSERT_EQUAL_UINT8(2, f_mock.cursor_count);
+	TEST_ASSERT_EQUAL_UINT8(CFG_LCD_FB_COLS - 4 + CFG_LCD_FB_COLS, f_mock.write_count);
+}
+
+// Compare queue bytes for a tilt display where the sensor values change slowly, with writing every row directly to the LCD.
+void testLcdFbTiltDisplaySaving() {
+	int16_t head = 100, foot = -40;
+	fori (100) {
+		char s[CFG_LCD_FB_COLS + 1];
+		head = (int16_t)(head + ((i % 3) ? 1 : 0));
+		foot = (int16_t)(foot - ((i % 7) ? 0 : 1));
+		snprintf(s, sizeof(s), "H%+-6d  T%+-6d", head, foot);
+		print_row(0, "Sargood");
+		print_row(1, s);
+		TEST_ASSERT(lcdFbUpdate());
+	}
+	const lcd_fb_stats_t* stats = lcdFbStats();
+	TEST_ASSERT_EQUAL_UINT32(100 * 2 * (LCD_FB_QUEUE_BYTES_CURSOR + CFG_LCD_FB_COLS * LCD_FB_QUEUE_BYTES_CHAR), stats->direct);
+	char msg[80];
+	snprintf(msg, sizeof(msg), "LCD queue bytes: direct %lu, queued %lu, saved %ld", (unsigned long)stats->direct,
+	  (unsigned long)stats->queued, (long)lcdFbBytesSaved());
+	TEST_MESSAGE(msg);
+	TEST_ASSERT(stats->queued * 10 < stats->direct);		// Expect better than 90% saving.
+}
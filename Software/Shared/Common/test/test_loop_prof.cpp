@@ -0,0 +1,89 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+#include "loop_prof.h"
+TT_END_INCLUDE()
+
+void testLoopProfSetup() {
+	support_test_set_millis();
+	loopProfReset();
+}
+TT_BEGIN_FIXTURE(testLoopProfSetup, NULL, NULL);
+
+// Run a loop with the given times for each service.
+static void run_loop(uint32_t t0, uint32_t t1, uint32_t t2) {
+	loopProfStart();
+	support_test_add_micros(t0); loopProfMark(0);
+	support_test_add_micros(t1); loopProfMark(1);
+	support_test_add_micros(t2); loopProfMark(2);
+}
+
+static void assert_stat(uint8_t idx, uint16_t min, uint16_t max, uint16_t mean, uint16_t count) {
+	const loop_prof_stat_t* s = loopProfStat(idx);
+	TEST_ASSERT_EQUAL_UINT16(min, s->min);
+	TEST_ASSERT_EQUAL_UINT16(max, s->max);
+	TEST_ASSERT_EQUAL_UINT16(mean, loopProfMean(s));
+	TEST_ASSERT_EQUAL_UINT16(count, s->count);
+}
+
+void testLoopProfEmpty() {
+	TEST_ASSERT_EQUAL_UINT16(0, loopProfStat(0)->count);
+	TEST_ASSERT_EQUAL_UINT16(0, loopProfMean(loopProfStat(CFG_LOOP_PROF_SERVICE_COUNT)));
+	TEST_ASSERT_EQUAL_UINT16(0, loopProfWorst()->loop);
+}
+
+void testLoopProfServiceStats() {
+	run_loop(10, 100, 20);
+	run_loop(30, 200, 20);
+	loopProfStart();
+	assert_stat(0, 10, 30, 20, 2);
+	assert_stat(1, 100, 200, 150, 2);
+	assert_stat(2, 20, 20, 20, 2);
+	assert_stat(CFG_LOOP_PROF_SERVICE_COUNT, 130, 250, 190, 2);
+}
+
+// Whole loop is only counted when the next one starts.
+void testLoopProfLoopNotCountedUntilNextStart() {
+	run_loop(10, 10, 10);
+	TEST_ASSERT_EQUAL_UINT16(0, loopProfStat(CFG_LOOP_PROF_SERVICE_COUNT)->count);
+	support_test_add_micros(5);				// Time outside services is in the loop time.
+	loopProfStart();
+	assert_stat(CFG_LOOP_PROF_SERVICE_COUNT, 35, 35, 35, 1);
+}
+
+void testLoopProfWorstLoop() {
+	run_loop(10, 100, 20);
+	run_loop(500, 100, 20);
+	run_loop(10, 100, 300);
+	run_loop(10, 10, 10);
+	loopProfStart();
+	TEST_ASSERT_EQUAL_UINT16(620, loopProfWorst()->loop);
+	TEST_ASSERT_EQUAL_UINT16(500, loopProfWorst()->services[0]);
+	TEST_ASSERT_EQUAL_UINT16(100, loopProfWorst()->services[1]);
+	TEST_ASSERT_EQUAL_UINT16(20, loopProfWorst()->services[2]);
+	TEST_ASSERT_EQUAL_UINT8(0, loopProfWorstService());
+}
+
+void testLoopProfSaturate() {
+	run_loop(100000UL, 10, 10);
+	loopProfStart();
+	TEST_ASSERT_EQUAL_UINT16(65535U, loopProfStat(0)->max);
+	TEST_ASSERT_EQUAL_UINT16(65535U, loopProfWorst()->loop);
+}
+
+void testLoopProfMeanAfterCountOverflow() {
+	for (uint32_t i = 0; i < UINT16_MAX; i += 1)
+		run_loop(10, 10, 10);
+	run_loop(40, 10, 10);
+	const loop_prof_stat_t* s = loopProfStat(0);
+	TEST_ASSERT(s->count < UINT16_MAX);
+	TEST_ASSERT_EQUAL_UINT16(10, loopProfMean(s));
+	TEST_ASSERT_EQUAL_UINT16(40, s->max);
+}
@@ -0,0 +1,197 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "support_test.h"
+#include "modbus.h"
+#include "modbus_rbe.h"
+#include "buffer.h"
+#include "utils.h"
+TT_END_INCLUDE()
+
+/* The slave builds a response & sends it with the MODBUS driver, which is captured then looped back to the driver, which receives it as the
+	master & hands it to the callback, where it is parsed. */
+static const uint16_t DEADBANDS[] = { 2, 0, UINT16_MAX };		// Like a tilt sensor: tilt, status & sample count.
+enum { COUNT = UTILS_ELEMENT_COUNT(DEADBANDS), MAX_SILENCE_MS = 500 };
+
+static struct {
+	modbus_rbe_t rbe;
+	BufferDynamic request, response;
+	uint8_t wire[40];					// Bytes sent by the driver.
+	uint8_t wire_len, wire_idx;
+	uint8_t cb_event;
+	bool parsed;
+	uint16_t values[COUNT];				// Values at master.
+	uint16_t mask;
+} f_fixture;
+
+static void modbus_send(const uint8_t* buf, uint8_t sz) {
+	TEST_ASSERT_LESS_OR_EQUAL(sizeof(f_fixture.wire), f_fixture.wire_len + sz);
+	memcpy(&f_fixture.wire[f_fixture.wire_len], buf, sz);
+	f_fixture.wire_len += sz;
+}
+static int16_t modbus_recv() {
+	return (f_fixture.wire_idx < f_fixture.wire_len) ? f_fixture.wire[f_fixture.wire_idx++] : -1;
+}
+static void modbus_callback(uint8_t evt) {
+	f_fixture.cb_event = evt;
+	if (MODBUS_CB_EVT_M_RESP_RX == evt)
+		f_fixture.parsed = modbusRbeParseResponse(modbusRxFrame(), COUNT, f_fixture.values, &f_fixture.mask);
+}
+
+void testModbusRbeSetup() {
+	support_test_set_millis();
+	modbusInit(modbus_send, modbus_recv, 40, 19200, modbus_callback);
+	modbusRbeInit(&f_fixture.rbe);
+	f_fixture.request.resize(10);
+	f_fixture.request.clear();
+	f_fixture.request.addHexStr("0103006e0003");		// Read 3 regs at 110 from slave 1.
+	f_fixture.response.resize(20);
+	memset(f_fixture.values, 0xee, sizeof(f_fixture.values));
+}
+TT_BEGIN_FIXTURE(testModbusRbeSetup, NULL, NULL);
+
+// Slave responds to a poll with the given values, which is then received by the master. Returns the length of the response on the wire.
+static uint8_t poll(uint16_t v0, uint16_t v1, uint16_t v2) {
+	const uint16_t values[COUNT] = { v0, v1, v2 };
+	const uint16_t mask = modbusRbeChanges(&f_fixture.rbe, values, DEADBANDS, COUNT, MAX_SILENCE_MS);
+	TEST_ASSERT_TRUE(modbusRbeBuildResponse(&f_fixture.rbe, f_fixture.response, f_fixture.request, values, COUNT, mask));
+
+	f_fixture.wire_len = f_fixture.wire_idx = 0U;
+	f_fixture.cb_event = MODBUS_CB_EVT_NONE;
+	f_fixture.parsed = false;
+	modbusSend(f_fixture.response);
+	for (uint16_t t = 0; t < 1000; t += 1) {		// Run driver for 10ms.
+		modbusService();
+		support_test_add_micros(10U);
+	}
+	TEST_ASSERT_EQUAL_UINT8(MODBUS_CB_EVT_M_RESP_RX, f_fixture.cb_event);
+	TEST_ASSERT_TRUE(f_fixture.parsed);
+	TEST_ASSERT_EQUAL_HEX16(mask, f_fixture.mask);
+	return f_fixture.wire_len;
+}
+static void assert_values(uint16_t v0, uint16_t v1, uint16_t v2) {
+	TEST_ASSERT_EQUAL_HEX16(v0, f_fixture.values[0]);
+	TEST_ASSERT_EQUAL_HEX16(v1, f_fixture.values[1]);
+	TEST_ASSERT_EQUAL_HEX16(v2, f_fixture.values[2]);
+}
+
+// First response has all registers.
+void testModbusRbeFirst() {
+	TEST_ASSERT_EQUAL_UINT8(5 + 2 + 6, poll(100, 101, 102));
+	TEST_ASSERT_EQUAL_HEX16(0x7, f_fixture.mask);
+	assert_values(100, 101, 102);
+	static const uint8_t EXP[] = { 0x01, 0x03, 0x08, 0x00, 0x07, 0x00, 100, 0x00, 101, 0x00, 102 };
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(EXP, f_fixture.wire, sizeof(EXP));
+}
+
+// No change gives the shortest response, which leaves the master values alone.
+void testModbusRbeNoChange() {
+	poll(100, 101, 102);
+	TEST_ASSERT_EQUAL_UINT8(5 + 2, poll(100, 101, 999));		// Register with max deadband never reported as changed.
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+	assert_values(100, 101, 102);
+}
+
+// Changes within the deadband are not reported, the deadband is from the last reported value, so slow drift is reported eventually.
+void testModbusRbeDeadband() {
+	poll(100, 101, 102);
+	poll(102, 101, 102);
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+	poll(98, 101, 102);
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+	TEST_ASSERT_EQUAL_UINT8(5 + 2 + 2, poll(103, 101, 102));
+	TEST_ASSERT_EQUAL_HEX16(0x1, f_fixture.mask);
+	assert_values(103, 101, 102);
+	poll(101, 101, 102);
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+	poll(100, 101, 102);
+	TEST_ASSERT_EQUAL_HEX16(0x1, f_fixture.mask);
+	assert_values(100, 101, 102);
+}
+
+// Signed values work across zero, and a zero deadband reports any change.
+void testModbusRbeSigned() {
+	poll(1, 101, 102);
+	poll((uint16_t)-2, 100, 102);
+	TEST_ASSERT_EQUAL_HEX16(0x3, f_fixture.mask);
+	assert_values((uint16_t)-2, 100, 102);
+	poll(0x7fff, 100, 102);
+	TEST_ASSERT_EQUAL_HEX16(0x1, f_fixture.mask);
+	poll(0x8000, 100, 102);					// Signed difference wraps to a small change.
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+}
+
+// All registers are reported after the silence interval, even with no change.
+void testModbusRbeMaxSilence() {
+	poll(100, 101, 102);
+	support_test_set_millis(MAX_SILENCE_MS - 10U);		// Each poll takes 10ms.
+	poll(100, 101, 555);
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+	poll(100, 101, 555);
+	TEST_ASSERT_EQUAL_HEX16(0x7, f_fixture.mask);
+	assert_values(100, 101, 555);
+	poll(100, 101, 555);
+	TEST_ASSERT_EQUAL_HEX16(0, f_fixture.mask);
+}
+
+// Zero silence interval reports all registers every time, so it is just a normal read with a mask.
+void testModbusRbeZeroSilence() {
+	const uint16_t values[COUNT] = { 1, 2, 3 };
+	modbusRbeBuildResponse(&f_fixture.rbe, f_fixture.response, f_fixture.request, values, COUNT, 0x7);
+	TEST_ASSERT_EQUAL_HEX16(0x7, modbusRbeChanges(&f_fixture.rbe, values, DEADBANDS, COUNT, 0));
+}
+
+// Init forces a full report.
+void testModbusRbeReinit() {
+	poll(100, 101, 102);
+	modbusRbeInit(&f_fixture.rbe);
+	poll(100, 101, 102);
+	TEST_ASSERT_EQUAL_HEX16(0x7, f_fixture.mask);
+}
+
+// Mask bits above the count are ignored by the slave.
+void testModbusRbeBuildMask() {
+	const uint16_t values[COUNT] = { 1, 2, 3 };
+	TEST_ASSERT_TRUE(modbusRbeBuildResponse(&f_fixture.rbe, f_fixture.response, f_fixture.request, values, COUNT, 0xfffa));
+	TEST_ASSERT_EQUAL_UINT8(3 + 2 + 2, f_fixture.response.len());
+	TEST_ASSERT_EQUAL_HEX16(0x2, f_fixture.response.getU16_be(MODBUS_FRAME_IDX_DATA + 1));
+}
+
+// No room for the CRC.
+void testModbusRbeBuildOverflow() {
+	const uint16_t values[COUNT] = { 1, 2, 3 };
+	f_fixture.response.resize(12);
+	TEST_ASSERT_FALSE(modbusRbeBuildResponse(&f_fixture.rbe, f_fixture.response, f_fixture.request, values, COUNT, 0x7));
+	f_fixture.response.resize(13);
+	TEST_ASSERT_TRUE(modbusRbeBuildResponse(&f_fixture.rbe, f_fixture.response, f_fixture.request, values, COUNT, 0x7));
+}
+
+// Master rejects bad responses, frames include the CRC, which is not checked.
+void testModbusRbeParseBad(const char* frame) {
+	BufferDynamic resp(20);
+	resp.addHexStr(frame);
+	uint16_t mask = 0xeeee;
+	TEST_ASSERT_FALSE(modbusRbeParseResponse(resp, COUNT, f_fixture.values, &mask));
+	TEST_ASSERT_EQUAL_HEX16(0xeeee, mask);
+	assert_values(0xeeee, 0xeeee, 0xeeee);
+}
+TT_TEST_CASE(testModbusRbeParseBad("010302000000"));				// Too short.
+TT_TEST_CASE(testModbusRbeParseBad("01830200000000"));				// Exception.
+TT_TEST_CASE(testModbusRbeParseBad("01030600010064ffff"));			// Byte count does not match length.
+TT_TEST_CASE(testModbusRbeParseBad("01030400030064ffff"));			// Byte count does not match mask.
+TT_TEST_CASE(testModbusRbeParseBad("010304000800640000"));			// Mask has bit outside count.
+TT_TEST_CASE(testModbusRbeParseBad("0103020000"));					// Too short.
+
+void testModbusRbeParseGood() {
+	BufferDynamic resp(20);
+	resp.addHexStr("0103060005000a000cffff");
+	uint16_t mask;
+	TEST_ASSERT_TRUE(modbusRbeParseResponse(resp, COUNT, f_fixture.values, &mask));
+	TEST_ASSERT_EQUAL_HEX16(0x5, mask);
+	assert_values(0x000a, 0xeeee, 0x000c);
+}
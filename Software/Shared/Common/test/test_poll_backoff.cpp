@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+#include "poll_backoff.h"
+TT_END_INCLUDE()
+
+static constexpr uint8_t THRESHOLD = 3;
+static poll_backoff_t f_b;
+
+void testPollBackoffSetup() {
+	memset(&f_b, 0xff, sizeof(f_b));
+	pollBackoffInit(&f_b);
+}
+TT_BEGIN_FIXTURE(testPollBackoffSetup, NULL, NULL);
+
+/* Run a pass for a device that never responds, polling it if it is not backed off or is due. Returns true if polled. Note that the caller only
+	asks a backed off device if it is due. */
+static bool pass(uint8_t backoff_max) {
+	if (pollBackoffIsBackedOff(&f_b, THRESHOLD) && !pollBackoffIsDue(&f_b))
+		return false;
+	pollBackoffSent(&f_b, THRESHOLD, backoff_max);
+	return true;
+}
+
+// Run passes and return a bitmask of the passes that polled, bit 0 is the first.
+static uint32_t passes(uint8_t n, uint8_t backoff_max) {
+	uint32_t polled = 0U;
+	fori (n) {
+		if (pass(backoff_max))
+			polled |= (uint32_t)1U << i;
+	}
+	return polled;
+}
+
+void testPollBackoffInit() {
+	TEST_ASSERT_EQUAL_UINT8(0, f_b.misses);
+	TEST_ASSERT_FALSE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+	TEST_ASSERT_FALSE(pollBackoffIsBackedOff(&f_b, 0));
+	TEST_ASSERT_TRUE(pollBackoffIsDue(&f_b));
+}
+
+// Misses up to the threshold are allowed, one more backs off the device, which is how the caller flags it faulty.
+void testPollBackoffThreshold() {
+	fori (THRESHOLD) {
+		pollBackoffSent(&f_b, THRESHOLD, POLL_BACKOFF_MAX);
+		TEST_ASSERT_FALSE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+		TEST_ASSERT_TRUE(pollBackoffIsDue(&f_b));		// Wait not changed until backed off.
+	}
+	pollBackoffSent(&f_b, THRESHOLD, POLL_BACKOFF_MAX);
+	TEST_ASSERT_TRUE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+	TEST_ASSERT_EQUAL_UINT8(THRESHOLD + 1, f_b.misses);
+}
+
+// A response before the threshold resets the count, so misses must be in a row.
+void testPollBackoffResponseBeforeThreshold() {
+	fori (THRESHOLD)
+		pollBackoffSent(&f_b, THRESHOLD, POLL_BACKOFF_MAX);
+	TEST_ASSERT_FALSE(pollBackoffResponse(&f_b, THRESHOLD));
+	fori (THRESHOLD)
+		pollBackoffSent(&f_b, THRESHOLD, POLL_BACKOFF_MAX);
+	TEST_ASSERT_FALSE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+}
+
+// After backing off polls are sent after 1, 1, 2, 4, 8 passes.
+void testPollBackoffExponential() {
+	TEST_ASSERT_EQUAL_HEX32(0x0f, passes(THRESHOLD + 1, POLL_BACKOFF_MAX));
+	TEST_ASSERT_EQUAL_HEX32(0x808b, passes(16, POLL_BACKOFF_MAX));
+}
+
+// The gap between polls is limited to 2^backoff_max passes.
+void testPollBackoffLimit() {
+	passes(THRESHOLD + 1, 2);
+	TEST_ASSERT_EQUAL_HEX32(0x8888b, passes(20, 2));
+	TEST_ASSERT_EQUAL_UINT8(2, f_b.backoff);
+}
+
+// The limit is itself limited so that the wait fits in a byte.
+void testPollBackoffLimitMax() {
+	passes(THRESHOLD + 1, 255);
+	uint16_t gap = 0, polls = 0;
+	for (uint16_t i = 0; i < 1000; i += 1) {
+		if (pass(255)) {
+			gap = 0;
+			polls += 1;
+		}
+		else {
+			gap += 1;
+			TEST_ASSERT_LESS_THAN_UINT16(1U << POLL_BACKOFF_MAX, gap);
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT8(POLL_BACKOFF_MAX, f_b.backoff);
+	TEST_ASSERT_EQUAL_UINT16(14, polls);		// Gaps of 1, 1, 2, 4, ..., 64 passes to pass 127, then 128 passes.
+}
+
+// The miss count saturates so a device never stops being backed off until it responds.
+void testPollBackoffMissesSaturate() {
+	for (uint16_t i = 0; i < 300; i += 1)
+		pollBackoffSent(&f_b, THRESHOLD, POLL_BACKOFF_MAX);
+	TEST_ASSERT_EQUAL_UINT8(UINT8_MAX, f_b.misses);
+	TEST_ASSERT_TRUE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+}
+
+// A zero limit polls a backed off device on every pass.
+void testPollBackoffLimitZero() {
+	passes(THRESHOLD + 1, 0);
+	TEST_ASSERT_EQUAL_HEX32(0xff, passes(8, 0));
+}
+
+// First response goes back to full rate and clears the fault.
+void testPollBackoffRecover() {
+	passes(THRESHOLD + 1 + 8, POLL_BACKOFF_MAX);
+	TEST_ASSERT_TRUE(pollBackoffResponse(&f_b, THRESHOLD));
+	TEST_ASSERT_FALSE(pollBackoffIsBackedOff(&f_b, THRESHOLD));
+	TEST_ASSERT_EQUAL_HEX32(0x0f, passes(THRESHOLD + 1, POLL_BACKOFF_MAX));	// Polled on every pass until it backs off again.
+	TEST_ASSERT_FALSE(pollBackoffResponse(&f_b, 255));		// Threshold is an argument so may change.
+}
+
+// A device that stays due when not picked by the caller is picked on a later pass.
+void testPollBackoffStaysDue() {
+	passes(THRESHOLD + 1 + 2, POLL_BACKOFF_MAX);		// Wait is now 1.
+	TEST_ASSERT_FALSE(pollBackoffIsDue(&f_b));
+	TEST_ASSERT_TRUE(pollBackoffIsDue(&f_b));
+	TEST_ASSERT_TRUE(pollBackoffIsDue(&f_b));
+	TEST_ASSERT_TRUE(pollBackoffIsDue(&f_b));
+}
@@ -2,6 +2,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 #include "unity.h"
 
@@ -224,3 +225,72 @@ TT_ENDIF()
 // Assumes a long is at least 32 bits.
 TT_TEST_CASE(test_printf_format("!12345678!f00f!", "!%lx!%x!", (CFG_MYPRINTF_T_L_UINT)0x12345678, 0xf00f));
 
+
+// The fast integer paths must give the same result as the C library. Format with myprintf using fmt, and with snprintf using libc_fmt and the
+//  value cast to a long long.
+static void check_libc(const char* fmt, const char* libc_fmt, long long x) {
+	char expected[40], outp[40];
+	snprintf(expected, sizeof(expected), libc_fmt, x);
+	if (strstr(fmt, "l"))
+		myprintf_snprintf(outp, sizeof(outp), fmt, (CFG_MYPRINTF_T_L_UINT)x);
+	else
+		myprintf_snprintf(outp, sizeof(outp), fmt, (unsigned)(CFG_MYPRINTF_T_UINT)x);
+	TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, outp, fmt);
+}
+
+void testPrintfFastIntAll() {
+	for (long long x = 0; x <= 0xffff; x += 1) {
+		check_libc("%u", "%llu", x);
+		check_libc("%x", "%llx", x);
+		check_libc("%d", "%lld", (int16_t)x);
+	}
+}
+
+// Powers of 10 & 16 either side of each boundary, then pseudo random values.
+void testPrintfFastLong() {
+	for (long long p = 1; ; p *= 10) {
+		for (long long x = p - 1; x <= p + 1; x += 1) {
+			check_libc("%lu", "%llu", x);
+			check_libc("%ld", "%lld", x);
+			check_libc("%ld", "%lld", -x);
+		}
+		if (p > (long long)MAX_PRINTF_IL / 10)
+			break;
+	}
+	for (long long p = 1; ; p *= 16) {
+		for (long long x = p - 1; x <= p + 1; x += 1) {
+			check_libc("%lx", "%llx", x);
+			check_libc("%lX", "%llX", x);
+		}
+		if (p > (long long)MAX_PRINTF_IL / 16)
+			break;
+	}
+	uint32_t r = 1;
+	for (uint32_t i = 0; i < 100000U; i += 1) {
+		r = r * 1664525U + 1013904223U;
+		check_libc("%lu", "%llu", (long long)(CFG_MYPRINTF_T_L_UINT)r);
+		check_libc("%ld", "%lld", (long long)(CFG_MYPRINTF_T_L_INT)r);
+		check_libc("%lx", "%llx", (long long)(CFG_MYPRINTF_T_L_UINT)r);
+	}
+}
+
+// Width & padding is done without scanning the number, check all widths that matter.
+void testPrintfFastWidth() {
+	static const long long VALUES[] = { 0, 7, -7, 1234, -1234, 12345, -32768, 32767 };
+	static const char* const FLAGS[] = { "", "0", "-", "+", "+0" };
+	for (size_t i = 0; i < sizeof(FLAGS) / sizeof(FLAGS[0]); i += 1) {
+		for (unsigned width = 0; width <= 8; width += 1) {
+			char fmt[12], libc_fmt[12];
+			for (size_t k = 0; k < sizeof(VALUES) / sizeof(VALUES[0]); k += 1) {
+				snprintf(fmt, sizeof(fmt), "%%%s%ud", FLAGS[i], width);
+				snprintf(libc_fmt, sizeof(libc_fmt), "%%%s%ulld", FLAGS[i], width);
+				check_libc(fmt, libc_fmt, VALUES[k]);
+				if ('+' != FLAGS[i][0]) {
+					snprintf(fmt, sizeof(fmt), "%%%s%ux", FLAGS[i], width);
+					snprintf(libc_fmt, sizeof(libc_fmt), "%%%s%ullx", FLAGS[i], width);
+					check_libc(fmt, libc_fmt, (CFG_MYPRINTF_T_UINT)VALUES[k]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+#include "regs.h"
+TT_END_INCLUDE()
+
+#include "modbus.h"
+
+// Registers are usually defined in the driver.
+static uint16_t f_regs[COUNT_REGS];
+uint16_t* regsGetRegs() { return f_regs; }
+
+void testRegsSetup() {
+	fori (COUNT_REGS)
+		REGS[i] = (regs_t)(0x1100 * i + 1);
+	regsChangeReset();
+}
+TT_BEGIN_FIXTURE(testRegsSetup, NULL, NULL);
+
+// Change notification.
+static uint8_t f_cb_count, f_cb_idx;
+static regs_t f_cb_val;
+static void change_cb(uint8_t idx, regs_t v) { f_cb_count += 1; f_cb_idx = idx; f_cb_val = v; }
+
+void testRegsChangeNoneDirty() {
+	fori (COUNT_REGS)
+		TEST_ASSERT_FALSE(regsChangeTestAndClear(i));
+}
+void testRegsChangeDirtyOnChangeOnly() {
+	TEST_ASSERT_FALSE(regsWriteMask(REGS_IDX_FLAGS, 1, true));		// Bit 0 already set.
+	TEST_ASSERT_FALSE(regsChangeTestAndClear(REGS_IDX_FLAGS));
+	TEST_ASSERT(regsWriteMask(REGS_IDX_FLAGS, 1, false));
+	TEST_ASSERT(regsChangeTestAndClear(REGS_IDX_FLAGS));
+	TEST_ASSERT_FALSE(regsChangeTestAndClear(REGS_IDX_FLAGS));		// Cleared by read.
+	fori (COUNT_REGS)
+		TEST_ASSERT_FALSE(regsChangeTestAndClear(i));				// Others not affected.
+}
+void testRegsChangeDirtyUpdateMaskAndWrite() {
+	TEST_ASSERT(regsUpdateMask(REGS_IDX_SETTING, 0xff, 0x55));
+	TEST_ASSERT_FALSE(regsWrite(REGS_IDX_VALUE_7, REGS[REGS_IDX_VALUE_7]));
+	TEST_ASSERT(regsWrite(REGS_IDX_VALUE_0, 0));
+	TEST_ASSERT(regsChangeTestAndClear(REGS_IDX_SETTING));
+	TEST_ASSERT(regsChangeTestAndClear(REGS_IDX_VALUE_0));
+	TEST_ASSERT_FALSE(regsChangeTestAndClear(REGS_IDX_VALUE_7));
+	TEST_ASSERT_EQUAL_HEX16(0, REGS[REGS_IDX_VALUE_0]);
+}
+void testRegsChangeDirectWriteNotSeen() {
+	REGS[REGS_IDX_VALUE_0] = 1234;
+	TEST_ASSERT_FALSE(regsChangeTestAndClear(REGS_IDX_VALUE_0));
+}
+void testRegsChangeCallbackSubscribedOnly() {
+	f_cb_count = 0;
+	regsChangeSetCallback(change_cb);
+	regsChangeSubscribe(REGS_IDX_SETTING, true);
+	regsWriteMask(REGS_IDX_FLAGS, 0x100, true);						// Not subscribed.
+	TEST_ASSERT_EQUAL_UINT8(0, f_cb_count);
+	regsWriteMask(REGS_IDX_SETTING, 0x4000, true);
+	TEST_ASSERT_EQUAL_UINT8(1, f_cb_count);
+	TEST_ASSERT_EQUAL_UINT8(REGS_IDX_SETTING, f_cb_idx);
+	TEST_ASSERT_EQUAL_HEX16(REGS[REGS_IDX_SETTING], f_cb_val);
+	regsWriteMask(REGS_IDX_SETTING, 0x4000, true);						// No change.
+	TEST_ASSERT_EQUAL_UINT8(1, f_cb_count);
+	regsChangeSubscribe(REGS_IDX_SETTING, false);
+	regsWriteMask(REGS_IDX_SETTING, 0x4000, false);
+	TEST_ASSERT_EQUAL_UINT8(1, f_cb_count);
+	TEST_ASSERT(regsChangeTestAndClear(REGS_IDX_SETTING));				// Dirty bits still set when unsubscribed.
+}
+void testRegsChangeSubscribedNoCallback() {
+	regsChangeSubscribe(REGS_IDX_FLAGS, true);
+	TEST_ASSERT(regsWriteMaskFlags(0x100, true));
+	TEST_ASSERT(regsChangeTestAndClear(REGS_IDX_FLAGS));
+}
+
+// Binary stream.
+void testRegsStreamPacket() {
+	const uint8_t mask[REGS_STREAM_MASK_SIZE] = { 0x05, 0x04 };		// Registers 0, 2 & 10.
+	uint8_t buf[REGS_STREAM_PACKET_SIZE_MAX + 1];
+	memset(buf, 0xee, sizeof(buf));
+
+	const uint8_t n = regsStreamMakePacket(buf, mask, 0x42, 0x12345678UL);
+	TEST_ASSERT_EQUAL_UINT8(2 + 1 + 1 + 4 + 1 + 2 + 3 * 2 + 2, n);
+	const uint8_t expected[] = {
+		REGS_STREAM_SYNC_0, REGS_STREAM_SYNC_1, 1 + 4 + 1 + 2 + 3 * 2,
+		0x42, 0x78, 0x56, 0x34, 0x12,				// Seq, timestamp.
+		2, 0x05, 0x04,								// Mask.
+		0x01, 0x00, 0x01, 0x22, 0x01, 0xaa,			// Values.
+	};
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, sizeof(expected));
+	const uint16_t crc = modbusCrc(&buf[2], sizeof(expected) - 2);
+	TEST_ASSERT_EQUAL_HEX8((uint8_t)crc, buf[n - 2]);
+	TEST_ASSERT_EQUAL_HEX8((uint8_t)(crc >> 8), buf[n - 1]);
+	TEST_ASSERT_EQUAL_HEX8(0xee, buf[n]);		// No overrun.
+}
+void testRegsStreamPacketEmpty() {
+	const uint8_t mask[REGS_STREAM_MASK_SIZE] = { 0 };
+	uint8_t buf[REGS_STREAM_PACKET_SIZE_MAX];
+	TEST_ASSERT_EQUAL_UINT8(2 + 1 + 1 + 4 + 1 + 2 + 2, regsStreamMakePacket(buf, mask, 0, 0));
+}
+void testRegsStreamPacketAll() {
+	const uint8_t mask[REGS_STREAM_MASK_SIZE] = { 0xff, 0x07 };
+	uint8_t buf[REGS_STREAM_PACKET_SIZE_MAX];
+	TEST_ASSERT_EQUAL_UINT8(REGS_STREAM_PACKET_SIZE_MAX, regsStreamMakePacket(buf, mask, 0, 0));
+}
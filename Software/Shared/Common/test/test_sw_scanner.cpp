@@ -0,0 +1,169 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+#include "event.h"
+#include "regs.h"
+#include "sw_scanner.h"
+TT_END_INCLUDE()
+
+// Two switches on port 0, one active low, and one on port 1.
+enum { PIN_A = 3, PIN_B = 4, PIN_C = 9 };
+enum { FLAG_A = 0x100, FLAG_B = 0x200, FLAG_C = 0x400 };
+static uint8_t action_delay_2() { return 2; }
+static const sw_scan_def_t SW_DEFS[] PROGMEM = {
+	{ PIN_A, true, NULL, FLAG_A, EV_SAMPLE_1 },
+	{ PIN_B, false, action_delay_2, FLAG_B, EV_SAMPLE_2 },
+	{ PIN_C, false, NULL, FLAG_C, EV_DEBUG },
+};
+static sw_scan_context_t f_contexts[UTILS_ELEMENT_COUNT(SW_DEFS)];
+static sw_scan_ports_t f_ports;
+
+static void set_pin(uint8_t pin, bool high) {
+	if (high)
+		g_test_ports[digitalPinToPort(pin)] |= digitalPinToBitMask(pin);
+	else
+		g_test_ports[digitalPinToPort(pin)] &= (uint8_t)~digitalPinToBitMask(pin);
+}
+static void scan(uint8_t n=1) {
+	fori (n)
+		swScanSamplePorts(SW_DEFS, f_contexts, UTILS_ELEMENT_COUNT(SW_DEFS), &f_ports);
+}
+static void assert_event(uint8_t id, uint8_t p8) {
+	const t_event ev = eventGet();
+	TEST_ASSERT_EQUAL_HEX8(id, event_id(ev));
+	TEST_ASSERT_EQUAL_HEX8(p8, event_p8(ev));
+}
+static void assert_no_event() { TEST_ASSERT_EQUAL_HEX8(EV_NIL, event_id(eventGet())); }
+
+void testSwScannerSetup() {
+	regsFlags() = 0;
+	memset((void*)g_test_ports, 0, sizeof(g_test_ports));
+	set_pin(PIN_A, true);		// Active low so inactive.
+	eventInit();
+	swScanInitPorts(SW_DEFS, f_contexts, UTILS_ELEMENT_COUNT(SW_DEFS), &f_ports);
+}
+TT_BEGIN_FIXTURE(testSwScannerSetup, NULL, NULL);
+
+// Vertical counter on its own.
+void testSwScannerDebounce() {
+	sw_scan_port_t p = { NULL, 0xff, 0, 0xff, 0xff, 0 };
+	TEST_ASSERT_EQUAL_HEX8(0x00, swScanDebounce(&p, 0x03));
+	TEST_ASSERT_EQUAL_HEX8(0x00, swScanDebounce(&p, 0x03));
+	TEST_ASSERT_EQUAL_HEX8(0x00, swScanDebounce(&p, 0x01));		// Bit 1 glitch, resets count.
+	TEST_ASSERT_EQUAL_HEX8(0x01, swScanDebounce(&p, 0x03));		// Bit 0 changes after 4 samples.
+	TEST_ASSERT_EQUAL_HEX8(0x01, swScanDebounce(&p, 0x03));
+	TEST_ASSERT_EQUAL_HEX8(0x01, swScanDebounce(&p, 0x03));
+	TEST_ASSERT_EQUAL_HEX8(0x03, swScanDebounce(&p, 0x03));		// Bit 1 changes 4 samples after glitch.
+	TEST_ASSERT_EQUAL_HEX8(0x03, swScanDebounce(&p, 0x00));
+	TEST_ASSERT_EQUAL_HEX8(0x03, swScanDebounce(&p, 0x00));
+	TEST_ASSERT_EQUAL_HEX8(0x03, swScanDebounce(&p, 0x00));
+	TEST_ASSERT_EQUAL_HEX8(0x00, swScanDebounce(&p, 0x00));
+}
+
+void testSwScannerGroupsPorts() {
+	TEST_ASSERT_EQUAL_UINT8(2, f_ports.port_count);
+	TEST_ASSERT_EQUAL_HEX8(0x18, f_ports.ports[0].mask);
+	TEST_ASSERT_EQUAL_HEX8(0x08, f_ports.ports[0].invert);
+	TEST_ASSERT_EQUAL_HEX8(0x02, f_ports.ports[1].mask);
+	TEST_ASSERT_EQUAL_HEX8(0x00, f_ports.ports[1].invert);
+	assert_no_event();
+	scan(10);
+	assert_no_event();
+	TEST_ASSERT_EQUAL_HEX16(0, regsFlags());
+}
+
+void testSwScannerStartup() {
+	set_pin(PIN_C, true);
+	swScanInitPorts(SW_DEFS, f_contexts, UTILS_ELEMENT_COUNT(SW_DEFS), &f_ports);
+	assert_event(EV_DEBUG, EV_P8_SW_STARTUP);
+	scan();														// No debounce delay for a switch active at startup.
+	assert_event(EV_DEBUG, EV_P8_SW_CLICK);
+	TEST_ASSERT_EQUAL_HEX16(FLAG_C, regsFlags());
+}
+
+void testSwScannerClickRelease() {
+	set_pin(PIN_A, false);
+	scan(3);
+	assert_no_event();
+	scan();
+	assert_event(EV_SAMPLE_1, EV_P8_SW_CLICK);
+	TEST_ASSERT_EQUAL_HEX16(FLAG_A, regsFlags());
+	set_pin(PIN_A, true);
+	scan(3);
+	assert_no_event();
+	scan();
+	assert_event(EV_SAMPLE_1, EV_P8_SW_RELEASE);
+	assert_no_event();
+	TEST_ASSERT_EQUAL_HEX16(0, regsFlags());
+}
+
+void testSwScannerGlitchIgnored() {
+	fori (10) {
+		set_pin(PIN_B, true);
+		scan(3);
+		set_pin(PIN_B, false);
+		scan();
+	}
+	assert_no_event();
+	TEST_ASSERT_EQUAL_HEX16(0, regsFlags());
+}
+
+void testSwScannerActionDelay() {
+	set_pin(PIN_B, true);
+	scan(4 + 1);												// Action delay starts counting on the scan that sees the debounced switch.
+	assert_no_event();
+	scan();
+	assert_event(EV_SAMPLE_2, EV_P8_SW_CLICK);
+	TEST_ASSERT_EQUAL_HEX16(FLAG_B, regsFlags());
+}
+
+void testSwScannerHoldRepeatLongHold() {
+	set_pin(PIN_C, true);
+	scan(4);
+	assert_event(EV_DEBUG, EV_P8_SW_CLICK);
+	scan(SW_HOLD_TIME);
+	assert_no_event();
+	scan();
+	assert_event(EV_DEBUG, EV_P8_SW_HOLD);
+	scan();														// Repeat timer was decremented on the hold scan.
+	assert_event(EV_DEBUG, EV_P8_SW_REPEAT);
+	fori (3) {
+		scan(SW_REPEAT_DELAY - 1);
+		assert_no_event();
+		scan();
+		assert_event(EV_DEBUG, EV_P8_SW_REPEAT);
+	}
+	scan(SW_LONG_HOLD_TIME - SW_HOLD_TIME - 3 * SW_REPEAT_DELAY);		// Past long hold.
+	uint8_t long_holds = 0;
+	for (t_event ev; EV_NIL != event_id(ev = eventGet()); ) {
+		TEST_ASSERT_EQUAL_HEX8(EV_DEBUG, event_id(ev));
+		if (EV_P8_SW_LONG_HOLD == event_p8(ev))
+			long_holds += 1;
+		else
+			TEST_ASSERT_EQUAL_HEX8(EV_P8_SW_REPEAT, event_p8(ev));
+	}
+	TEST_ASSERT_EQUAL_UINT8(1, long_holds);
+	TEST_ASSERT_EQUAL_HEX16(FLAG_C, regsFlags());
+}
+
+// Switches on different ports are independent.
+void testSwScannerMultiple() {
+	set_pin(PIN_A, false);
+	set_pin(PIN_C, true);
+	scan(4);
+	assert_event(EV_SAMPLE_1, EV_P8_SW_CLICK);
+	assert_event(EV_DEBUG, EV_P8_SW_CLICK);
+	TEST_ASSERT_EQUAL_HEX16(FLAG_A | FLAG_C, regsFlags());
+	set_pin(PIN_A, true);
+	scan(4);
+	assert_event(EV_SAMPLE_1, EV_P8_SW_RELEASE);
+	assert_no_event();
+	TEST_ASSERT_EQUAL_HEX16(FLAG_C, regsFlags());
+}
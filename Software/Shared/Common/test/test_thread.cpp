@@ -0,0 +1,214 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "project_config.h"
+#include "utils.h"
+#include "thread.h"
+TT_END_INCLUDE()
+
+static thread_ticks_t f_ticks;
+thread_ticks_t threadGetTicks() { return f_ticks; }
+
+// Each test thread has its own data passed as the arg, as all threads of a type share the same function.
+typedef struct {
+	uint8_t id;
+	thread_ticks_t period;
+	uint16_t runs;			// Count of times thread function called.
+	uint16_t loops;			// Count of times thread did something.
+	bool flag;
+} thread_data_t;
+
+static char f_log[40];
+static void log_id(uint8_t id) {
+	const size_t len = strlen(f_log);
+	if (len < sizeof(f_log) - 1)
+		f_log[len] = (char)('0' + id);
+}
+
+static int8_t thread_sleeper(void* arg) {
+	thread_data_t* d = (thread_data_t*)arg;
+	d->runs += 1;
+	THREAD_BEGIN();
+	while (1) {
+		d->loops += 1;
+		log_id(d->id);
+		THREAD_SLEEP(d->period);
+	}
+	THREAD_END();
+}
+
+static int8_t thread_blocker(void* arg) {
+	thread_data_t* d = (thread_data_t*)arg;
+	d->runs += 1;
+	THREAD_BEGIN();
+	while (1) {
+		THREAD_BLOCK_UNTIL(d->flag);
+		d->flag = false;
+		d->loops += 1;
+	}
+	THREAD_END();
+}
+
+static int8_t thread_yielder(void* arg) {
+	thread_data_t* d = (thread_data_t*)arg;
+	d->runs += 1;
+	THREAD_BEGIN();
+	while (1) {
+		d->loops += 1;
+		THREAD_YIELD();
+	}
+	THREAD_END();
+}
+
+static int8_t thread_exiter(void* arg) {
+	thread_data_t* d = (thread_data_t*)arg;
+	d->runs += 1;
+	THREAD_BEGIN();
+	THREAD_SLEEP(d->period);
+	THREAD_EXIT(3);
+	THREAD_END();
+}
+
+// Waits for an event with a timeout, flag is set if the delay was done, clear if woken early.
+static int8_t thread_timeout(void* arg) {
+	thread_data_t* d = (thread_data_t*)arg;
+	d->runs += 1;
+	THREAD_BEGIN();
+	while (1) {
+		THREAD_START_DELAY();
+		THREAD_SLEEP_UNTIL_DELAY_DONE(d->period);
+		d->flag = THREAD_IS_DELAY_DONE(d->period);
+		d->loops += 1;
+	}
+	THREAD_END();
+}
+
+static thread_sched_tcb_t f_tcbs[32];
+static thread_data_t f_data[32];
+
+void testThreadSchedSetup() {
+	f_ticks = 0;
+	memset(f_log, 0, sizeof(f_log));
+	memset(f_data, 0, sizeof(f_data));
+	fori (UTILS_ELEMENT_COUNT(f_data))
+		f_data[i].id = i;
+	threadSchedInit();
+}
+TT_BEGIN_FIXTURE(testThreadSchedSetup, NULL, NULL);
+
+static void run_ticks(thread_ticks_t ticks) {
+	while (ticks-- > 0) {
+		threadSchedService();
+		f_ticks += 1;
+	}
+}
+
+void testThreadSchedEmpty() {
+	TEST_ASSERT_EQUAL_UINT8(0, threadSchedService());
+}
+
+void testThreadSchedSleep() {
+	f_data[0].period = 10;
+	threadSchedAdd(&f_tcbs[0], thread_sleeper, &f_data[0]);
+	TEST_ASSERT_EQUAL_UINT8(1, threadSchedService());
+	TEST_ASSERT_EQUAL_UINT8(THREAD_SCHED_STATE_SLEEPING, f_tcbs[0].state);
+	f_ticks = 9;
+	TEST_ASSERT_EQUAL_UINT8(0, threadSchedService());
+	f_ticks = 10;
+	TEST_ASSERT_EQUAL_UINT8(1, threadSchedService());
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].runs);
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].loops);
+}
+
+void testThreadSchedWakeOrder() {
+	static const thread_ticks_t PERIODS[] = { 7, 3, 5, 3 };
+	fori (UTILS_ELEMENT_COUNT(PERIODS)) {
+		f_data[i].period = PERIODS[i];
+		threadSchedAdd(&f_tcbs[i], thread_sleeper, &f_data[i]);
+	}
+	run_ticks(8);
+	TEST_ASSERT_EQUAL_STRING("0123" "13" "2" "13" "0", f_log);
+}
+
+void testThreadSchedTickWrap() {
+	f_ticks = (thread_ticks_t)-5;
+	f_data[0].period = 4;
+	f_data[1].period = 10;
+	threadSchedAdd(&f_tcbs[0], thread_sleeper, &f_data[0]);
+	threadSchedAdd(&f_tcbs[1], thread_sleeper, &f_data[1]);
+	run_ticks(12);
+	TEST_ASSERT_EQUAL_STRING("01" "0" "0" "1", f_log);
+}
+
+void testThreadSchedBlockWake() {
+	threadSchedAdd(&f_tcbs[0], thread_blocker, &f_data[0]);
+	run_ticks(5);
+	TEST_ASSERT_EQUAL_UINT16(1, f_data[0].runs);
+	TEST_ASSERT_EQUAL_UINT8(THREAD_SCHED_STATE_BLOCKED, f_tcbs[0].state);
+
+	threadSchedWake(&f_tcbs[0]);								// Woken but condition not true so blocks again.
+	run_ticks(5);
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].runs);
+	TEST_ASSERT_EQUAL_UINT16(0, f_data[0].loops);
+
+	f_data[0].flag = true;
+	threadSchedWake(&f_tcbs[0]);
+	threadSchedWake(&f_tcbs[0]);								// Second wake has no effect.
+	run_ticks(5);
+	TEST_ASSERT_EQUAL_UINT16(3, f_data[0].runs);
+	TEST_ASSERT_EQUAL_UINT16(1, f_data[0].loops);
+}
+
+void testThreadSchedWakeSleeper() {
+	f_data[0].period = 100;
+	f_data[1].period = 50;
+	threadSchedAdd(&f_tcbs[0], thread_sleeper, &f_data[0]);
+	threadSchedAdd(&f_tcbs[1], thread_sleeper, &f_data[1]);
+	run_ticks(10);
+	threadSchedWake(&f_tcbs[0]);
+	run_ticks(1);
+	TEST_ASSERT_EQUAL_STRING("010", f_log);
+	f_ticks = 50;
+	run_ticks(1);
+	TEST_ASSERT_EQUAL_STRING("0101", f_log);					// Other sleeper still on sleep list.
+}
+
+void testThreadSchedSleepUntilDelayDoneWake() {
+	f_data[0].period = 20;
+	threadSchedAdd(&f_tcbs[0], thread_timeout, &f_data[0]);
+	run_ticks(5);
+	TEST_ASSERT_EQUAL_UINT16(0, f_data[0].loops);
+	threadSchedWake(&f_tcbs[0]);								// Woken early, delay not done.
+	run_ticks(1);
+	TEST_ASSERT_EQUAL_UINT16(1, f_data[0].loops);
+	TEST_ASSERT_FALSE(f_data[0].flag);
+	run_ticks(20);												// Delay restarted at tick 5, done after 20 ticks.
+	TEST_ASSERT_EQUAL_UINT16(1, f_data[0].loops);
+	run_ticks(1);
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].loops);
+	TEST_ASSERT_TRUE(f_data[0].flag);
+}
+
+void testThreadSchedYield() {
+	threadSchedAdd(&f_tcbs[0], thread_yielder, &f_data[0]);
+	run_ticks(10);
+	TEST_ASSERT_EQUAL_UINT16(10, f_data[0].loops);
+	TEST_ASSERT_EQUAL_UINT8(THREAD_SCHED_STATE_READY, f_tcbs[0].state);
+}
+
+void testThreadSchedExit() {
+	f_data[0].period = 2;
+	threadSchedAdd(&f_tcbs[0], thread_exiter, &f_data[0]);
+	run_ticks(10);
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].runs);
+	TEST_ASSERT_EQUAL_UINT8(THREAD_SCHED_STATE_DONE, f_tcbs[0].state);
+	TEST_ASSERT_EQUAL_INT8(3, f_tcbs[0].rc);
+	threadSchedWake(&f_tcbs[0]);								// No effect.
+	run_ticks(10);
+	TEST_ASSERT_EQUAL_UINT16(2, f_data[0].runs);
+}
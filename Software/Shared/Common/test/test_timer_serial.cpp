@@ -0,0 +1,411 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+TT_BEGIN_INCLUDE()
+#include "Arduino.h"
+#include "utils.h"
+TT_END_INCLUDE()
+
+/* Loopback model of the ATmega328 Timer1 for TimerSerial, the driver is included here so that the model can call its ISRs and look at its state.
+	Time is in timer ticks. Each tick the model runs the compare units, which drive the TX line, the input capture unit on the RX line, then the
+	interrupt controller, which runs the highest priority pending ISR if not blocked. Each ISR blocks others for ISR_CYCLES, and random blocking
+	of up to a set number of cycles models other ISRs & critical sections. The RX line is either looped back from TX or driven by a model of a
+	remote UART. The input capture noise canceller delay is not modelled as it is the same for all edges. */
+
+#define __AVR_ATmega328P__
+#define F_CPU 16000000UL
+#define _BV(b_) (1 << (b_))
+#define ISR(vect_) static void vect_()
+
+enum { COM1A1 = 7, COM1A0 = 6 };
+enum { ICNC1 = 7, ICES1 = 6, CS11 = 1, CS10 = 0 };
+enum { FOC1A = 7 };
+enum { ICIE1 = 5, OCIE1B = 2, OCIE1A = 1 };
+enum { ICF1 = 5, OCF1B = 2, OCF1A = 1 };
+enum { SREG_I = 7 };
+
+// Flags are cleared by writing a 1.
+static struct ModelTifr1 {
+	uint8_t flags;
+	void operator = (uint8_t v) { flags = (uint8_t)(flags & ~v); }
+	operator uint8_t() const { return flags; }
+} TIFR1;
+
+// Changing the capture edge may set the capture flag, the model always does so the driver must clear it.
+static struct ModelTccr1b {
+	uint8_t v;
+	void operator = (uint8_t x) {
+		if ((x ^ v) & _BV(ICES1))
+			TIFR1.flags |= _BV(ICF1);
+		v = x;
+	}
+	void operator &= (uint8_t x) { *this = (uint8_t)(v & x); }
+	void operator |= (uint8_t x) { *this = (uint8_t)(v | x); }
+	void operator ^= (uint8_t x) { *this = (uint8_t)(v ^ x); }
+	operator uint8_t() const { return v; }
+} TCCR1B;
+
+static uint8_t TCCR1A, TIMSK1, SREG;
+static uint16_t TCNT1, OCR1A, OCR1B, ICR1;
+static inline void cli() { SREG &= (uint8_t)~_BV(SREG_I); }
+
+enum { MODEL_TX_EDGES_MAX = 2048 };
+typedef struct {
+	uint32_t t;
+	uint8_t level;
+} ModelEdge;
+
+static struct {
+	uint32_t now;						// Timer ticks.
+	uint32_t blocked_until;				// No ISR runs before this time.
+	uint16_t latency_max_cycles;		// Maximum random blocking, zero for none.
+	bool loopback;
+	uint8_t tx, rx;						// Line levels.
+	ModelEdge tx_edges[MODEL_TX_EDGES_MAX];
+	uint16_t tx_edge_count;
+	const uint8_t* remote_chars;		// Remote UART sends these chars, each frame_bits long, starting at remote_start.
+	uint8_t remote_count;
+	uint8_t remote_frame_bits;
+	uint32_t remote_start;
+	uint32_t remote_ticks_per_bit_x256;
+	uint16_t capt_count, compa_count, compb_count;
+} f_model;
+
+static void tx_set(uint8_t level) {
+	if (level != f_model.tx) {
+		f_model.tx = level;
+		TEST_ASSERT(f_model.tx_edge_count < MODEL_TX_EDGES_MAX);
+		f_model.tx_edges[f_model.tx_edge_count].t = f_model.now;
+		f_model.tx_edges[f_model.tx_edge_count].level = level;
+		f_model.tx_edge_count += 1;
+	}
+}
+
+// Forcing the compare output sets the pin to the level for the next match.
+static struct ModelTccr1c {
+	void operator = (uint8_t x) {
+		if ((x & _BV(FOC1A)) && (TCCR1A & _BV(COM1A1)))
+			tx_set(!!(TCCR1A & _BV(COM1A0)));
+	}
+} TCCR1C;
+
+// Only the TX pin is written by the driver, after it has released it from the timer.
+static void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; tx_set(val); }
+
+#include "../../AVR/src/timer_serial.cpp"
+
+static uint8_t model_prescale() { return (TCCR1B & _BV(CS11)) ? 8U : 1U; }
+
+static uint8_t remote_level() {
+	if (f_model.now < f_model.remote_start)
+		return 1;
+	const uint32_t bit = (uint32_t)(((uint64_t)(f_model.now - f_model.remote_start) << 8) / f_model.remote_ticks_per_bit_x256);
+	if ((bit / f_model.remote_frame_bits) >= f_model.remote_count)
+		return 1;
+	const uint8_t c = f_model.remote_chars[bit / f_model.remote_frame_bits];
+	const uint32_t b = bit % f_model.remote_frame_bits;
+	if (0U == b)								// Start bit.
+		return 0;
+	if (b <= 8U)								// Data bits.
+		return (uint8_t)((c >> (b - 1U)) & 1U);
+	return 1;									// Stop bit & idle.
+}
+
+// Cycles for an ISR, including entry & exit.
+static const uint16_t ISR_CYCLES = 80U;
+
+static void model_step() {
+	f_model.now += 1;
+	TCNT1 = (uint16_t)f_model.now;
+
+	if (TCNT1 == OCR1A) {
+		TIFR1.flags |= _BV(OCF1A);
+		if (TCCR1A & _BV(COM1A1))
+			tx_set(!!(TCCR1A & _BV(COM1A0)));
+	}
+	if (TCNT1 == OCR1B)
+		TIFR1.flags |= _BV(OCF1B);
+
+	const uint8_t rx = f_model.loopback ? f_model.tx : remote_level();
+	if (rx != f_model.rx) {
+		f_model.rx = rx;
+		if (!!rx == !!(TCCR1B & _BV(ICES1))) {
+			ICR1 = TCNT1;
+			TIFR1.flags |= _BV(ICF1);
+		}
+	}
+
+	if (f_model.now < f_model.blocked_until)
+		return;
+	if ((f_model.latency_max_cycles > 0U) && (0 == (rand() % 64))) {
+		f_model.blocked_until = f_model.now + 1U + (uint32_t)rand() % (f_model.latency_max_cycles / model_prescale());
+		return;
+	}
+	if (!(SREG & _BV(SREG_I)))
+		return;
+
+	// Flag & enable bits are in the same positions. Vectors in priority order are CAPT, COMPA, COMPB. The flag is cleared as the ISR runs.
+	const uint8_t pending = (uint8_t)(TIFR1 & TIMSK1);
+	if (pending & _BV(ICF1)) {
+		TIFR1.flags &= (uint8_t)~_BV(ICF1);
+		TIMER1_CAPT_vect();
+		f_model.capt_count += 1;
+	}
+	else if (pending & _BV(OCF1A)) {
+		TIFR1.flags &= (uint8_t)~_BV(OCF1A);
+		TIMER1_COMPA_vect();
+		f_model.compa_count += 1;
+	}
+	else if (pending & _BV(OCF1B)) {
+		TIFR1.flags &= (uint8_t)~_BV(OCF1B);
+		TIMER1_COMPB_vect();
+		f_model.compb_count += 1;
+	}
+	else
+		return;
+	f_model.blocked_until = f_model.now + utilsLimitMinU32(ISR_CYCLES / model_prescale(), 1U);
+}
+
+static TimerSerial f_serial;
+static uint8_t f_rx_buf[256];
+static uint16_t f_rx_len;
+
+// Run the model, reading received chars as the main loop would.
+static void run(uint32_t ticks) {
+	while (ticks-- > 0U) {
+		model_step();
+		while (f_serial.available() && (f_rx_len < sizeof(f_rx_buf)))
+			f_rx_buf[f_rx_len++] = (uint8_t)f_serial.read();
+	}
+}
+static uint32_t bit_ticks() { return f_timer_serial.ticks_per_bit; }
+
+// Start the driver with the timer count near the wrap so that it is exercised early.
+static void start(uint32_t baud, uint16_t latency_max_cycles, bool loopback) {
+	memset(&f_model, 0, sizeof(f_model));
+	f_model.now = 0xff00U;
+	f_model.tx = f_model.rx = 1;
+	f_model.latency_max_cycles = latency_max_cycles;
+	f_model.loopback = loopback;
+	TIFR1.flags = TIMSK1 = TCCR1A = 0;
+	TCCR1B.v = 0;
+	TCNT1 = (uint16_t)f_model.now;
+	OCR1A = OCR1B = ICR1 = 0;
+	SREG = _BV(SREG_I);
+	f_rx_len = 0;
+	f_serial.begin(baud);
+}
+
+// Remote UART sends chars starting a few bits from now, with its baudrate in error by the given parts per thousand.
+static void remote_send(const uint8_t* chars, uint8_t count, uint8_t frame_bits, int16_t error_ppt) {
+	f_model.remote_chars = chars;
+	f_model.remote_count = count;
+	f_model.remote_frame_bits = frame_bits;
+	f_model.remote_start = f_model.now + 3U * bit_ticks();
+	f_model.remote_ticks_per_bit_x256 = (uint32_t)((int32_t)(bit_ticks() * 256U) * (1000 - error_ppt) / 1000);
+}
+
+/* Decode chars sent on the TX line from its edges, checking that each edge is exactly on a bit boundary from the start bit, so there is no
+	jitter from ISR latency. Returns count, and the start bit time of each char. */
+static uint8_t decode_tx(uint8_t* chars, uint32_t* starts, uint8_t size) {
+	const uint32_t tpb = bit_ticks();
+	const ModelEdge* edges = f_model.tx_edges;
+	uint8_t n = 0;
+	uint16_t e = 0;
+	while ((e < f_model.tx_edge_count) && (n < size)) {
+		TEST_ASSERT_EQUAL_UINT8(0, edges[e].level);
+		const uint32_t start = edges[e++].t;
+		uint8_t level = 0;
+		uint8_t c = 0;
+		for (uint8_t b = 1; b <= 9; b += 1) {							// Data bits then stop bit.
+			while ((e < f_model.tx_edge_count) && (edges[e].t <= start + b * tpb)) {
+				TEST_ASSERT_EQUAL_UINT32(0, (edges[e].t - start) % tpb);
+				level = edges[e++].level;
+			}
+			if (b <= 8)
+				c = (uint8_t)((c >> 1) | (level << 7));
+		}
+		TEST_ASSERT_EQUAL_UINT8(1, level);
+		if (e < f_model.tx_edge_count)
+			TEST_ASSERT(edges[e].t >= start + 10U * tpb);
+		chars[n] = c;
+		starts[n] = start;
+		n += 1;
+	}
+	return n;
+}
+
+// Chars that end in 0 & 1 bits, no edges or edges every bit, then pseudo random.
+static void make_message(uint8_t* msg, uint8_t len) {
+	static const uint8_t SPECIALS[] = { 0x00, 0xff, 0x55, 0xaa, 0x80, 0x7f, 0x01, 0xfe, 0x0f, 0xf0 };
+	fori (len)
+		msg[i] = (i < UTILS_ELEMENT_COUNT(SPECIALS)) ? SPECIALS[i] : (uint8_t)rand();
+}
+
+// Random blocking of up to 5us at 16MHz, as from other ISRs.
+static const uint16_t LATENCY_MAX_CYCLES = 80U;
+
+static const uint32_t BAUDRATES[] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600 };
+
+void testTimerSerialSetup() {
+	srand(1234);
+}
+TT_BEGIN_FIXTURE(testTimerSerialSetup, NULL, NULL);
+
+void testTimerSerialBegin() {
+	start(1200, 0, true);
+	TEST_ASSERT_EQUAL_UINT8(_BV(CS11), TCCR1B & (_BV(CS11) | _BV(CS10)));		// Too slow for no prescaler.
+	TEST_ASSERT_EQUAL_UINT16(1667, bit_ticks());
+	start(57600, 0, true);
+	TEST_ASSERT_EQUAL_UINT8(_BV(CS10), TCCR1B & (_BV(CS11) | _BV(CS10)));
+	TEST_ASSERT_EQUAL_UINT16(278, bit_ticks());
+	TEST_ASSERT_EQUAL_UINT8(1, f_model.tx);
+	TEST_ASSERT_EQUAL_UINT8(0, TIFR1 & _BV(ICF1));
+	TEST_ASSERT_EQUAL_UINT8(_BV(ICIE1), TIMSK1);
+	TEST_ASSERT_EQUAL_INT(-1, f_serial.read());
+	TEST_ASSERT_EQUAL_INT(-1, f_serial.peek());
+}
+
+// Send a message back to back with TX looped back to RX at all baudrates, with random ISR latency.
+void testTimerSerialLoopback() {
+	enum { LEN = 100 };
+	uint8_t msg[LEN];
+	make_message(msg, LEN);
+	fori (UTILS_ELEMENT_COUNT(BAUDRATES)) {
+		start(BAUDRATES[i], LATENCY_MAX_CYCLES, true);
+		uint8_t sent = 0;
+		uint32_t timeout = (LEN + 2U) * 10U * bit_ticks();
+		while ((f_rx_len < LEN) && (timeout-- > 0U)) {
+			while ((sent < LEN) && !queueTimerSerialTxFull(&f_timer_serial.tx_q))
+				f_serial.write(msg[sent++]);
+			run(1);
+		}
+		TEST_ASSERT_EQUAL_UINT16(LEN, f_rx_len);
+		TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, f_rx_buf, LEN);
+		TEST_ASSERT_EQUAL_UINT8(0, f_serial.overruns());
+
+		// TX is back to back as the queue is refilled at the stop bit.
+		uint8_t tx[LEN];
+		uint32_t starts[LEN];
+		TEST_ASSERT_EQUAL_UINT8(LEN, decode_tx(tx, starts, LEN));
+		TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, tx, LEN);
+		forj (LEN - 1)
+			TEST_ASSERT_EQUAL_UINT32(10U * bit_ticks(), starts[j + 1] - starts[j]);
+		run(2U * bit_ticks());
+		TEST_ASSERT_EQUAL_UINT8(TX_STATE_IDLE, f_timer_serial.tx_state);
+		TEST_ASSERT_EQUAL_UINT8(0, TIMSK1 & _BV(OCIE1A));
+	}
+}
+
+// Chars ending in 1 bits have no edge after the last 0 bit, so are finished by the compare B ISR in the stop bit.
+void testTimerSerialRxEndsInOnes() {
+	static const uint8_t MSG[] = { 0xff, 0x80, 0xc3, 0xfe };
+	start(9600, 0, false);
+	remote_send(MSG, sizeof(MSG), 15, 0);
+	run(5U * 15U * bit_ticks());
+	TEST_ASSERT_EQUAL_UINT16(sizeof(MSG), f_rx_len);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(MSG, f_rx_buf, sizeof(MSG));
+	TEST_ASSERT_EQUAL_UINT16(sizeof(MSG), f_model.compb_count);
+	TEST_ASSERT_EQUAL_UINT8(0, TIMSK1 & _BV(OCIE1B));
+}
+
+// Chars ending in 0 bits are finished by the edge at the start of the stop bit.
+void testTimerSerialRxEndsInZeros() {
+	static const uint8_t MSG[] = { 0x00, 0x7f, 0x3c, 0x01 };
+	start(9600, 0, false);
+	remote_send(MSG, sizeof(MSG), 15, 0);
+	run(5U * 15U * bit_ticks());
+	TEST_ASSERT_EQUAL_UINT16(sizeof(MSG), f_rx_len);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(MSG, f_rx_buf, sizeof(MSG));
+	TEST_ASSERT_EQUAL_UINT16(0, f_model.compb_count);
+}
+
+// Back to back chars from a remote UART with its baudrate 2% either side, with random ISR latency.
+void testTimerSerialRxBackToBack() {
+	enum { LEN = 64 };
+	uint8_t msg[LEN];
+	make_message(msg, LEN);
+	static const int16_t ERRORS_PPT[] = { -20, 0, 20 };
+	fori (UTILS_ELEMENT_COUNT(BAUDRATES)) {
+		forj (UTILS_ELEMENT_COUNT(ERRORS_PPT)) {
+			start(BAUDRATES[i], LATENCY_MAX_CYCLES, false);
+			remote_send(msg, LEN, 10, ERRORS_PPT[j]);
+			run((LEN + 5U) * 10U * bit_ticks());
+			TEST_ASSERT_EQUAL_UINT16(LEN, f_rx_len);
+			TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, f_rx_buf, LEN);
+		}
+	}
+}
+
+/* If the compare B ISR for a char ending in 1 bits is held off past the start bit of the next char, both ISRs are pending and the capture ISR
+	runs first. It must finish the char and then start the next one from its start bit edge. */
+void testTimerSerialRxCaptAndCompbPending() {
+	static const uint8_t MSG[] = { 0xff, 0x55, 0xf0 };
+	start(9600, 0, false);
+	remote_send(MSG, sizeof(MSG), 10, 0);
+	run(f_model.remote_start + 9U * bit_ticks() - f_model.now);		// Start of stop bit of first char.
+	f_model.blocked_until = f_model.now + 3U * bit_ticks() / 2U;		// Into the first data bit of the second char.
+	run(3U * bit_ticks() / 2U - 1U);
+	TEST_ASSERT_EQUAL_UINT8(_BV(ICF1) | _BV(OCF1B), TIFR1 & (_BV(ICF1) | _BV(OCF1B)));
+	run(5U * 10U * bit_ticks());
+	TEST_ASSERT_EQUAL_UINT16(sizeof(MSG), f_rx_len);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(MSG, f_rx_buf, sizeof(MSG));
+}
+
+// A char written while the stop bit is sent follows it with no gap.
+void testTimerSerialTxRefillAtStop() {
+	start(9600, 0, true);
+	f_serial.write('A');
+	while (TX_STATE_STOP != f_timer_serial.tx_state)
+		run(1);
+	f_serial.write('B');
+	run(25U * bit_ticks());
+	uint8_t tx[2];
+	uint32_t starts[2];
+	TEST_ASSERT_EQUAL_UINT8(2, decode_tx(tx, starts, 2));
+	TEST_ASSERT_EQUAL_UINT8_ARRAY("AB", tx, 2);
+	TEST_ASSERT_EQUAL_UINT32(10U * bit_ticks(), starts[1] - starts[0]);
+	TEST_ASSERT_EQUAL_UINT16(2, f_rx_len);
+	TEST_ASSERT_EQUAL_UINT8(TX_STATE_IDLE, f_timer_serial.tx_state);
+}
+
+// A char written after the stop bit but before the driver goes idle is sent after one idle bit, after that it is started by write().
+void testTimerSerialTxRefillAtStopEnd() {
+	start(9600, 0, true);
+	f_serial.write('A');
+	while (TX_STATE_STOP_END != f_timer_serial.tx_state)
+		run(1);
+	f_serial.write('B');
+	run(15U * bit_ticks());
+	TEST_ASSERT_EQUAL_UINT8(TX_STATE_IDLE, f_timer_serial.tx_state);
+	TEST_ASSERT_EQUAL_UINT8(0, TIMSK1 & _BV(OCIE1A));
+	f_serial.write('C');
+	run(15U * bit_ticks());
+	uint8_t tx[3];
+	uint32_t starts[3];
+	TEST_ASSERT_EQUAL_UINT8(3, decode_tx(tx, starts, 3));
+	TEST_ASSERT_EQUAL_UINT8_ARRAY("ABC", tx, 3);
+	TEST_ASSERT_EQUAL_UINT32(11U * bit_ticks(), starts[1] - starts[0]);
+	TEST_ASSERT_EQUAL_UINT16(3, f_rx_len);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY("ABC", f_rx_buf, 3);
+}
+
+// Chars received with the buffer full are counted & lost.
+void testTimerSerialRxOverrun() {
+	enum { LEN = CFG_TIMER_SERIAL_RX_BUFFER_SIZE + 3 };
+	uint8_t msg[LEN];
+	make_message(msg, LEN);
+	start(57600, 0, false);
+	remote_send(msg, LEN, 10, 0);
+	for (uint32_t t = 0; t < (LEN + 5U) * 10U * bit_ticks(); t += 1)		// Run without reading.
+		model_step();
+	TEST_ASSERT_EQUAL_UINT8(3, f_serial.overruns());
+	TEST_ASSERT_EQUAL_INT(CFG_TIMER_SERIAL_RX_BUFFER_SIZE, f_serial.available());
+	TEST_ASSERT_EQUAL_INT(msg[0], f_serial.peek());
+	fori (CFG_TIMER_SERIAL_RX_BUFFER_SIZE)
+		TEST_ASSERT_EQUAL_INT(msg[i], f_serial.read());
+}
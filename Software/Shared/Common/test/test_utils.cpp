@@ -6,6 +6,7 @@
 #include "unity.h"
 
 TT_BEGIN_INCLUDE()
+#include "Arduino.h"
 #include "utils.h"
 TT_END_INCLUDE()
 
@@ -400,3 +401,173 @@ TT_TEST_CASE(testUtilsStrtoui("%llx", UINT_MAX,  16, UTILS_STRTOUI_RC_OK, UINT_M
 // Overflow...
 TT_TEST_CASE(testUtilsStrtoui("%llu", (unsigned long long)UINT_MAX+1,  10, UTILS_STRTOUI_RC_OVERFLOW, 0, '\0'));
 TT_TEST_CASE(testUtilsStrtoui("%llx", (unsigned long long)UINT_MAX+1,  16, UTILS_STRTOUI_RC_OVERFLOW, 0, '\0'));
+
+// Multiple threshold comparators.
+//
+
+// Example from utils.h.
+void testUtilsMultiThresholdSweep() {
+	static const uint16_t THRESHOLDS[] = { 50, 100, 500 };
+	static const uint16_t UP[] = { 0, 51, 101, 501 };		// Lowest value for each level going up.
+	static const uint16_t DOWN_HIGH[] = { 30, 80, 480 };		// Highest value for each level going down, level 3 is above 480.
+	uint8_t level = 0;
+	for (uint16_t x = 0; x <= 600; x += 1) {
+		const uint8_t old_level = level;
+		const bool changed = utilsMultiThreshold(THRESHOLDS, UTILS_ELEMENT_COUNT(THRESHOLDS), 20, &level, x);
+		uint8_t exp = 0;
+		while ((exp < 3) && (x >= UP[exp + 1])) exp += 1;
+		TEST_ASSERT_EQUAL_UINT8(exp, level);
+		TEST_ASSERT_EQUAL(old_level != level, changed);
+	}
+	for (int16_t x = 600; x >= 0; x -= 1) {
+		utilsMultiThreshold(THRESHOLDS, UTILS_ELEMENT_COUNT(THRESHOLDS), 20, &level, (uint16_t)x);
+		uint8_t exp = 3;
+		while ((exp > 0) && (x <= DOWN_HIGH[exp - 1])) exp -= 1;
+		TEST_ASSERT_EQUAL_UINT8(exp, level);
+	}
+}
+
+// Hysteresis larger than the threshold lowers it to zero rather than wrapping.
+void testUtilsMultiThresholdHysteresisUnderflow() {
+	static const uint16_t THRESHOLDS[] = { 10, 100 };
+	uint8_t level = 1;
+	TEST_ASSERT_FALSE(utilsMultiThreshold(THRESHOLDS, UTILS_ELEMENT_COUNT(THRESHOLDS), 20, &level, 1));
+	TEST_ASSERT_EQUAL_UINT8(1, level);
+	TEST_ASSERT(utilsMultiThreshold(THRESHOLDS, UTILS_ELEMENT_COUNT(THRESHOLDS), 20, &level, 0));
+	TEST_ASSERT_EQUAL_UINT8(0, level);
+}
+
+// Check level after a sequence of values, each starting from the level left by the last.
+TT_BEGIN_INCLUDE()
+static const uint16_t MT_THRESHOLDS[] = { 100, 200, 300 };
+static const uint16_t MT_HYSTERESIS[] = { 10, 0, 50 };
+TT_END_INCLUDE()
+void testUtilsMultiThresholdTableEdges(uint8_t level, uint16_t val, uint8_t exp) {
+	const uint8_t old_level = level;
+	const bool changed = utilsMultiThresholdTableU16(MT_THRESHOLDS, MT_HYSTERESIS, UTILS_ELEMENT_COUNT(MT_THRESHOLDS), &level, val);
+	TEST_ASSERT_EQUAL_UINT8(exp, level);
+	TEST_ASSERT_EQUAL(old_level != exp, changed);
+}
+TT_BEGIN_SCRIPT()
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(0, 0, 0));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(0, 100, 0));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(0, 101, 1));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(0, 301, 3));		// Jump up several levels.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(0, 0xffff, 3));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(1, 91, 1));			// Hysteresis 10 on first threshold.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(1, 90, 0));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(1, 200, 1));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(1, 201, 2));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(2, 200, 1));		// No hysteresis on second threshold.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(2, 201, 2));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(2, 300, 2));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(3, 251, 3));		// Hysteresis 50 on third threshold.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(3, 250, 2));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(3, 91, 1));			// Jump down several levels, lower thresholds have hysteresis.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(3, 90, 0));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(3, 0, 0));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(200, 301, 3));		// Bad level is treated as the top level.
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(200, 300, 3));
+TT_TEST_CASE(testUtilsMultiThresholdTableEdges(200, 0, 0));
+TT_END_SCRIPT()
+
+void testUtilsMultiThresholdTableNoHysteresis() {
+	uint8_t level = 3;
+	TEST_ASSERT(utilsMultiThresholdTableU16(MT_THRESHOLDS, NULL, UTILS_ELEMENT_COUNT(MT_THRESHOLDS), &level, 300));
+	TEST_ASSERT_EQUAL_UINT8(2, level);
+	TEST_ASSERT(utilsMultiThresholdTableU16(MT_THRESHOLDS, NULL, UTILS_ELEMENT_COUNT(MT_THRESHOLDS), &level, 101));
+	TEST_ASSERT_EQUAL_UINT8(1, level);
+	TEST_ASSERT(utilsMultiThresholdTableU16(MT_THRESHOLDS, NULL, 0, &level, 101));			// Empty table has only level zero.
+	TEST_ASSERT_EQUAL_UINT8(0, level);
+}
+
+void testUtilsMultiThresholdTableSigned() {
+	static const int16_t THRESHOLDS[] = { -1000, -10, 0, 10, 1000 };
+	static const int16_t HYSTERESIS[] = { 5, 5, 5, 5, 5 };
+	uint8_t level = 0;
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, -32768);
+	TEST_ASSERT_EQUAL_UINT8(0, level);
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, 1);
+	TEST_ASSERT_EQUAL_UINT8(3, level);
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, -5);
+	TEST_ASSERT_EQUAL_UINT8(2, level);
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, -14);
+	TEST_ASSERT_EQUAL_UINT8(2, level);
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, -15);
+	TEST_ASSERT_EQUAL_UINT8(1, level);
+	utilsMultiThresholdTableI16(THRESHOLDS, HYSTERESIS, UTILS_ELEMENT_COUNT(THRESHOLDS), &level, 32767);
+	TEST_ASSERT_EQUAL_UINT8(5, level);
+}
+
+// Compare with a linear scan of the thresholds, as utilsMultiThreshold() used to do, for random tables & random walks.
+static uint8_t multi_threshold_linear(const uint16_t* thresholds, const uint16_t* hysteresis, uint8_t count, uint8_t level, uint16_t val) {
+	uint8_t new_level = 0;
+	fori (count) {
+		uint16_t threshold = thresholds[i];
+		if (i < level)
+			threshold = (hysteresis[i] > threshold) ? 0U : (uint16_t)(threshold - hysteresis[i]);
+		new_level += (val > threshold);
+	}
+	return new_level;
+}
+void testUtilsMultiThresholdTableRandom() {
+	static uint16_t thresholds[255], hysteresis[255];
+	srand(1234);
+	fori (50) {
+		const uint8_t count = (uint8_t)(1 + rand() % 255);
+		uint16_t t = (uint16_t)(rand() % 100);
+		forj (count) {
+			const uint16_t gap = (uint16_t)(rand() % 200);		// Zero gap gives repeated thresholds.
+			t = (uint16_t)(t + gap);
+			thresholds[j] = t;
+			hysteresis[j] = (uint16_t)((j > 0) ? ((unsigned)rand() % (gap + 1U)) : ((unsigned)rand() % 200U));
+		}
+		uint8_t level = 0;
+		int32_t val = 0;
+		for (uint16_t n = 0; n < 2000; n += 1) {
+			val = (rand() % 8) ? (val + rand() % 401 - 200) : (rand() % (t + 200));	// Mostly a random walk with some jumps.
+			val = utilsLimit<int32_t>(val, 0, 0xffff);
+			const uint8_t exp = multi_threshold_linear(thresholds, hysteresis, count, level, (uint16_t)val);
+			utilsMultiThresholdTableU16(thresholds, hysteresis, count, &level, (uint16_t)val);
+			TEST_ASSERT_EQUAL_UINT8(exp, level);
+		}
+	}
+}
+
+// Scaler tables as generated by mk_tables.py.
+static const UtilsScalerSegment SCALER_VOLTS[] = { { 0, 0, 1290925 }, { 1023, 20151, 0 } };
+void testUtilsScaleMatchesRescale() {
+	for (uint16_t x = 0; x <= 1023; x += 1)
+		TEST_ASSERT_UINT16_WITHIN(1, utilsRescaleU16(x, 1023U, 20151U), utilsScale(SCALER_VOLTS, UTILS_ELEMENT_COUNT(SCALER_VOLTS), x));
+	TEST_ASSERT_EQUAL_UINT16(20151, utilsScale(SCALER_VOLTS, UTILS_ELEMENT_COUNT(SCALER_VOLTS), 0xffff));		// Held at last point.
+}
+
+// Scaler through 100:1000,200:0,400:500.
+TT_BEGIN_INCLUDE()
+static const UtilsScalerSegment SCALER_VEE[] = { { 100, 1000, -655360 }, { 200, 0, 163840 }, { 400, 500, 0 } };
+TT_END_INCLUDE()
+void testUtilsScaleVee(uint16_t x, uint16_t exp) {
+	TEST_ASSERT_EQUAL_UINT16(exp, utilsScale(SCALER_VEE, UTILS_ELEMENT_COUNT(SCALER_VEE), x));
+}
+TT_BEGIN_SCRIPT()
+TT_TEST_CASE(testUtilsScaleVee(0, 1000));			// Held at first point.
+TT_TEST_CASE(testUtilsScaleVee(100, 1000));
+TT_TEST_CASE(testUtilsScaleVee(150, 500));			// Negative slope.
+TT_TEST_CASE(testUtilsScaleVee(199, 10));
+TT_TEST_CASE(testUtilsScaleVee(200, 0));
+TT_TEST_CASE(testUtilsScaleVee(201, 3));			// 2.5 rounds up.
+TT_TEST_CASE(testUtilsScaleVee(300, 250));
+TT_TEST_CASE(testUtilsScaleVee(400, 500));
+TT_TEST_CASE(testUtilsScaleVee(0xffff, 500));		// Held at last point.
+TT_END_SCRIPT()
+
+static const uint8_t INTERP_TABLE[] = { 0, 10, 30, 20, 255 };	// 5 entries for inputs 0..64 with a shift of 4.
+void testUtilsTableInterpolate() {
+	TEST_ASSERT_EQUAL_UINT8(0, utilsTableInterpolate(INTERP_TABLE, 4, 0));
+	TEST_ASSERT_EQUAL_UINT8(5, utilsTableInterpolate(INTERP_TABLE, 4, 8));
+	TEST_ASSERT_EQUAL_UINT8(10, utilsTableInterpolate(INTERP_TABLE, 4, 16));
+	TEST_ASSERT_EQUAL_UINT8(11, utilsTableInterpolate(INTERP_TABLE, 4, 17));		// 11.25
+	TEST_ASSERT_EQUAL_UINT8(25, utilsTableInterpolate(INTERP_TABLE, 4, 40));		// Falling.
+	TEST_ASSERT_EQUAL_UINT8(240, utilsTableInterpolate(INTERP_TABLE, 4, 63));
+	TEST_ASSERT_EQUAL_UINT8(255, utilsTableInterpolate(INTERP_TABLE, 4, 64));
+}
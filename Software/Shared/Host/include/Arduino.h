@@ -0,0 +1,124 @@
+#ifndef ARDUINO_H__
+#define ARDUINO_H__
+
+/* Host Arduino HAL, enough of the Arduino API and AVR registers to run the firmware on Linux. Time is simulated and only moves when the
+	simulation advances it, or when a serial port flush waits for the transmitter. Strings in PROGMEM are just in RAM. Pins are grouped 8 to a
+	port as in the unit test shim, this is not the real Mega2560 mapping but nothing depends on it apart from the switch scanner, which only
+	needs pins to map to a port & bit. See host.h for the functions used by a simulation to drive the HAL. */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>		// The AVR toolchain pulls this in indirectly, driver.cpp relies on it for EEMEM.
+#include "support_test.h"
+
+// Time.
+void delay(uint32_t ms);
+void delayMicroseconds(uint16_t us);
+
+// Interrupts, there are none.
+static inline void interrupts() { /* empty */ }
+static inline void noInterrupts() { /* empty */ }
+
+// Pins.
+enum { LOW = 0, HIGH = 1 };
+enum { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2 };
+enum { LSBFIRST = 0, MSBFIRST = 1 };
+enum {
+	A0 = 54, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15,
+	HOST_PIN_COUNT
+};
+#define HOST_PORT_COUNT ((HOST_PIN_COUNT + 7) / 8)
+extern volatile uint8_t g_host_ports[HOST_PORT_COUNT];
+#define digitalPinToPort(p_) ((uint8_t)((p_) / 8U))
+#define digitalPinToBitMask(p_) ((uint8_t)(1U << ((p_) % 8U)))
+#define portInputRegister(port_) (&g_host_ports[port_])
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+int analogRead(uint8_t pin);
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t bit_order, uint8_t val);
+
+class __FlashStringHelper;
+#define F(str_) (reinterpret_cast<const __FlashStringHelper*>(str_))
+
+enum { DEC = 10, HEX = 16 };
+
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buf, size_t sz) { size_t n = 0; while (sz--) n += write(*buf++); return n; }
+	size_t write(const char* s) { return print(s); }
+	virtual void flush() { /* empty */ }
+
+	size_t print(const char* s) { size_t n = 0; while ('\0' != *s) n += write((uint8_t)*s++); return n; }
+	size_t print(const __FlashStringHelper* s) { return print(reinterpret_cast<const char*>(s)); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(int x, int base=DEC) { return print((long)x, base); }
+	size_t print(unsigned x, int base=DEC) { return print((unsigned long)x, base); }
+	size_t print(long x, int base=DEC) { return (x < 0) ? (print('-') + print((unsigned long)-x, base)) : print((unsigned long)x, base); }
+	size_t print(unsigned long x, int base=DEC) {
+		char buf[24];
+		snprintf(buf, sizeof(buf), (HEX == base) ? "%lX" : "%lu", x);
+		return print(buf);
+	}
+	size_t println() { return print("\r\n"); }
+	template <typename T> size_t println(T x) { return print(x) + println(); }
+};
+
+class Stream : public Print {
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+};
+
+/* Serial port. Received bytes are queued by the simulation with a time of arrival, and are only available to the firmware once that time has
+	passed. Transmitted bytes are buffered for the simulation to read, flush() advances time by the time taken to send them at the baudrate.
+	If the transmit buffer fills further bytes are discarded. */
+class HardwareSerial : public Stream {
+public:
+	enum { BUF_SIZE = 256 };
+	HardwareSerial() : m_baud(9600), m_rx_head(0), m_rx_tail(0), m_tx_len(0), m_tx_unsent(0), m_rx_last_us(0), m_tx_cb(NULL) {}
+	void begin(unsigned long baud) { m_baud = baud; }
+	void end() { /* empty */ }
+	virtual int available();
+	virtual int read();
+	virtual int peek();
+	virtual size_t write(uint8_t c);
+	using Print::write;
+	virtual void flush();
+	operator bool() { return true; }
+
+	// Simulation side, queue bytes to be received back to back starting after a delay, read & clear transmitted bytes.
+	void hostRx(const uint8_t* buf, size_t sz, uint32_t delay_us=0);
+	void hostRx(const char* s) { hostRx((const uint8_t*)s, strlen(s)); }
+	size_t hostTxLen() const { return m_tx_len; }
+	const uint8_t* hostTxBuf() const { return m_tx; }
+	void hostTxClear() { m_tx_len = 0; }
+	void hostSetTxCallback(void (*cb)(uint8_t c)) { m_tx_cb = cb; }		// Transmitted bytes are sent to the callback rather than buffered.
+	uint32_t hostCharMicros() const { return (uint32_t)(10UL * 1000UL * 1000UL / m_baud); }
+
+private:
+	unsigned long m_baud;
+	struct { uint8_t c; uint32_t due_us; } m_rx[BUF_SIZE];
+	uint16_t m_rx_head, m_rx_tail;
+	uint8_t m_tx[BUF_SIZE];
+	uint16_t m_tx_len, m_tx_unsent;
+	uint32_t m_rx_last_us;
+	void (*m_tx_cb)(uint8_t c);
+};
+extern HardwareSerial Serial, Serial1, Serial2, Serial3;
+
+#endif	// ARDUINO_H__
@@ -0,0 +1,4 @@
+#pragma once
+
+// Host HAL, Arduino core header.
+#include "Arduino.h"
@@ -0,0 +1,19 @@
+#ifndef AVR_EEPROM_H__
+#define AVR_EEPROM_H__
+
+/* Host HAL, EEPROM is an array of E2END+1 bytes, initially erased to 0xff. Addresses within the array size are offsets into it, as used for
+	data at fixed addresses. EEMEM objects are ordinary RAM objects on the host, so larger addresses are accessed directly. */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <avr/io.h>
+
+#define EEMEM /* empty */
+
+uint8_t eeprom_read_byte(const uint8_t* p);
+void eeprom_write_byte(uint8_t* p, uint8_t v);
+static inline void eeprom_update_byte(uint8_t* p, uint8_t v) { if (eeprom_read_byte(p) != v) eeprom_write_byte(p, v); }
+void eeprom_read_block(void* dst, const void* src, size_t sz);
+void eeprom_update_block(const void* src, void* dst, size_t sz);
+
+#endif	// AVR_EEPROM_H__
@@ -0,0 +1,8 @@
+#ifndef AVR_INTERRUPT_H__
+#define AVR_INTERRUPT_H__
+
+// Host version of avr/interrupt.h, there are no interrupts.
+static inline void cli() { /* empty */ }
+static inline void sei() { /* empty */ }
+
+#endif	// AVR_INTERRUPT_H__
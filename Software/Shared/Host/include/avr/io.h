@@ -0,0 +1,34 @@
+#ifndef AVR_IO_H__
+#define AVR_IO_H__
+
+/* Host HAL, AVR port registers as plain variables so that generated gpio.h direct access functions compile, and the register bit names used
+	by dev.h. */
+
+#include <stdint.h>
+
+#define _BV(b_) (1U << (b_))
+
+#define HOST_DECLARE_PORT(p_) extern volatile uint8_t DDR##p_, PORT##p_, PIN##p_
+HOST_DECLARE_PORT(A);
+HOST_DECLARE_PORT(B);
+HOST_DECLARE_PORT(C);
+HOST_DECLARE_PORT(D);
+HOST_DECLARE_PORT(E);
+HOST_DECLARE_PORT(F);
+HOST_DECLARE_PORT(G);
+HOST_DECLARE_PORT(H);
+HOST_DECLARE_PORT(J);
+HOST_DECLARE_PORT(K);
+HOST_DECLARE_PORT(L);
+
+extern volatile uint8_t SREG;
+
+// MCUSR bits.
+enum { PORF = 0, EXTRF = 1, BORF = 2, WDRF = 3, JTRF = 4 };
+
+// ADMUX bits.
+enum { MUX0 = 0, ADLAR = 5, REFS0 = 6, REFS1 = 7 };
+
+#define E2END 0xfff		// As Mega2560.
+
+#endif	// AVR_IO_H__
@@ -0,0 +1,24 @@
+#ifndef AVR_PGMSPACE_H__
+#define AVR_PGMSPACE_H__
+
+// Host HAL, PROGMEM is just RAM.
+
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM /* empty */
+#define PGM_P const char*
+#define PSTR(str_) (str_)
+#define pgm_read_byte(x_) (*(x_))
+#define pgm_read_word(x_) (*(x_))
+#define pgm_read_dword(x_) (*(x_))
+#define pgm_read_ptr(x_) (*(x_))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define memcpy_P memcpy
+
+#endif	// AVR_PGMSPACE_H__
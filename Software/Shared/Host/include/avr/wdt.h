@@ -0,0 +1,12 @@
+#ifndef AVR_WDT_H__
+#define AVR_WDT_H__
+
+// Host HAL, there is no watchdog.
+
+enum { WDTO_15MS, WDTO_30MS, WDTO_60MS, WDTO_120MS, WDTO_250MS, WDTO_500MS, WDTO_1S, WDTO_2S, WDTO_4S, WDTO_8S };
+
+static inline void wdt_reset() { /* empty */ }
+static inline void wdt_enable(uint8_t timeout) { (void)timeout; }
+static inline void wdt_disable() { /* empty */ }
+
+#endif	// AVR_WDT_H__
@@ -0,0 +1,38 @@
+#ifndef HOST_H__
+#define HOST_H__
+
+/* Host HAL simulation interface. A simulation calls setup() then loop() repeatedly, advancing time between calls, and uses these functions
+	to drive inputs and read outputs. Serial ports are driven by the hostXxx() methods of HardwareSerial. */
+
+#include <stdint.h>
+
+// Simulated time, starts at zero. Note that each call to micros() also advances time by HOST_MICROS_CALL_COST_US, about the cost of the call
+//  on a 16MHz AVR, so that busy waits on micros() terminate.
+enum { HOST_MICROS_CALL_COST_US = 4 };
+void hostAdvanceMicros(uint32_t us);
+uint64_t hostMicros64();
+
+// Drive an input pin, read an output pin.
+void hostPinSet(uint8_t pin, bool level);
+bool hostPinGet(uint8_t pin);
+uint8_t hostPinMode(uint8_t pin);
+
+// Set the value read by analogRead() & the ADC driver for an analogue pin, in counts.
+void hostAnalogSet(uint8_t pin, uint16_t counts);
+
+// Last value written to a pin by analogWrite().
+int hostAnalogWriteGet(uint8_t pin);
+
+/* HD44780 LCD in 4 bit mode, decoded from writes to the pins when the enable pin goes low. Only the commands that affect the text are
+	modelled. Rows are returned as nul terminated strings. */
+void hostLcdAttach(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t cols, uint8_t rows);
+const char* hostLcdRow(uint8_t row);
+uint32_t hostLcdWriteCount();		// Count of characters written to the display.
+
+// Receive an IR code, calls the IRMP callback.
+void hostIrReceive(uint16_t address, uint16_t command, uint8_t flags);
+
+// Erase EEPROM to 0xff, call before setup() to simulate a new part. It is initially all zero.
+void hostEepromErase();
+
+#endif	// HOST_H__
@@ -0,0 +1,21 @@
+#ifndef IRMP_HPP__
+#define IRMP_HPP__
+
+// Host HAL, just the IRMP API used by the firmware. Codes are injected by the simulation with hostIrReceive().
+
+#include <stdint.h>
+
+typedef struct {
+	uint8_t protocol;
+	uint16_t address;
+	uint16_t command;
+	uint8_t flags;
+} IRMP_DATA;
+
+enum { IRMP_FLAG_REPETITION = 0x01 };
+
+void irmp_init();
+bool irmp_get_data(IRMP_DATA* data);
+void irmp_register_complete_callback_function(void (*cb)());
+
+#endif	// IRMP_HPP__
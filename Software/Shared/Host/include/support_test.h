@@ -0,0 +1,11 @@
+#ifndef SUPPORT_TEST_H__
+#define SUPPORT_TEST_H__
+
+// Host HAL, time functions declared in the same header as the unit test support, as modbus.cpp includes it in host builds.
+
+#include <stdint.h>
+
+uint32_t millis();
+uint32_t micros();
+
+# endif  	// SUPPORT_TEST_H__
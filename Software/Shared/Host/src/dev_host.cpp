@@ -0,0 +1,121 @@
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <avr/wdt.h>
+
+#include "project_config.h"
+#include "utils.h"
+#include "dev.h"
+#include "host.h"
+
+/* Host implementation of the AVR device drivers in dev.h. The ADC reads values set by hostAnalogSet(), conversions complete on the next
+	call to devAdcIsConversionDone(). The EEPROM driver is the same as the AVR version. There is no watchdog or stack so their stats are
+	empty. */
+
+// ADC.
+//
+
+static bool f_adc_done;
+static uint8_t f_adc_sample_counts[CFG_DEV_ADC_CHANNEL_COUNT_MAX];
+
+void devAdcInit(uint8_t ps) { (void)ps; }
+void devAdcSetupFunc(void* setup_arg) __attribute__((weak));
+void devAdcSetupFunc(void* setup_arg) { (void)setup_arg; }
+
+static uint8_t adc_chan_to_pin(uint8_t admux) {
+	const uint8_t chan = admux & 0x1f;
+	return (uint8_t)((chan >= DEV_ADC_CHAN_8) ? (A8 + chan - DEV_ADC_CHAN_8) : (A0 + chan));
+}
+void devAdcStartConversions() {
+	const DevAdcChannelDef* def = g_adc_def_list;
+	for (uint8_t idx = 0; DEV_ADC_RESULT_END != def->result; idx += 1, def += 1) {
+		devAdcSetupFunc(def->setup_arg);
+		if (DEV_ADC_RESULT_NONE != (void*)def->result)
+			*def->result = (uint16_t)analogRead(adc_chan_to_pin(def->admux));
+		if (idx < CFG_DEV_ADC_CHANNEL_COUNT_MAX)
+			f_adc_sample_counts[idx] += 1;
+	}
+	devAdcSetupFunc(def->setup_arg);
+	f_adc_done = true;
+}
+bool devAdcIsRunning() { return false; }
+bool devAdcIsConversionDone() {
+	const bool done = f_adc_done;
+	f_adc_done = false;
+	return done;
+}
+uint8_t devAdcSampleCount(uint8_t idx) { return (idx < CFG_DEV_ADC_CHANNEL_COUNT_MAX) ? f_adc_sample_counts[idx] : 0U; }
+
+// EEPROM.
+//
+
+enum { EEPROM_BANK_0, EEPROM_BANK_1 };
+
+static void write_eeprom(const DevEepromBlock* block, uint8_t bank_idx, dev_eeprom_checksum_t checksum) {
+	uint8_t* eeprom_dst = (uint8_t*)block->eeprom_data[bank_idx];
+	eeprom_update_block(&checksum, eeprom_dst, sizeof(dev_eeprom_checksum_t));
+	eeprom_update_block(block->data, eeprom_dst + sizeof(dev_eeprom_checksum_t), block->block_size);
+}
+static dev_eeprom_checksum_t get_checksum(const DevEepromBlock* block) {
+	UtilsChecksumEepromState s;
+	utilsChecksumEepromInit(&s);
+	utilsChecksumEepromUpdate(&s, (const uint8_t*)&block->version, sizeof(block->version));
+	utilsChecksumEepromUpdate(&s, (const uint8_t*)block->data, block->block_size);
+	return utilsChecksumEepromGet(&s);
+}
+static uint8_t read_eeprom(const DevEepromBlock* block, uint8_t bank_idx, dev_eeprom_checksum_t* checksum) {
+	const uint8_t* eeprom_src = (const uint8_t*)block->eeprom_data[bank_idx];
+	dev_eeprom_checksum_t eeprom_checksum;
+	eeprom_read_block(&eeprom_checksum, eeprom_src, sizeof(dev_eeprom_checksum_t));
+	eeprom_read_block(block->data, eeprom_src + sizeof(dev_eeprom_checksum_t), block->block_size);
+	*checksum = get_checksum(block);
+	return (*checksum != eeprom_checksum);
+}
+
+void devEepromInit(const DevEepromBlock* block) { (void)block; }
+uint8_t devEepromRead(const DevEepromBlock* block, const void* default_arg) {
+	uint8_t rc = 0;
+	dev_eeprom_checksum_t checksum[2];
+	for (uint8_t bank = 0; bank < 2; bank += 1)
+		rc = (uint8_t)((rc << 1) | read_eeprom(block, bank, &checksum[bank]));
+	switch (rc) {
+		case 0:
+			break;
+		case 3:
+			devEepromSetDefaults(block, default_arg);
+			devEepromWrite(block);
+			break;
+		case 2:
+			write_eeprom(block, EEPROM_BANK_0, checksum[1]);
+			break;
+		case 1:
+			read_eeprom(block, EEPROM_BANK_0, &checksum[0]);
+			write_eeprom(block, EEPROM_BANK_1, checksum[0]);
+			break;
+		default:
+			break;
+	}
+	return rc;
+}
+void devEepromSetDefaults(const DevEepromBlock* block, const void* default_arg) { block->set_default(block->data, default_arg); }
+void devEepromWrite(const DevEepromBlock* block) {
+	const dev_eeprom_checksum_t checksum = get_checksum(block);
+	write_eeprom(block, EEPROM_BANK_0, checksum);
+	write_eeprom(block, EEPROM_BANK_1, checksum);
+}
+
+// Watchdog.
+//
+
+uint16_t devWatchdogInit() { return _BV(PORF); }
+void devWatchdogPat(uint8_t m) { (void)m; }
+void devWatchdogStatsGet(dev_watchdog_stats_t* stats) { memset(stats, 0, sizeof(*stats)); }
+void devWatchdogStatsClear() { /* empty */ }
+int16_t devWatchdogStatsMarginMs(const dev_watchdog_stats_t* stats, uint8_t idx) {
+	return (int16_t)((int32_t)DEV_WATCHDOG_TIMEOUT_MS - (int32_t)(stats->max_gap_us[idx] / 1000UL));
+}
+
+// Free RAM, not meaningful on the host so report the whole of the Mega2560 RAM free.
+//
+
+uint16_t devRamFree() { return 8192U; }
+uint16_t devRamFreeMin() { return 8192U; }
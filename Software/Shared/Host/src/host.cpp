@@ -0,0 +1,249 @@
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+#include "utils.h"
+#include "irmp.hpp"
+#include "host.h"
+
+// Time.
+//
+
+static uint64_t f_micros;
+
+void hostAdvanceMicros(uint32_t us) { f_micros += us; }
+uint64_t hostMicros64() { return f_micros; }
+
+uint32_t micros() {
+	f_micros += HOST_MICROS_CALL_COST_US;
+	return (uint32_t)f_micros;
+}
+uint32_t millis() { return (uint32_t)(f_micros / 1000U); }
+void delay(uint32_t ms) { f_micros += (uint64_t)ms * 1000U; }
+void delayMicroseconds(uint16_t us) { f_micros += us; }
+
+// AVR registers.
+//
+
+volatile uint8_t SREG;
+#define HOST_DEFINE_PORT(p_) volatile uint8_t DDR##p_, PORT##p_, PIN##p_
+HOST_DEFINE_PORT(A);
+HOST_DEFINE_PORT(B);
+HOST_DEFINE_PORT(C);
+HOST_DEFINE_PORT(D);
+HOST_DEFINE_PORT(E);
+HOST_DEFINE_PORT(F);
+HOST_DEFINE_PORT(G);
+HOST_DEFINE_PORT(H);
+HOST_DEFINE_PORT(J);
+HOST_DEFINE_PORT(K);
+HOST_DEFINE_PORT(L);
+
+// LCD decoder.
+//
+
+enum { LCD_COLS_MAX = 40, LCD_ROWS_MAX = 4 };
+static struct {
+	bool attached;
+	uint8_t pin_rs, pin_enable, pins_data[4];
+	uint8_t cols, rows;
+	bool four_bit;				// Set by function set command, LCD starts in 8 bit mode.
+	bool nibble_pending;		// Have high nibble of a byte in 4 bit mode.
+	uint8_t nibble;
+	uint8_t addr;				// DDRAM address.
+	char text[LCD_ROWS_MAX][LCD_COLS_MAX + 1];
+	uint32_t write_count;
+} f_lcd;
+
+static const uint8_t LCD_ROW_OFFSETS[LCD_ROWS_MAX] = { 0x00, 0x40, 0x14, 0x54 };
+
+static void lcd_clear() {
+	fori (LCD_ROWS_MAX) {
+		memset(f_lcd.text[i], ' ', f_lcd.cols);
+		f_lcd.text[i][f_lcd.cols] = '\0';
+	}
+	f_lcd.addr = 0;
+}
+static void lcd_byte(bool rs, uint8_t b) {
+	if (rs) {						// Character written at current address.
+		fori (f_lcd.rows) {
+			if ((f_lcd.addr >= LCD_ROW_OFFSETS[i]) && (f_lcd.addr < (LCD_ROW_OFFSETS[i] + f_lcd.cols))) {
+				f_lcd.text[i][f_lcd.addr - LCD_ROW_OFFSETS[i]] = (char)b;
+				f_lcd.write_count += 1;
+			}
+		}
+		f_lcd.addr = (uint8_t)((f_lcd.addr + 1U) & 0x7fU);
+	}
+	else if (b & 0x80)				// Set DDRAM address.
+		f_lcd.addr = b & 0x7f;
+	else if (b & 0x20)				// Function set, DL bit selects 8 bit mode.
+		f_lcd.four_bit = !(b & 0x10);
+	else if (b & 0x02)				// Home.
+		f_lcd.addr = 0;
+	else if (b & 0x01)				// Clear.
+		lcd_clear();
+}
+static void lcd_enable_falling() {
+	uint8_t nibble = 0;
+	fori (4) {
+		if (g_host_ports[digitalPinToPort(f_lcd.pins_data[i])] & digitalPinToBitMask(f_lcd.pins_data[i]))
+			nibble |= (uint8_t)(1U << i);
+	}
+	const bool rs = !!(g_host_ports[digitalPinToPort(f_lcd.pin_rs)] & digitalPinToBitMask(f_lcd.pin_rs));
+	if (!f_lcd.four_bit)			// 8 bit mode with only the high 4 data lines connected.
+		lcd_byte(rs, (uint8_t)(nibble << 4));
+	else if (!f_lcd.nibble_pending) {
+		f_lcd.nibble = nibble;
+		f_lcd.nibble_pending = true;
+	}
+	else {
+		lcd_byte(rs, (uint8_t)((f_lcd.nibble << 4) | nibble));
+		f_lcd.nibble_pending = false;
+	}
+}
+
+void hostLcdAttach(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t cols, uint8_t rows) {
+	memset(&f_lcd, 0, sizeof(f_lcd));
+	f_lcd.pin_rs = rs;
+	f_lcd.pin_enable = enable;
+	f_lcd.pins_data[0] = d4; f_lcd.pins_data[1] = d5; f_lcd.pins_data[2] = d6; f_lcd.pins_data[3] = d7;
+	f_lcd.cols = utilsLimitMax<uint8_t>(cols, LCD_COLS_MAX);
+	f_lcd.rows = utilsLimitMax<uint8_t>(rows, LCD_ROWS_MAX);
+	lcd_clear();
+	f_lcd.attached = true;
+}
+const char* hostLcdRow(uint8_t row) { return f_lcd.text[row % LCD_ROWS_MAX]; }
+uint32_t hostLcdWriteCount() { return f_lcd.write_count; }
+
+// Pins.
+//
+
+volatile uint8_t g_host_ports[HOST_PORT_COUNT];
+static uint8_t f_pin_modes[HOST_PIN_COUNT];
+static int f_analog_write[HOST_PIN_COUNT];
+static uint16_t f_analog_in[HOST_PIN_COUNT];
+
+static void pin_write(uint8_t pin, bool level) {
+	if (pin >= HOST_PIN_COUNT)
+		return;
+	const bool was = !!(g_host_ports[digitalPinToPort(pin)] & digitalPinToBitMask(pin));
+	if (level)
+		g_host_ports[digitalPinToPort(pin)] |= digitalPinToBitMask(pin);
+	else
+		g_host_ports[digitalPinToPort(pin)] &= (uint8_t)~digitalPinToBitMask(pin);
+	if (f_lcd.attached && (pin == f_lcd.pin_enable) && was && !level)
+		lcd_enable_falling();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin < HOST_PIN_COUNT)
+		f_pin_modes[pin] = mode;
+}
+void digitalWrite(uint8_t pin, uint8_t val) { pin_write(pin, !!val); }
+int digitalRead(uint8_t pin) { return hostPinGet(pin) ? HIGH : LOW; }
+void analogWrite(uint8_t pin, int val) {
+	if (pin < HOST_PIN_COUNT)
+		f_analog_write[pin] = val;
+}
+int analogRead(uint8_t pin) {
+	if (pin < A0)					// Arduino allows channel numbers as well as pins.
+		pin = (uint8_t)(pin + A0);
+	return (pin < HOST_PIN_COUNT) ? f_analog_in[pin] : 0;
+}
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t bit_order, uint8_t val) {
+	fori (8) {
+		digitalWrite(data_pin, (LSBFIRST == bit_order) ? (val & (1U << i)) : (val & (0x80U >> i)));
+		digitalWrite(clock_pin, HIGH);
+		digitalWrite(clock_pin, LOW);
+	}
+}
+
+void hostPinSet(uint8_t pin, bool level) { pin_write(pin, level); }
+bool hostPinGet(uint8_t pin) { return (pin < HOST_PIN_COUNT) && (g_host_ports[digitalPinToPort(pin)] & digitalPinToBitMask(pin)); }
+uint8_t hostPinMode(uint8_t pin) { return (pin < HOST_PIN_COUNT) ? f_pin_modes[pin] : (uint8_t)INPUT; }
+void hostAnalogSet(uint8_t pin, uint16_t counts) {
+	if (pin < HOST_PIN_COUNT)
+		f_analog_in[pin] = counts;
+}
+int hostAnalogWriteGet(uint8_t pin) { return (pin < HOST_PIN_COUNT) ? f_analog_write[pin] : 0; }
+
+// Serial.
+//
+
+HardwareSerial Serial, Serial1, Serial2, Serial3;
+
+int HardwareSerial::available() {
+	int n = 0;
+	for (uint16_t i = m_rx_tail; (i != m_rx_head) && (m_rx[i].due_us <= (uint32_t)f_micros); i = (uint16_t)((i + 1U) % BUF_SIZE))
+		n += 1;
+	return n;
+}
+int HardwareSerial::peek() {
+	return ((m_rx_tail != m_rx_head) && (m_rx[m_rx_tail].due_us <= (uint32_t)f_micros)) ? m_rx[m_rx_tail].c : -1;
+}
+int HardwareSerial::read() {
+	const int c = peek();
+	if (c >= 0)
+		m_rx_tail = (uint16_t)((m_rx_tail + 1U) % BUF_SIZE);
+	return c;
+}
+size_t HardwareSerial::write(uint8_t c) {
+	m_tx_unsent += 1;
+	if (NULL != m_tx_cb)
+		m_tx_cb(c);
+	else if (m_tx_len < BUF_SIZE)
+		m_tx[m_tx_len++] = c;
+	return 1;
+}
+void HardwareSerial::flush() {
+	f_micros += (uint64_t)m_tx_unsent * hostCharMicros();
+	m_tx_unsent = 0;
+}
+void HardwareSerial::hostRx(const uint8_t* buf, size_t sz, uint32_t delay_us) {
+	uint32_t due = utilsLimitMin<uint32_t>((uint32_t)f_micros + delay_us, m_rx_last_us);
+	while (sz-- > 0) {
+		const uint16_t next = (uint16_t)((m_rx_head + 1U) % BUF_SIZE);
+		if (next == m_rx_tail)		// Overrun, drop.
+			break;
+		due += hostCharMicros();
+		m_rx[m_rx_head].c = *buf++;
+		m_rx[m_rx_head].due_us = due;
+		m_rx_head = next;
+	}
+	m_rx_last_us = due;
+}
+
+// EEPROM.
+//
+
+static uint8_t f_eeprom[E2END + 1];
+static uint8_t* eeprom_addr(const void* p) {
+	const uintptr_t a = (uintptr_t)p;
+	return (a <= E2END) ? &f_eeprom[a] : (uint8_t*)p;
+}
+void hostEepromErase() { memset(f_eeprom, 0xff, sizeof(f_eeprom)); }
+uint8_t eeprom_read_byte(const uint8_t* p) { return *eeprom_addr(p); }
+void eeprom_write_byte(uint8_t* p, uint8_t v) { *eeprom_addr(p) = v; }
+void eeprom_read_block(void* dst, const void* src, size_t sz) {
+	for (size_t i = 0; i < sz; i += 1)
+		((uint8_t*)dst)[i] = eeprom_read_byte((const uint8_t*)src + i);
+}
+void eeprom_update_block(const void* src, void* dst, size_t sz) {
+	for (size_t i = 0; i < sz; i += 1)
+		eeprom_update_byte((uint8_t*)dst + i, ((const uint8_t*)src)[i]);
+}
+
+// IR.
+//
+
+static IRMP_DATA f_irmp_data;
+static void (*f_irmp_cb)();
+void irmp_init() { /* empty */ }
+bool irmp_get_data(IRMP_DATA* data) { *data = f_irmp_data; return true; }
+void irmp_register_complete_callback_function(void (*cb)()) { f_irmp_cb = cb; }
+void hostIrReceive(uint16_t address, uint16_t command, uint8_t flags) {
+	f_irmp_data.address = address;
+	f_irmp_data.command = command;
+	f_irmp_data.flags = flags;
+	if (NULL != f_irmp_cb)
+		f_irmp_cb();
+}
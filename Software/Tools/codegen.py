@@ -119,6 +119,24 @@ class Codegen:
 			add(f'   {name.upper()}_{n},')
 		self.add(' }')
 
+	def add_progmem_table(self, name, ctype, values, per_line=16):
+		"""Declare a static const array in PROGMEM, values are a list of numbers or a list of tuples for an array of structs. A check is made that
+			numbers fit the C type.
+			add_progmem_table('FOO', 'uint8_t', [1, 2, 3]) =>
+				static const uint8_t FOO[] PROGMEM = {
+					1, 2, 3,
+				};
+		"""
+		if ctype in C_TYPE_RANGES:
+			for v in values:
+				check_c_type(ctype, v)
+		def fmt(v):
+			return f"{{ {', '.join(str(x) for x in v)} }}" if isinstance(v, tuple) else str(v)
+		self.add(f'static const {ctype} {name}[] PROGMEM = {{')
+		for n in range(0, len(values), per_line):
+			self.add('\t' + ' '.join(fmt(v) + ',' for v in values[n:n+per_line]))
+		self.add('};')
+
 	def end(self):
 		"Finished writing output file. Will not overwrite if contents have not changed."
 		while self.trailers:
@@ -192,6 +210,72 @@ def format_code_with_comments(text, comments, col=48):
 	"Called with 'f00 = 3,', 'Stuff'; return 'f00 = 3,  ... // Stuff', with the comment leader at column 48."
 	return f"{text.ljust(col-1)}// {comments}"
 
+# Range of values for C integer types.
+C_TYPE_RANGES = {
+	'uint8_t': (0, 0xff), 'int8_t': (-0x80, 0x7f),
+	'uint16_t': (0, 0xffff), 'int16_t': (-0x8000, 0x7fff),
+	'uint32_t': (0, 0xffffffff), 'int32_t': (-0x80000000, 0x7fffffff),
+}
+def check_c_type(ctype, value):
+	"Raise CodegenException if the value will not fit the C type."
+	vmin, vmax = C_TYPE_RANGES[ctype]
+	if not vmin <= value <= vmax:
+		raise CodegenException(f"value {value} out of range for {ctype}.")
+
+def c_round(x):
+	"Round half away from zero, as a C programmer would expect, rather than the banker's rounding that Python does."
+	return int(x + 0.5) if x >= 0 else -int(-x + 0.5)
+
+# Lookup tables, these return a list of values for add_progmem_table().
+
+def table_gamma(size, gamma, max_out):
+	"""Gamma correction for a LED, value i is max_out * (i / (size-1)) ^ gamma.
+		table_gamma(5, 2.0, 16) => [0, 1, 4, 9, 16]
+	"""
+	return [c_round(max_out * (i / (size - 1)) ** gamma) for i in range(size)]
+
+def table_reciprocal(first, count, bits):
+	"""Reciprocals of first .. first+count-1 scaled by 2^bits, so that x/d can be done as (x * table[d-first]) >> bits.
+		table_reciprocal(1, 4, 8) => [256, 128, 85, 64]
+	"""
+	if first <= 0:
+		raise CodegenException("reciprocal table must start above zero.")
+	return [c_round((1 << bits) / d) for d in range(first, first + count)]
+
+SCALER_SLOPE_BITS = 16
+def scaler_segments(points):
+	"""Piecewise linear scaler through a list of (x, y) points with x ascending, for utilsScale(). Each segment is (x0, y0, slope), slope is
+		dy/dx scaled by 2^SCALER_SLOPE_BITS. The last point is a segment with zero slope, so the output is held at the last y for larger x.
+		A check is made that the product of dx & slope fits in an int32_t.
+		scaler_segments([(0, 0), (10, 100)]) => [(0, 0, 655360), (10, 100, 0)]
+	"""
+	if len(points) < 2:
+		raise CodegenException("scaler needs at least 2 points.")
+	segs = []
+	for (x0, y0), (x1, y1) in zip(points, points[1:]):
+		if x1 <= x0:
+			raise CodegenException(f"scaler points must have x ascending, {x1} follows {x0}.")
+		slope = c_round((y1 - y0) * (1 << SCALER_SLOPE_BITS) / (x1 - x0))
+		check_c_type('int32_t', (x1 - x0) * slope + (1 << (SCALER_SLOPE_BITS - 1)))
+		segs.append((x0, y0, slope))
+	segs.append((points[-1][0], points[-1][1], 0))
+	return segs
+
+def scaler_eval(segs, x):
+	"Evaluate a piecewise linear scaler as utilsScale() does, the output is held at the first y for smaller x."
+	if x < segs[0][0]:
+		return segs[0][1]
+	x0, y0, slope = [s for s in segs if s[0] <= x][-1]
+	return y0 + (((x - x0) * slope + (1 << (SCALER_SLOPE_BITS - 1))) >> SCALER_SLOPE_BITS)
+
+def scaler_max_error(segs, points):
+	"Return the maximum error of the scaler from exact interpolation between the points, rounded to an integer, over all integer x in range."
+	err = 0
+	for (x0, y0), (x1, y1) in zip(points, points[1:]):
+		for x in range(x0, x1 + 1):
+			err = max(err, abs(scaler_eval(segs, x) - c_round(y0 + (y1 - y0) * (x - x0) / (x1 - x0))))
+	return err
+
 class RegionParser:
 	"""Parse a file line by line into parts separated by tags. Inspired by an old Python templating system.
 	Allows a source file to be processed and rewritten. E.g a "C" source file:
@@ -297,6 +381,39 @@ foo     // bar''')
 			self.assertEqual(ident_camel('foo BAR'), 'fooBar')
 			self.assertEqual(ident_camel('foo BAR', True), 'FooBar')
 
+	class TestTables(unittest.TestCase):
+		def test_c_round(self):
+			self.assertEqual([c_round(x) for x in (0.5, 1.5, 2.5, -0.5, -1.5, 0.49)], [1, 2, 3, -1, -2, 0])
+		def test_check_c_type(self):
+			check_c_type('uint8_t', 255)
+			check_c_type('int16_t', -32768)
+			self.assertRaises(CodegenException, check_c_type, 'uint8_t', 256)
+			self.assertRaises(CodegenException, check_c_type, 'uint16_t', -1)
+		def test_gamma(self):
+			self.assertEqual(table_gamma(5, 2.0, 16), [0, 1, 4, 9, 16])
+			self.assertEqual(table_gamma(3, 1.0, 100), [0, 50, 100])
+		def test_reciprocal(self):
+			self.assertEqual(table_reciprocal(1, 4, 8), [256, 128, 85, 64])
+			self.assertRaises(CodegenException, table_reciprocal, 0, 4, 8)
+		def test_scaler(self):
+			self.assertEqual(scaler_segments([(0, 0), (10, 100)]), [(0, 0, 655360), (10, 100, 0)])
+			pts = [(0, 1000), (100, 0), (300, 500)]
+			segs = scaler_segments(pts)
+			self.assertEqual([scaler_eval(segs, x) for x in (0, 50, 100, 200, 300, 1000)], [1000, 500, 0, 250, 500, 500])
+			self.assertEqual(scaler_eval(scaler_segments([(10, 5), (20, 15)]), 0), 5)
+			self.assertEqual(scaler_max_error(segs, pts), 0)
+			self.assertRaises(CodegenException, scaler_segments, [(0, 0)])
+			self.assertRaises(CodegenException, scaler_segments, [(0, 0), (0, 1)])
+			self.assertRaises(CodegenException, scaler_segments, [(0, 0), (65535, 65535)])	# Overflows int32_t.
+		def test_add_progmem_table(self):
+			cg = Codegen('in', 'out')
+			cg.add_progmem_table('FOO', 'uint8_t', [1, 2, 3], per_line=2)
+			self.assertEqual(cg.contents, ['static const uint8_t FOO[] PROGMEM = {', '\t1, 2,', '\t3,', '};'])
+			cg = Codegen('in', 'out')
+			cg.add_progmem_table('BAR', 'Seg', [(1, 2), (3, 4)])
+			self.assertEqual(cg.contents, ['static const Seg BAR[] PROGMEM = {', '\t{ 1, 2 }, { 3, 4 },', '};'])
+			self.assertRaises(CodegenException, cg.add_progmem_table, 'BAZ', 'int8_t', [128])
+
 	class TestRegionParser(unittest.TestCase):
 		S = (
 			['leader 1', 'leader 3'],
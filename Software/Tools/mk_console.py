@@ -1,60 +1,186 @@
 #!/usr/bin/python3
+
+"""Process a console command definition file and either print a markdown table of commands, or generate a "C" header with a handler
+	function for each command, and a minimal perfect hash table in PROGMEM to look them up.
+
+	The table is searched by consoleCmdsLookup() in console.cpp. The hash of the command name is console_hash(), the table uses a displacement
+	table indexed by the hash modulo the displacement table size. The displacement is XORed with the hash, multiplied by a constant and the
+	result modulo the number of commands is the index into the command table. The hash value stored in the command table verifies the match.
+"""
+
 import re
 import sys
+import argparse
+import codegen
 
 def error(msg):
 	sys.exit('Error: ' + msg)
 
-llns = []
-for ln in open(sys.argv[1], 'rt'):
-	ln = ln.rstrip()			# Remove TRAILING spaces.
-	if not ln: continue			# Ignore empty lines.
-	ln = ln + '\n'
-	if ln[0].isspace():
-		llns[-1].append(ln.lstrip())
-	else:
-		llns.append([ln])
-
-RE_SECTION = re.compile(r'#\s*([^\s]*)\s*')
-RE_DEF = re.compile(r'''
-	([!-~]+)				# Command name.
-	\s+						# Some whitespace.
-	(?:\[(.*?)\]\s+)?		# Options in [], which may be left out if empty.
-	{{(.*?)}}				# "C" code in {{ ... }}.
-	\s+						# Some whitespace.
-	"(.*?)"					# Description in dquotes.
-#	(.*)
-#	$
-''', re.X|re.I|re.S)
-
-# Process logical lines...
-section = None
-defs = []
-for d in llns:
-	ln = ' '.join(d)
-	if m := RE_SECTION.match(ln):
-		section = m.group(1)
-	elif m := RE_DEF.match(ln):
-		defs.append([section] + [x.strip() if x else '' for x in m.groups()])
-	else:
-		error(f"Line `{ln}'")
-
-for b in 'SARGOOD RELAY SENSOR'.split() + ['']:
-	print('\nBuild:', b)
+BUILDS = 'SARGOOD RELAY SENSOR'.split()
+
+# These must match console.cpp & console.h.
+HASH_START, HASH_MULT = 5381, 33
+PHASH_MULT = 0x9e37
+DISP_MAX = 255
+
+def console_hash(cmd_s):
+	"Produce a 16 bit hash from a string, as console_hash() in console.cpp."
+	hash_c = HASH_START
+	for cmd_ch in cmd_s.upper():
+		hash_c = ((hash_c * HASH_MULT) & 0xffff) ^ ord(cmd_ch)
+	return hash_c
+
+def phash_slot(hash_c, disp, n_cmds):
+	"Index into the command table for a hash and a displacement, as consoleCmdsLookup() in console.cpp."
+	return (((hash_c ^ disp) * PHASH_MULT) & 0xffff) % n_cmds
+
+def mk_phash(hashes):
+	"""Return a list of displacements and a list of hash values in table order, making a minimal perfect hash for the list of hash values.
+		The smallest displacement table that works is used. An exception is raised if no table can be made. Hash values must be unique."""
+	n_cmds = len(hashes)
+	for n_disp in range(max(1, (n_cmds + 3) // 4), n_cmds + 1):
+		buckets = [[] for _ in range(n_disp)]
+		for hash_c in hashes:
+			buckets[hash_c % n_disp].append(hash_c)
+
+		disps = [0] * n_disp
+		slots = [None] * n_cmds
+		for b_idx in sorted(range(n_disp), key=lambda i: -len(buckets[i])):	# Do biggest buckets first.
+			for disp in range(DISP_MAX + 1):
+				try_slots = [phash_slot(h, disp, n_cmds) for h in buckets[b_idx]]
+				if len(set(try_slots)) == len(try_slots) and all(slots[s] is None for s in try_slots):
+					break
+			else:
+				break			# No displacement works for this bucket, try a bigger displacement table.
+			disps[b_idx] = disp
+			for hash_c, slot in zip(buckets[b_idx], try_slots):
+				slots[slot] = hash_c
+		else:
+			return disps, slots
+	raise ValueError(f"failed to make perfect hash for {n_cmds} commands.")
+
+def read_defs(infile):
+	"Read command definitions as a list of [section, name, options, code, description]."
+	llns = []
+	for ln in open(infile, 'rt', encoding="utf-8"):
+		ln = ln.rstrip()			# Remove TRAILING spaces.
+		if not ln: continue			# Ignore empty lines.
+		ln = ln + '\n'
+		if ln[0].isspace():				# Continuation lines keep their indent, so that "C" code is formatted nicely.
+			llns[-1].append(ln)
+		else:
+			llns.append([ln])
+
+	RE_SECTION = re.compile(r'#\s*([^\s]*)\s*')
+	RE_DEF = re.compile(r'''
+		([!-~]+)				# Command name.
+		\s+						# Some whitespace.
+		(?:\[(.*?)\]\s+)?		# Options in [], which may be left out if empty.
+		{{(.*?)}}				# "C" code in {{ ... }}.
+		\s+						# Some whitespace.
+		"(.*?)"					# Description in dquotes.
+	''', re.X|re.I|re.S)
+
+	# Process logical lines...
+	section = None
+	defs = []
+	for d in llns:
+		ln = ''.join(d)
+		if m := RE_SECTION.match(ln):
+			section = m.group(1)
+		elif m := RE_DEF.match(ln):
+			defs.append([section] + [x.strip() if x else '' for x in m.groups()])
+		else:
+			error(f"Line `{ln}'")
+
 	for d in defs:
-		if d[2] == b:
-			cmd = d[1]
-			desc = re.sub(r'\s+', ' ', d[4])
-			print(f'| {cmd} | {desc} |')
+		for opt in d[2].split():
+			if opt not in BUILDS:
+				error(f"command `{d[1]}' has unknown build `{opt}'.")
+	return defs
 
-"""
-static bool console_cmds_user(char* cmd) {
-	static int32_t f_acc;
-  switch (console_hash(cmd)) {
+def is_in_build(d, build):
+	"Options are a list of builds, empty for all."
+	return not d[2] or build in d[2].split()
 
+def build_cond(builds):
+	return ' || '.join(f'(CFG_DRIVER_BUILD == CFG_DRIVER_BUILD_{b})' for b in builds)
 
-    default: return false;
-  }
-  return true;
-}
-"""
+def write_markdown(defs):
+	for b in BUILDS + ['']:
+		print('\nBuild:', b)
+		for d in defs:
+			if (d[2].split() == [b]) if b else not d[2]:
+				cmd = d[1]
+				desc = re.sub(r'\s+', ' ', d[4])
+				print(f'| {cmd} | {desc} |')
+
+def write_table(defs, infile, outfile, func_name, builds):
+	"Write the header with command handlers and a perfect hash table for each build."
+	# Check for collisions in each build, since a collision would make the command unreachable.
+	for b in builds or [None]:
+		seen = {}
+		for d in defs:
+			if b is None or is_in_build(d, b):
+				hash_c = console_hash(d[1])
+				if hash_c in seen:
+					error(f"build {b}: commands `{seen[hash_c]}' & `{d[1]}' have the same hash 0x{hash_c:04x}.")
+				seen[hash_c] = d[1]
+
+	cg = codegen.Codegen(infile, outfile)
+	cg.begin()
+	cg.add_include_guard()
+	cg.add_autogen_comment()
+
+	# Command handlers, guarded if they are only used in some builds.
+	section = None
+	for idx, d in enumerate(defs):
+		if d[0] != section:
+			section = d[0]
+			cg.add_comment(section, add_nl=-1)
+		if d[2] and builds:
+			cg.add(f'#if {build_cond(d[2].split())}')
+		cg.add(f'static void console_cmd_{idx}() {{\t\t// {d[1]}\n\t{d[3]}\n}}')
+		if d[2] and builds:
+			cg.add('#endif')
+
+	# Tables, if no builds then a single table is written with all commands.
+	for b in builds or [None]:
+		cmds = {console_hash(d[1]): (idx, d[1]) for idx, d in enumerate(defs) if b is None or is_in_build(d, b)}
+		if b is not None:
+			cg.add(f'#if {build_cond([b])}', add_nl=-1)
+		else:
+			cg.add_nl()
+		if not cmds:
+			cg.add(f'static bool {func_name}(char* cmd) {{ (void)cmd; return false; }}')
+		else:
+			try:
+				disps, slots = mk_phash(list(cmds.keys()))
+			except ValueError as exc:
+				error(f"build {b}: {exc}")
+			cg.add(f'static const uint8_t CONSOLE_CMDS_DISP[{len(disps)}] PROGMEM = {{')
+			cg.add('\t' + ', '.join(str(x) for x in disps))
+			cg.add('};')
+			cg.add(f'static const console_cmd_def_t CONSOLE_CMDS_DEFS[{len(slots)}] PROGMEM = {{')
+			for hash_c in slots:
+				cg.add(codegen.format_code_with_comments(f'\t{{ 0x{hash_c:04x}, console_cmd_{cmds[hash_c][0]} }},', cmds[hash_c][1]))
+			cg.add('};')
+			cg.add(f'static bool {func_name}(char* cmd) {{')
+			cg.add(f'\treturn consoleCmdsLookup(cmd, CONSOLE_CMDS_DISP, {len(disps)}, CONSOLE_CMDS_DEFS, {len(slots)});')
+			cg.add('}')
+		if b is not None:
+			cg.add('#endif')
+	cg.end()
+
+parser = argparse.ArgumentParser(description = 'Process console command definitions to a markdown table or a "C" header with a perfect hash lookup.')
+parser.add_argument('infile', help='input file')
+parser.add_argument('--output', '-o', help='write "C" header to file, else markdown table is printed')
+parser.add_argument('--name', '-n', help='name of recogniser function in header', default='console_cmds_user')
+parser.add_argument('--no-builds', help='ignore build options and write a single table with all commands', action='store_true', dest='no_builds')
+args = parser.parse_args()
+
+cmd_defs = read_defs(args.infile)
+if args.output:
+	write_table(cmd_defs, args.infile, args.output, args.name, [] if args.no_builds else BUILDS)
+else:
+	write_markdown(cmd_defs)
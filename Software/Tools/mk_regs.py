@@ -32,10 +32,11 @@ parts = cg.begin(parser.read)
 """ Parse definitions:
 FLAGS [hex] "Various flags."
 	DC_IN_VOLTS_LOW [0] "External DC power volts low,"
+TILT_SENSOR_# [count=4 fmt=signed] "Tilt angle Sensor #."
 """
 reReg = re.compile(r'''
 	(-\s*)?					# Leading `-' with optional trailing whitespace to indicate fields within a register.
-	([a-z_][a-z_0-9]+)		# Name for register or field, same rules as for C identifier.
+	([a-z_][a-z_0-9#]+)		# Name for register or field, same rules as for C identifier, a `#' is replaced by the index in a block.
 	\s+						# Some whitespace.
 	(?:\[([^\]]*)\]\s+)?	# Options in [], which may be left out if empty.
 	"([^"]*)"				# Description in dquotes.
@@ -61,9 +62,40 @@ for lineno, ln in enumerate(parts[RegionParser.S_DEFS], len(parts[RegionParser.S
 	else:
 		llines.append([lineno, [ln]])
 
-# Process logical lines...
+# Expand blocks. A register or field with a `count' option and a `#' in the name is repeated count times, with the `#' replaced by the index in the
+#  name & description. Fields in a block take consecutive bits starting from the `bit' option.
+blocks = {}		# Register blocks, name less the `#': count.
+xlines = []
 for lineno, lns in llines:
 	ln = ' '.join(lns)
+	m = reReg.match(ln)
+	if not m: error(f"Line {ln}", lineno)
+	r_field, r_name, r_options, r_desc = m.groups()
+	opts = r_options.split() if r_options else []
+	count_opts = [opt for opt in opts if opt.startswith('count=')]
+	if not count_opts:
+		if '#' in r_name: error(f"{r_name}: `#' in name without a count option.", lineno)
+		xlines.append((lineno, ln))
+		continue
+	if '#' not in r_name: error(f"{r_name}: count option without a `#' in name.", lineno)
+	try: count = int(count_opts[0].split('=', 1)[1], 0)
+	except ValueError: count = 0
+	if count not in range(1, 17): error(f"{r_name}: bad count option `{count_opts[0]}'.", lineno)
+	opts.remove(count_opts[0])
+	if not r_field:
+		blocks[re.sub(r'_?#', '', r_name.upper())] = count
+	for block_idx in range(count):
+		x_opts = []
+		for opt in opts:
+			if opt.startswith('bit='):
+				try: opt = f"bit={int(opt.split('=', 1)[1]) + block_idx}"
+				except ValueError: error(f"{r_name}: field in block must have a single bit `{opt}'.", lineno)
+			x_opts.append(opt)
+		x_options = f" [{' '.join(x_opts)}]" if x_opts else ''
+		xlines.append((lineno, f"{r_field or ''}{r_name.replace('#', str(block_idx))}{x_options} \"{r_desc.replace('#', str(block_idx))}\""))
+
+# Process logical lines...
+for lineno, ln in xlines:
 	m = reReg.match(ln)
 	if not m: error(f"Line {ln}", lineno)
 	r_field, r_name, r_options, r_desc = m.groups()
@@ -151,6 +183,15 @@ cg.add(f'COUNT_REGS = {len(registers)}')
 cg.dedent()
 cg.add('};')
 
+if blocks:
+	cg.add_comment('Declare the number of registers in each block, they follow on from the register with index 0.', add_nl=-1)
+	cg.add('enum {')
+	cg.indent()
+	for block_name, count in blocks.items():
+		cg.add(f'REGS_BLOCK_COUNT_{block_name} = {count},')
+	cg.dedent()
+	cg.add('};')
+
 cg.add_comment('Define the start of the NV regs. The region is from this index up to the end of the register array.', add_nl=-1)
 nv_segment_start_idx = 'COUNT_REGS' if reg_first_nv == len(registers) else ('REGS_IDX_' + list(registers)[reg_first_nv])
 cg.add(f'#define REGS_START_NV_IDX {nv_segment_start_idx}')
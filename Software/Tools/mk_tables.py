@@ -0,0 +1,146 @@
+#! /usr/bin/python3
+
+"""Process a C header file that contains a block like this:
+	// .... [[[ ...
+	# Comment ignored
+	gamma LED_GAMMA size=64 gamma=2.0 max=255
+	scaler SCALER_FOO points=0:0,1023:20151
+	// ... >>> ...
+	(contents replaced by generated code)
+	// ... ]]] ..
+
+	The code generated is a static const array in PROGMEM for each line, so that the target does not have to compute anything at runtime or have
+	any floating point. Table kinds and their options are:
+		gamma NAME size=N gamma=G max=M [type=uint8_t]
+			Gamma correction, entry i is max * (i/(size-1))^gamma.
+		reciprocal NAME first=F count=N bits=B [type=uint16_t]
+			Reciprocals of F .. F+N-1 scaled by 2^B, so that x/d can be done as (x * table[d-F]) >> B.
+		scaler NAME points=x:y,x:y,...
+			Piecewise linear scaler through the points for utilsScale(), an array of UtilsScalerSegment. The max error from exact interpolation
+			is written in a comment.
+"""
+
+import argparse
+import os
+import sys
+import codegen
+
+TEMPLATE_FILE = """\
+#ifndef {guard}
+#define {guard}
+
+/* [[[  Begin table definitions: format <kind> <NAME> <option>=<value> ...
+
+	# Project specific tables.
+	gamma SAMPLE_GAMMA size=32 gamma=2.2 max=255
+
+ >>> End table definitions, begin generated code. */
+
+THIS WILL BE REPLACED
+
+// ]]] End generated code.
+
+#endif //  {guard}
+"""
+
+parser = argparse.ArgumentParser(description = 'Process file with inline table definitions and update source code to match.')
+parser.add_argument('infile', help='input file', default='tables.h', nargs='?')
+parser.add_argument('--write-template', help='write example input file', action='store_true', dest='write_template')
+
+args = parser.parse_args()
+
+# If we want a template file...
+if args.write_template:
+	codegen.message(f"Writing template file {args.infile} ... ")
+	if os.path.isfile(args.infile):
+		codegen.error('file exists, aborting')
+	with open(args.infile, 'wt', encoding='utf-8') as f_template:
+		try:
+			f_template.write(TEMPLATE_FILE.format(guard=codegen.include_guard(args.infile)))
+		except EnvironmentError:
+			codegen.error("failed to write.")
+	codegen.message("done.\n")
+	sys.exit()
+
+def parse_points(s):
+	"Parse a list of points like `0:0,1023:20151'."
+	return [tuple(int(v, 0) for v in p.split(':')) for p in s.split(',')]
+
+# Each table kind has a dict of options with defaults, None for required options. The generator returns the C type, the values & a comment.
+def gen_gamma(opts):
+	return opts['type'], codegen.table_gamma(int(opts['size']), float(opts['gamma']), int(opts['max'])), \
+	  f"Gamma {opts['gamma']}, {opts['size']} steps to {opts['max']}."
+def gen_reciprocal(opts):
+	first, count, bits = (int(opts[x], 0) for x in ('first', 'count', 'bits'))
+	return opts['type'], codegen.table_reciprocal(first, count, bits), f"Reciprocals of {first}..{first+count-1} scaled by 2^{bits}."
+def gen_scaler(opts):
+	points = parse_points(opts['points'])
+	for x, y in points:
+		codegen.check_c_type('uint16_t', x)
+		codegen.check_c_type('uint16_t', y)
+	segs = codegen.scaler_segments(points)
+	return 'UtilsScalerSegment', segs, f"Scaler through {opts['points']}, max error {codegen.scaler_max_error(segs, points)}."
+
+KINDS = {
+	'gamma':		(gen_gamma, {'size': None, 'gamma': None, 'max': None, 'type': 'uint8_t'}),
+	'reciprocal':	(gen_reciprocal, {'first': None, 'count': None, 'bits': None, 'type': 'uint16_t'}),
+	'scaler':		(gen_scaler, {'points': None}),
+}
+
+# Tables live in a dict, insertion order gives order in the output.
+tables = {}
+def add_table(raw_def):
+	"Helper to add a table definition to the global list with a modicum of error checking."
+	tdef = raw_def.strip()
+	if not tdef or tdef.startswith('#'):
+		return
+	try:
+		kind, name, *raw_opts = tdef.split()
+	except ValueError:
+		codegen.error(f"bad table definition `{tdef}'.")
+	if kind not in KINDS:
+		codegen.error(f"table kind {kind} is not valid.")
+	if name in tables:
+		codegen.error(f"table {name} already exists.")
+	if not codegen.is_ident(name) or name != name.upper():
+		codegen.error(f"table name {name} is not valid.")
+	gen, opts = KINDS[kind]
+	opts = dict(opts)
+	for opt in raw_opts:
+		key, sep, val = opt.partition('=')
+		if not sep or key not in opts:
+			codegen.error(f"table {name}: option `{opt}' is not valid.")
+		opts[key] = val
+	missing = [k for k, v in opts.items() if v is None]
+	if missing:
+		codegen.error(f"table {name}: missing options {', '.join(missing)}.")
+	try:
+		tables[name] = gen(opts)
+	except (ValueError, codegen.CodegenException) as exc:
+		codegen.error(f"table {name}: {exc}")
+
+# Read and parse input file
+cg = codegen.Codegen(args.infile)
+rpa = codegen.RegionParser()
+text = cg.begin(rpa.read)
+
+# Add table definitions from source file.
+codegen.message("Loading tables from source...")
+for t_def in text[2]:
+	add_table(t_def)
+
+# Add parts of source file that we want to keep as is.
+for part in text[:4]:
+	cg.add(part)
+
+for name, (ctype, values, comment) in tables.items():
+	cg.add_comment(comment)
+	cg.add_progmem_table(name, ctype, values, per_line=4 if ctype == 'UtilsScalerSegment' else 16)
+	cg.add_nl()
+
+# Add rest of source file that we want to keep as is.
+for part in text[5:]:
+	cg.add(part)
+
+# Finalise output file.
+cg.end()
@@ -1,19 +1,145 @@
-import sys, time
-import serial
+#!/usr/bin/python3
 
-port = sys.argv[1]
-regs = sys.argv[2:]
+"""Read registers from a unit over the console serial port.
+	Default mode polls the given register indices with the `?v' console command 5 times a second and prints them.
+	With --binary the unit is set to stream binary register packets with the BMASK & BDUMP commands, and the packets are decoded and
+	written as CSV. Packets may also be decoded from a file captured earlier with --input. The packet format is documented in regs.h.
+"""
 
-s = serial.Serial(port, 38400, timeout=0.2)
-start = None
-then = time.time()
+import sys, time, re, csv, argparse
 
-while 1:
-	while (time.time() - then) < 0.2:
+SYNC = b'\xa5\x5a'
+
+def crc_modbus(data):
+	"MODBUS CRC as modbusCrc() in modbus.cpp."
+	crc = 0xffff
+	for b in data:
+		crc ^= b
+		for _ in range(8):
+			crc = (crc >> 1) ^ 0xa001 if crc & 1 else crc >> 1
+	return crc
+
+class StreamDecoder:
+	"""Decode register stream packets from data fed in arbitrary chunks. Text from the console interleaved with packets is skipped.
+		Counts of CRC errors and lost packets (from gaps in the sequence number) are kept."""
+	def __init__(self):
+		self.buf = b''
+		self.crc_errors = 0
+		self.lost = 0
+		self.last_seq = None
+
+	def feed(self, data):
+		"Add data and return a list of decoded packets as (seq, timestamp, {reg-idx: value})."
+		self.buf += data
+		packets = []
+		while True:
+			start = self.buf.find(SYNC)
+			if start < 0:
+				self.buf = self.buf[-1:]		# Keep last byte in case it is the first sync byte.
+				break
+			self.buf = self.buf[start:]
+			if len(self.buf) < 3:
+				break
+			n_len = self.buf[2]
+			if len(self.buf) < 3 + n_len + 2:
+				break
+			body = self.buf[2:3 + n_len]
+			crc = self.buf[3 + n_len] | (self.buf[4 + n_len] << 8)
+			if crc != crc_modbus(body):
+				self.crc_errors += 1
+				self.buf = self.buf[1:]			# Skip past false sync.
+				continue
+			self.buf = self.buf[3 + n_len + 2:]
+			packets.append(self.decode(body[1:]))
+		return packets
+
+	def decode(self, body):
+		seq = body[0]
+		timestamp = int.from_bytes(body[1:5], 'little')
+		n_mask = body[5]
+		mask = body[6:6 + n_mask]
+		values = body[6 + n_mask:]
+		regs = {}
+		for idx in range(n_mask * 8):
+			if mask[idx // 8] & (1 << (idx % 8)):
+				v_idx = len(regs) * 2
+				regs[idx] = values[v_idx] | (values[v_idx + 1] << 8)
+		if self.last_seq is not None:
+			self.lost += (seq - self.last_seq - 1) & 0xff
+		self.last_seq = seq
+		return seq, timestamp, regs
+
+def read_reg_names(fn):
+	"Read register names from regs_local.h as a dict of index: name."
+	names = {}
+	with open(fn, 'rt', encoding='utf-8') as f:
+		for m in re.finditer(r'REGS_IDX_(\w+)\s*=\s*(\d+)', f.read()):
+			names[int(m.group(2))] = m.group(1)
+	return names
+
+def do_binary(args):
+	names = read_reg_names(args.regs) if args.regs else {}
+	decoder = StreamDecoder()
+	fout = open(args.output, 'wt', newline='') if args.output else sys.stdout
+	writer = csv.writer(fout)
+	columns = None
+
+	if args.input:
+		src = open(args.input, 'rb')
+		read = lambda: src.read(4096)
+	else:
+		import serial
+		src = serial.Serial(args.port, args.baud, timeout=0.2)
+		cmd = ' '.join(f'${m:x} {i} BMASK' for i, m in enumerate(args.mask)) + f' {args.period} BDUMP\r'
+		src.write(cmd.encode('ascii'))
+		read = lambda: src.read(src.in_waiting or 1)
+
+	try:
+		while True:
+			data = read()
+			if args.input and not data:
+				break
+			for seq, timestamp, regs in decoder.feed(data):
+				if columns != list(regs.keys()):		# Write a new header if the mask changes.
+					columns = list(regs.keys())
+					writer.writerow(['timestamp', 'seq'] + [names.get(i, str(i)) for i in columns])
+				writer.writerow([timestamp, seq] + [regs[i] for i in columns])
+	except KeyboardInterrupt:
 		pass
+	finally:
+		if not args.input:
+			src.write(b'X\r')
+	print(f"CRC errors: {decoder.crc_errors}, lost packets: {decoder.lost}", file=sys.stderr)
+
+def do_poll(args):
+	import serial
+	s = serial.Serial(args.port, args.baud, timeout=0.2)
+	start = None
 	then = time.time()
-	if start is None: start = time.time()
-	s.write((' '.join([f"{x} ?v" for x in regs]) + '\r').encode('ascii'))
-	resp = s.readline().decode('ascii').split('->')[1].split()
-	print(f"{time.time()-start:.3f} {' '.join(resp)}")
-	
+
+	while 1:
+		while (time.time() - then) < 0.2:
+			pass
+		then = time.time()
+		if start is None: start = time.time()
+		s.write((' '.join([f"{x} ?v" for x in args.regs_idx]) + '\r').encode('ascii'))
+		resp = s.readline().decode('ascii').split('->')[1].split()
+		print(f"{time.time()-start:.3f} {' '.join(resp)}")
+
+parser = argparse.ArgumentParser(description='Read registers from a unit via the console.')
+parser.add_argument('port', help='serial port', nargs='?')
+parser.add_argument('regs_idx', help='register indices to poll in text mode', nargs='*', type=int)
+parser.add_argument('--baud', '-b', help='baud rate', type=int, default=38400)
+parser.add_argument('--binary', help='decode binary register stream to CSV', action='store_true')
+parser.add_argument('--input', '-i', help='decode binary stream from captured file rather than serial port')
+parser.add_argument('--output', '-o', help='CSV output file, default stdout')
+parser.add_argument('--regs', '-r', help='regs_local.h file for register names in CSV header')
+parser.add_argument('--period', '-p', help='binary stream period in ms', type=int, default=100)
+parser.add_argument('--mask', '-m', help='register mask as 16 bit words, word 0 first; default is all volatile registers',
+  type=lambda x: int(x, 0), nargs='*', default=[])
+args = parser.parse_args()
+
+if args.binary:
+	do_binary(args)
+else:
+	do_poll(args)